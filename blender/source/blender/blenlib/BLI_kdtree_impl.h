@@ -61,6 +61,7 @@ int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
                                          float range,
                                          bool use_index_order,
                                          int *doubles);
+void BLI_kdtree_nd_(calc_node_order)(const KDTree *tree, int *r_indices) ATTR_NONNULL(1, 2);
 
 int BLI_kdtree_nd_(deduplicate)(KDTree *tree);
 
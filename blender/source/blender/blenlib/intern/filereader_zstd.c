@@ -12,9 +12,27 @@
 #include "BLI_endian_switch.h"
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
 
 #include "MEM_guardedalloc.h"
 
+/* Number of frames that are decompressed in parallel when a frame is missing from the cache. */
+#define ZSTD_READAHEAD_FRAMES 8
+/* Maximum number of decompressed frames kept in memory. Reading blocks on demand seeks back and
+ * forth between nearby blocks, so a few frames before the current one are kept as well. */
+#define ZSTD_CACHED_FRAMES (ZSTD_READAHEAD_FRAMES * 2)
+/* Maximum size of the decompressed frames kept in memory. The frame size depends on the
+ * compression profile of the file, from 1 MB up to 16 MB, so the number of frames alone doesn't
+ * bound the memory. The readahead is limited to half of it, so that it doesn't evict all the
+ * recently used frames. A single frame larger than this is still cached on its own. */
+#define ZSTD_CACHE_MAX_SIZE (64 * 1024 * 1024)
+
+typedef struct ZstdCachedFrame {
+  int frame;
+  char *content;
+  uint64_t last_use;
+} ZstdCachedFrame;
+
 typedef struct {
   FileReader reader;
 
@@ -29,8 +47,13 @@ typedef struct {
     size_t *compressed_ofs;
     size_t *uncompressed_ofs;
 
-    char *cached_content;
-    int cached_frame;
+    ZstdCachedFrame cache[ZSTD_CACHED_FRAMES];
+    size_t cache_size;
+    uint64_t use_counter;
+
+    /* Decompression contexts of the frames decompressed in parallel, reused between reads. The
+     * first one is #ZstdReader.ctx, the others are created when the readahead needs them. */
+    ZSTD_DCtx *frame_ctx[ZSTD_READAHEAD_FRAMES];
   } seek;
 } ZstdReader;
 
@@ -126,7 +149,9 @@ static bool zstd_read_seek_table(ZstdReader *zstd)
     return false;
   }
 
-  zstd->seek.cached_frame = -1;
+  for (int i = 0; i < ZSTD_CACHED_FRAMES; i++) {
+    zstd->seek.cache[i].frame = -1;
+  }
 
   return true;
 }
@@ -154,41 +179,161 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+static ZstdCachedFrame *zstd_cache_lookup(ZstdReader *zstd, int frame)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
+  for (int i = 0; i < ZSTD_CACHED_FRAMES; i++) {
+    if (zstd->seek.cache[i].frame == frame) {
+      return &zstd->seek.cache[i];
+    }
+  }
+  return NULL;
+}
+
+static size_t zstd_frame_size(ZstdReader *zstd, int frame)
+{
+  return zstd->seek.uncompressed_ofs[frame + 1] - zstd->seek.uncompressed_ofs[frame];
+}
+
+/* Find the least recently used slot that holds a frame, NULL when the cache is empty. */
+static ZstdCachedFrame *zstd_cache_least_recently_used(ZstdReader *zstd)
+{
+  ZstdCachedFrame *slot = NULL;
+  for (int i = 0; i < ZSTD_CACHED_FRAMES; i++) {
+    ZstdCachedFrame *candidate = &zstd->seek.cache[i];
+    if (candidate->frame != -1 && (slot == NULL || candidate->last_use < slot->last_use)) {
+      slot = candidate;
+    }
+  }
+  return slot;
+}
+
+static void zstd_cache_evict(ZstdReader *zstd, ZstdCachedFrame *slot)
+{
+  zstd->seek.cache_size -= zstd_frame_size(zstd, slot->frame);
+  MEM_SAFE_FREE(slot->content);
+  slot->frame = -1;
+}
+
+/* Insert a decompressed frame, evicting the least recently used frames until it fits into
+ * #ZSTD_CACHE_MAX_SIZE and a slot is free. */
+static void zstd_cache_insert(ZstdReader *zstd, int frame, char *content)
+{
+  const size_t size = zstd_frame_size(zstd, frame);
+
+  while (zstd->seek.cache_size > 0 && zstd->seek.cache_size + size > ZSTD_CACHE_MAX_SIZE) {
+    zstd_cache_evict(zstd, zstd_cache_least_recently_used(zstd));
+  }
+
+  ZstdCachedFrame *slot = zstd_cache_lookup(zstd, -1);
+  if (slot == NULL) {
+    slot = zstd_cache_least_recently_used(zstd);
+    zstd_cache_evict(zstd, slot);
   }
 
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
+  slot->frame = frame;
+  slot->content = content;
+  slot->last_use = ++zstd->seek.use_counter;
+  zstd->seek.cache_size += size;
+}
+
+typedef struct ZstdDecompressData {
+  ZstdReader *zstd;
+  int first_frame;
+  const char *compressed_data;
+  char *uncompressed_data[ZSTD_READAHEAD_FRAMES];
+} ZstdDecompressData;
+
+static void zstd_decompress_frame_fn(void *__restrict userdata,
+                                     const int iter,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ZstdDecompressData *data = userdata;
+  ZstdReader *zstd = data->zstd;
+  const int frame = data->first_frame + iter;
 
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
-  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
-                             zstd->seek.uncompressed_ofs[frame];
+  size_t uncompressed_size = zstd_frame_size(zstd, frame);
+  const char *compressed_data = data->compressed_data + (zstd->seek.compressed_ofs[frame] -
+                                                         zstd->seek.compressed_ofs[data->first_frame]);
 
   char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
+  size_t res = ZSTD_decompressDCtx(zstd->seek.frame_ctx[iter],
+                                   uncompressed_data,
+                                   uncompressed_size,
+                                   compressed_data,
+                                   compressed_size);
+  if (ZSTD_isError(res) || res < uncompressed_size) {
+    MEM_freeN(uncompressed_data);
+    uncompressed_data = NULL;
+  }
+  data->uncompressed_data[iter] = uncompressed_data;
+}
+
+/* Ensure that the given frame is decompressed and cached.
+ *
+ * On a cache miss the frame and up to #ZSTD_READAHEAD_FRAMES - 1 frames following it are read
+ * at once and decompressed in parallel, since the file is mostly read sequentially. The readahead
+ * stops at half of #ZSTD_CACHE_MAX_SIZE. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  ZstdCachedFrame *cached = zstd_cache_lookup(zstd, frame);
+  if (cached) {
+    /* Cached frame matches, so just return it. */
+    cached->last_use = ++zstd->seek.use_counter;
+    return cached->content;
+  }
+
+  /* Decompress the following frames as well, but stop at the first one that is cached already. */
+  int frames_len = 1;
+  size_t readahead_size = zstd_frame_size(zstd, frame);
+  while (frames_len < ZSTD_READAHEAD_FRAMES && frame + frames_len < zstd->seek.frames_num &&
+         zstd_cache_lookup(zstd, frame + frames_len) == NULL) {
+    readahead_size += zstd_frame_size(zstd, frame + frames_len);
+    if (readahead_size > ZSTD_CACHE_MAX_SIZE / 2) {
+      break;
+    }
+    frames_len++;
+  }
+
+  for (int i = 1; i < frames_len; i++) {
+    if (zstd->seek.frame_ctx[i] == NULL) {
+      zstd->seek.frame_ctx[i] = ZSTD_createDCtx();
+    }
+  }
+
+  /* The frames are stored contiguously, so read them all in one go. */
+  size_t compressed_size = zstd->seek.compressed_ofs[frame + frames_len] -
+                           zstd->seek.compressed_ofs[frame];
   char *compressed_data = MEM_mallocN(compressed_size, __func__);
   if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
       zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size) {
     MEM_freeN(compressed_data);
-    MEM_freeN(uncompressed_data);
     return NULL;
   }
 
-  size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+  ZstdDecompressData data = {
+      .zstd = zstd,
+      .first_frame = frame,
+      .compressed_data = compressed_data,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  settings.use_threading = frames_len > 1;
+  BLI_task_parallel_range(0, frames_len, &data, zstd_decompress_frame_fn, &settings);
+
   MEM_freeN(compressed_data);
-  if (ZSTD_isError(res) || res < uncompressed_size) {
-    MEM_freeN(uncompressed_data);
-    return NULL;
+
+  /* Insert in reverse order, so the requested frame is the most recently used one. */
+  for (int i = frames_len - 1; i >= 0; i--) {
+    if (data.uncompressed_data[i] != NULL) {
+      zstd_cache_insert(zstd, frame + i, data.uncompressed_data[i]);
+    }
   }
 
-  zstd->seek.cached_frame = frame;
-  zstd->seek.cached_content = uncompressed_data;
-  return uncompressed_data;
+  /* NULL when the requested frame couldn't be decompressed. */
+  return data.uncompressed_data[0];
 }
 
 static ssize_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
@@ -281,9 +426,17 @@ static void zstd_close(FileReader *reader)
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
-    /* When an error has occurred this may be NULL, see: T99744. */
-    if (zstd->seek.cached_content) {
-      MEM_freeN(zstd->seek.cached_content);
+    for (int i = 0; i < ZSTD_CACHED_FRAMES; i++) {
+      /* When an error has occurred this may be NULL, see: T99744. */
+      if (zstd->seek.cache[i].content) {
+        MEM_freeN(zstd->seek.cache[i].content);
+      }
+    }
+    /* The first context is #ZstdReader.ctx. */
+    for (int i = 1; i < ZSTD_READAHEAD_FRAMES; i++) {
+      if (zstd->seek.frame_ctx[i]) {
+        ZSTD_freeDCtx(zstd->seek.frame_ctx[i]);
+      }
     }
   }
   else {
@@ -304,6 +457,7 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+    zstd->seek.frame_ctx[0] = zstd->ctx;
   }
   else {
     zstd->reader.read = zstd_read;
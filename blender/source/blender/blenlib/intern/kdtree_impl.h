@@ -921,6 +921,20 @@ int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
   return found;
 }
 
+/**
+ * Write the #KDTreeNode.index of every node of the balanced tree, in the order of the nodes.
+ * This is the order #BLI_kdtree_3d_calc_duplicates_fast visits the coordinates in when
+ * `use_index_order` is false, so it can be used to reproduce its results.
+ *
+ * \param r_indices: An array of int's the length of #KDTree.nodes_len.
+ */
+void BLI_kdtree_nd_(calc_node_order)(const KDTree *tree, int *r_indices)
+{
+  for (uint i = 0; i < tree->nodes_len; i++) {
+    r_indices[i] = tree->nodes[i].index;
+  }
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -18,7 +18,9 @@ typedef struct {
   const char *buf;
   /** Size in bytes. */
   size_t size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** When true, this chunk is identical to the one at the same position in the previous step.
+   * The memory of all chunks is reference counted and may be shared with any other chunk, see
+   * #BLO_memfile_chunk_add. */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -69,6 +71,15 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
+/**
+ * Find where to split large data into chunks, based on the content instead of fixed offsets.
+ * This way, inserting or removing some bytes only changes the chunks around the edit and the
+ * following ones can still be shared with the previous undo steps.
+ *
+ * \param chunk_size: The preferred chunk size, the result is between 1/4 and 2 times it.
+ * \return The size of the first chunk of \a buf.
+ */
+size_t BLO_memfile_chunk_split(const char *buf, size_t size, size_t chunk_size);
 
 /* exports */
 
@@ -81,6 +92,8 @@ extern void BLO_memfile_free(MemFile *memfile);
 /**
  * Result is that 'first' is being freed.
  * to keep list of memfiles consistent, 'first' is always first in list.
+ *
+ * \note Since chunk memory is reference counted, this is the same as freeing 'first'.
  */
 extern void BLO_memfile_merge(MemFile *first, MemFile *second);
 /**
@@ -37,9 +37,24 @@ typedef enum eBLO_WritePathRemap {
   BLO_WRITE_PATH_REMAP_ABSOLUTE = 3,
 } eBLO_WritePathRemap;
 
+/**
+ * Trade-off between saving speed and file size, only used with #G_FILE_COMPRESS.
+ * All profiles write independent seekable frames, so files stay readable by older versions.
+ */
+typedef enum eBLO_WriteCompressionProfile {
+  /** Balanced speed and size (default). */
+  BLO_WRITE_COMPRESSION_DEFAULT = 0,
+  /** Fastest saving, for frequent saves of large files. */
+  BLO_WRITE_COMPRESSION_FAST = 1,
+  /** Smallest files: bigger frames, long distance matching and a higher level, slow to save. */
+  BLO_WRITE_COMPRESSION_ARCHIVAL = 2,
+} eBLO_WriteCompressionProfile;
+
 /** Similar to #BlendFileReadParams. */
 struct BlendFileWriteParams {
   eBLO_WritePathRemap remap_mode;
+  /** Only used when the file is compressed. */
+  eBLO_WriteCompressionProfile compression_profile;
   /** Save `.blend1`, `.blend2`... etc. */
   uint use_save_versions : 1;
   /** On write, restore paths after editing them (see #BLO_WRITE_PATH_REMAP_RELATIVE). */
@@ -53,6 +53,7 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "PIL_time.h"
@@ -1861,72 +1862,103 @@ static void switch_endian_structs(const struct SDNA *filesdna, BHead *bhead)
   }
 }
 
-static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
+/**
+ * Reading a block is split in two steps: #read_struct_load reads the data from the file when it
+ * was not read yet, which can only be done from one thread at a time, and #read_struct_convert
+ * switches endianness and reconstructs the structs, which is thread-safe. This allows converting
+ * the blocks of one ID in parallel, see #read_data_into_datamap.
+ */
+typedef struct ReadStructTask {
+  BHead *bhead;
+  const char *blockname;
+  /** The block with its data loaded, NULL when there is nothing left to convert. */
+  BHead *bhead_full;
+  void *result;
+} ReadStructTask;
+
+static void read_struct_load(FileData *fd, ReadStructTask *task)
 {
-  void *temp = NULL;
+  BHead *bh = task->bhead;
 
-  if (bh->len) {
-#ifdef USE_BHEAD_READ_ON_DEMAND
-    BHead *bh_orig = bh;
-#endif
+  task->bhead_full = NULL;
+  task->result = NULL;
 
-    /* switch is based on file dna */
-    if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
-#ifdef USE_BHEAD_READ_ON_DEMAND
-      if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-        bh = blo_bhead_read_full(fd, bh);
-        if (UNLIKELY(bh == NULL)) {
-          fd->flags &= ~FD_FLAGS_FILE_OK;
-          return NULL;
-        }
-      }
-#endif
-      switch_endian_structs(fd->filesdna, bh);
-    }
+  if (bh->len == 0) {
+    return;
+  }
+
+  task->bhead_full = bh;
 
-    if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
-      if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
 #ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
-          }
-        }
-#endif
-        temp = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+  if (BHEADN_FROM_BHEAD(bh)->has_data) {
+    return;
+  }
+
+  /* switch is based on file dna */
+  const bool switch_endian = bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN);
+
+  if (switch_endian || fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    task->bhead_full = blo_bhead_read_full(fd, bh);
+    if (UNLIKELY(task->bhead_full == NULL)) {
+      fd->flags &= ~FD_FLAGS_FILE_OK;
+    }
+  }
+  else {
+    task->bhead_full = NULL;
+
+    if (fd->compflags[bh->SDNAnr] == SDNA_CMP_EQUAL) {
+      /* Instead of allocating the bhead, then copying it,
+       * read the data from the file directly into the memory. */
+      task->result = MEM_mallocN(bh->len, task->blockname);
+      if (UNLIKELY(!blo_bhead_read_data(fd, bh, task->result))) {
+        fd->flags &= ~FD_FLAGS_FILE_OK;
+        MEM_freeN(task->result);
+        task->result = NULL;
       }
-      else {
-        /* SDNA_CMP_EQUAL */
-        temp = MEM_mallocN(bh->len, blockname);
-#ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data) {
-          memcpy(temp, (bh + 1), bh->len);
-        }
-        else {
-          /* Instead of allocating the bhead, then copying it,
-           * read the data from the file directly into the memory. */
-          if (UNLIKELY(!blo_bhead_read_data(fd, bh, temp))) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            MEM_freeN(temp);
-            temp = NULL;
-          }
-        }
+    }
+  }
 #else
-        memcpy(temp, (bh + 1), bh->len);
+  UNUSED_VARS(fd);
 #endif
-      }
-    }
+}
+
+static void read_struct_convert(const FileData *fd, ReadStructTask *task)
+{
+  BHead *bh = task->bhead_full;
+
+  if (bh == NULL) {
+    return;
+  }
+
+  /* switch is based on file dna */
+  if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+    switch_endian_structs(fd->filesdna, bh);
+  }
+
+  if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    task->result = DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+  }
+  else if (fd->compflags[bh->SDNAnr] == SDNA_CMP_EQUAL) {
+    task->result = MEM_mallocN(bh->len, task->blockname);
+    memcpy(task->result, (bh + 1), bh->len);
+  }
 
 #ifdef USE_BHEAD_READ_ON_DEMAND
-    if (bh_orig != bh) {
-      MEM_freeN(BHEADN_FROM_BHEAD(bh));
-    }
-#endif
+  if (bh != task->bhead) {
+    MEM_freeN(BHEADN_FROM_BHEAD(bh));
   }
+#endif
+  task->bhead_full = NULL;
+}
+
+static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
+{
+  ReadStructTask task = {.bhead = bh, .blockname = blockname};
 
-  return temp;
+  read_struct_load(fd, &task);
+  read_struct_convert(fd, &task);
+
+  return task.result;
 }
 
 /* Like read_struct, but gets a pointer without allocating. Only works for
@@ -3053,9 +3085,64 @@ static bool direct_link_id(FileData *fd, Main *main, const int tag, ID *id, ID *
   return success;
 }
 
+/**
+ * The data of an ID is converted in parallel when it is at least this large,
+ * e.g. for dense meshes. Smaller IDs aren't worth the threading overhead.
+ */
+#define READ_DATA_PARALLEL_MIN_SIZE (1 << 20)
+
+/**
+ * Blocks that need conversion are loaded into a temporary copy, which is freed once the block is
+ * converted. Compared to converting every block right after loading it, the copies of all the
+ * loaded blocks are kept at once, so they are converted whenever their size reaches this limit.
+ * That bounds the extra peak memory of reading an ID. Blocks that don't need conversion are read
+ * directly into their final memory and don't count.
+ */
+#define READ_DATA_PENDING_MAX_SIZE (64 << 20)
+
+typedef struct ReadDataParallelData {
+  const FileData *fd;
+  ReadStructTask *tasks;
+} ReadDataParallelData;
+
+static void read_data_convert_fn(void *__restrict userdata,
+                                 const int iter,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadDataParallelData *data = userdata;
+  read_struct_convert(data->fd, &data->tasks[iter]);
+}
+
+/* Convert the loaded blocks in the [start, end) range of tasks. */
+static void read_data_convert(const FileData *fd,
+                              ReadStructTask *tasks,
+                              const int start,
+                              const int end,
+                              const size_t data_size)
+{
+  ReadDataParallelData data = {
+      .fd = fd,
+      .tasks = tasks,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = data_size >= READ_DATA_PARALLEL_MIN_SIZE;
+  BLI_task_parallel_range(start, end, &data, read_data_convert_fn, &settings);
+}
+
 /* Read all data associated with a datablock into datamap. */
 static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *allocname)
 {
+  ReadStructTask tasks_static[64];
+  ReadStructTask *tasks = tasks_static;
+  int tasks_len = 0;
+  int tasks_alloc = ARRAY_SIZE(tasks_static);
+  int tasks_converted_len = 0;
+  size_t data_size = 0;
+  size_t pending_size = 0;
+
+  /* Reading from the file is sequential, so load the blocks first. */
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == DATA) {
@@ -3075,14 +3162,49 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
     }
 #endif
 
-    void *data = read_struct(fd, bhead, allocname);
-    if (data) {
-      oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+    if (tasks_len == tasks_alloc) {
+      tasks_alloc *= 2;
+      if (tasks == tasks_static) {
+        tasks = MEM_malloc_arrayN(tasks_alloc, sizeof(*tasks), __func__);
+        memcpy(tasks, tasks_static, sizeof(tasks_static));
+      }
+      else {
+        tasks = MEM_reallocN(tasks, sizeof(*tasks) * tasks_alloc);
+      }
+    }
+
+    ReadStructTask *task = &tasks[tasks_len++];
+    task->bhead = bhead;
+    task->blockname = allocname;
+    read_struct_load(fd, task);
+    data_size += (size_t)bhead->len;
+    if (task->bhead_full && task->bhead_full != task->bhead) {
+      pending_size += (size_t)bhead->len;
+    }
+
+    if (pending_size >= READ_DATA_PENDING_MAX_SIZE) {
+      read_data_convert(fd, tasks, tasks_converted_len, tasks_len, data_size);
+      tasks_converted_len = tasks_len;
+      pending_size = 0;
     }
 
     bhead = blo_bhead_next(fd, bhead);
   }
 
+  /* Then convert them, which is independent for every block. */
+  read_data_convert(fd, tasks, tasks_converted_len, tasks_len, data_size);
+
+  /* Insert in file order, so the result doesn't depend on threading. */
+  for (int i = 0; i < tasks_len; i++) {
+    if (tasks[i].result) {
+      oldnewmap_insert(fd->datamap, tasks[i].bhead->old, tasks[i].result, 0);
+    }
+  }
+
+  if (tasks != tasks_static) {
+    MEM_freeN(tasks);
+  }
+
   return bhead;
 }
 
@@ -25,6 +25,9 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_math_base.h"
+#include "BLI_threads.h"
 
 #include "BLO_readfile.h"
 #include "BLO_undofile.h"
@@ -38,51 +41,133 @@
 
 /* **************** support for memory-write, for undo buffers *************** */
 
-void BLO_memfile_free(MemFile *memfile)
+/* -------------------------------------------------------------------- */
+/** \name Shared Chunk Buffers
+ *
+ * The memory of the chunks is reference counted, so a buffer can be used by any number of
+ * chunks, in the same memfile or in any other step of the undo history. All buffers alive are
+ * indexed by a hash of their content, so data that only moved (e.g. because an ID was written in
+ * a different order or some data before it grew) or that is still stored by an older step is not
+ * stored again.
+ * \{ */
+
+/** Key used to look for existing buffers, either a #MemFileBuffer or data about to be added. */
+typedef struct MemFileBufferKey {
+  const char *data;
+  size_t size;
+  uint hash;
+} MemFileBufferKey;
+
+typedef struct MemFileBuffer {
+  MemFileBufferKey key;
+  /** Number of chunks using this buffer. */
+  uint users;
+  /* Followed by the data. */
+} MemFileBuffer;
+
+#define MEMFILE_BUFFER_DATA(buffer) ((char *)((buffer) + 1))
+#define MEMFILE_BUFFER_FROM_DATA(data) (((MemFileBuffer *)(data)) - 1)
+
+/** Maps #MemFileBufferKey to #MemFileBuffer, for all buffers of all memfiles. */
+static GHash *memfile_buffers = NULL;
+static ThreadMutex memfile_buffers_lock = BLI_MUTEX_INITIALIZER;
+
+static uint memfile_buffer_key_hash(const void *key)
 {
-  MemFileChunk *chunk;
+  return ((const MemFileBufferKey *)key)->hash;
+}
 
-  while ((chunk = BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_freeN((void *)chunk->buf);
-    }
-    MEM_freeN(chunk);
-  }
-  memfile->size = 0;
+static bool memfile_buffer_key_cmp(const void *a, const void *b)
+{
+  const MemFileBufferKey *key_a = a;
+  const MemFileBufferKey *key_b = b;
+  return (key_a->hash != key_b->hash) || (key_a->size != key_b->size) ||
+         (memcmp(key_a->data, key_b->data, key_a->size) != 0);
 }
 
-void BLO_memfile_merge(MemFile *first, MemFile *second)
+/** Return the data of a buffer with the given content, sharing an existing one if possible.
+ * \param r_is_new: Set to true when the buffer didn't exist yet. */
+static const char *memfile_buffer_ensure(const char *data, size_t size, bool *r_is_new)
 {
-  /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
-   * by it (i.e. shared with some previous memory steps). */
-  GHash *buffer_to_second_memchunk = BLI_ghash_new(
-      BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, __func__);
-
-  /* First, detect all memchunks in second memfile that are not owned by it. */
-  for (MemFileChunk *sc = second->chunks.first; sc != NULL; sc = sc->next) {
-    if (sc->is_identical) {
-      BLI_ghash_insert(buffer_to_second_memchunk, (void *)sc->buf, sc);
-    }
+  MemFileBufferKey key = {
+      .data = data,
+      .size = size,
+      .hash = BLI_hash_mm2((const unsigned char *)data, size, 0),
+  };
+
+  BLI_mutex_lock(&memfile_buffers_lock);
+
+  if (memfile_buffers == NULL) {
+    memfile_buffers = BLI_ghash_new(memfile_buffer_key_hash, memfile_buffer_key_cmp, __func__);
   }
 
-  /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
-   * it is also used by the second memfile, transfer the ownership. */
-  for (MemFileChunk *fc = first->chunks.first; fc != NULL; fc = fc->next) {
-    if (!fc->is_identical) {
-      MemFileChunk *sc = BLI_ghash_lookup(buffer_to_second_memchunk, fc->buf);
-      if (sc != NULL) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc->is_identical = true;
-      }
-      /* Note that if the second memfile does not use that chunk, we assume that the first one
-       * fully owns it without sharing it with any other memfile, and hence it should be freed with
-       * it. */
+  MemFileBuffer *buffer = NULL;
+  void **key_p, **val_p;
+  if (BLI_ghash_ensure_p_ex(memfile_buffers, &key, &key_p, &val_p)) {
+    buffer = *val_p;
+    buffer->users++;
+    *r_is_new = false;
+  }
+  else {
+    buffer = MEM_mallocN(sizeof(MemFileBuffer) + size, "Chunk buffer");
+    buffer->key = key;
+    buffer->key.data = MEMFILE_BUFFER_DATA(buffer);
+    buffer->users = 1;
+    memcpy(MEMFILE_BUFFER_DATA(buffer), data, size);
+
+    *key_p = &buffer->key;
+    *val_p = buffer;
+    *r_is_new = true;
+  }
+
+  BLI_mutex_unlock(&memfile_buffers_lock);
+
+  return MEMFILE_BUFFER_DATA(buffer);
+}
+
+static void memfile_buffer_user_add(const char *data)
+{
+  BLI_mutex_lock(&memfile_buffers_lock);
+  MEMFILE_BUFFER_FROM_DATA(data)->users++;
+  BLI_mutex_unlock(&memfile_buffers_lock);
+}
+
+static void memfile_buffer_user_remove(const char *data)
+{
+  MemFileBuffer *buffer = MEMFILE_BUFFER_FROM_DATA(data);
+
+  BLI_mutex_lock(&memfile_buffers_lock);
+
+  BLI_assert(buffer->users > 0);
+  if (--buffer->users == 0) {
+    BLI_ghash_remove(memfile_buffers, &buffer->key, NULL, NULL);
+    MEM_freeN(buffer);
+
+    if (BLI_ghash_len(memfile_buffers) == 0) {
+      BLI_ghash_free(memfile_buffers, NULL, NULL);
+      memfile_buffers = NULL;
     }
   }
 
-  BLI_ghash_free(buffer_to_second_memchunk, NULL, NULL);
+  BLI_mutex_unlock(&memfile_buffers_lock);
+}
 
+/** \} */
+
+void BLO_memfile_free(MemFile *memfile)
+{
+  MemFileChunk *chunk;
+
+  while ((chunk = BLI_pophead(&memfile->chunks))) {
+    memfile_buffer_user_remove(chunk->buf);
+    MEM_freeN(chunk);
+  }
+  memfile->size = 0;
+}
+
+void BLO_memfile_merge(MemFile *first, MemFile *UNUSED(second))
+{
+  /* The chunks of the second memfile keep their own references to the shared buffers. */
   BLO_memfile_free(first);
 }
 
@@ -158,20 +243,57 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
         curchunk->buf = compchunk->buf;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
+        memfile_buffer_user_add(curchunk->buf);
       }
     }
     *compchunk_step = compchunk->next;
   }
 
-  /* not equal... */
+  /* not equal to the chunk at the same position, but the same data may still be stored
+   * elsewhere in the undo history... */
   if (curchunk->buf == NULL) {
-    char *buf_new = MEM_mallocN(size, "Chunk buffer");
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+    bool is_new;
+    curchunk->buf = memfile_buffer_ensure(buf, size, &is_new);
+    if (is_new) {
+      memfile->size += size;
+    }
   }
 }
 
+/* Random values for the rolling hash of #BLO_memfile_chunk_split, one per byte value. */
+BLI_INLINE uint memfile_chunk_split_gear(const uchar value)
+{
+  uint hash = (uint)value * 0x9E3779B1u + 0x7F4A7C15u;
+  hash ^= hash >> 15;
+  hash *= 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+size_t BLO_memfile_chunk_split(const char *buf, size_t size, size_t chunk_size)
+{
+  const size_t min_size = chunk_size / 4;
+  const size_t max_size = MIN2(size, chunk_size * 2);
+
+  if (size <= min_size) {
+    return size;
+  }
+
+  /* A boundary is found when the lowest bits of the hash of the last 32 bytes are zero, which
+   * makes the average chunk size about `chunk_size / 2`. */
+  const uint mask = power_of_2_max_u((uint)min_size) - 1;
+  uint hash = 0;
+
+  for (size_t i = min_size; i < max_size; i++) {
+    hash = (hash << 1) + memfile_chunk_split_gear((uchar)buf[i]);
+    if ((hash & mask) == 0) {
+      return i + 1;
+    }
+  }
+
+  return max_size;
+}
+
 struct Main *BLO_memfile_main_get(struct MemFile *memfile,
                                   struct Main *bmain,
                                   struct Scene **r_scene)
@@ -132,8 +132,6 @@
 #define ZSTD_BUFFER_SIZE (1 << 21) /* 2mb */
 #define ZSTD_CHUNK_SIZE (1 << 20)  /* 1mb */
 
-#define ZSTD_COMPRESSION_LEVEL 3
-
 static CLG_LogRef LOG = {"blo.writefile"};
 
 /** Use if we want to store how many bytes have been written to the file. */
@@ -148,6 +146,28 @@ typedef enum {
   WW_WRAP_ZSTD,
 } eWriteWrapType;
 
+/**
+ * Compression settings of an #eBLO_WriteCompressionProfile.
+ *
+ * Every flush of the write buffer becomes an independent frame, which keeps the file seekable
+ * for the reader. Frames are between one and two times the chunk size, so a bigger chunk size
+ * lets zstd find more of the redundancy between blocks (e.g. repeated mesh arrays), at the cost
+ * of memory and coarser seeking when reading.
+ */
+typedef struct ZstdProfile {
+  int level;
+  size_t chunk_size;
+  bool use_long_distance_matching;
+  /** Zero to use the default of the level, otherwise large enough to cover the whole frame. */
+  int window_log;
+} ZstdProfile;
+
+static const ZstdProfile zstd_profiles[] = {
+    [BLO_WRITE_COMPRESSION_DEFAULT] = {3, ZSTD_CHUNK_SIZE, false, 0},
+    [BLO_WRITE_COMPRESSION_FAST] = {1, ZSTD_CHUNK_SIZE, false, 0},
+    [BLO_WRITE_COMPRESSION_ARCHIVAL] = {15, ZSTD_CHUNK_SIZE * 8, true, 24},
+};
+
 typedef struct ZstdFrame {
   struct ZstdFrame *next, *prev;
 
@@ -175,9 +195,13 @@ struct WriteWrap {
     int next_frame;
     int num_frames;
 
-    int level;
+    const ZstdProfile *profile;
     ListBase frames;
 
+    /** Compression contexts not used by any task, reused to avoid allocating them per frame. */
+    ZSTD_CCtx **free_contexts;
+    int free_contexts_len;
+
     bool write_error;
   } zstd;
 };
@@ -215,6 +239,39 @@ typedef struct {
   WriteWrap *ww;
 } ZstdWriteBlockTask;
 
+static ZSTD_CCtx *zstd_context_acquire(WriteWrap *ww)
+{
+  ZSTD_CCtx *ctx = NULL;
+
+  BLI_mutex_lock(&ww->zstd.mutex);
+  if (ww->zstd.free_contexts_len > 0) {
+    ctx = ww->zstd.free_contexts[--ww->zstd.free_contexts_len];
+  }
+  BLI_mutex_unlock(&ww->zstd.mutex);
+
+  if (ctx == NULL) {
+    const ZstdProfile *profile = ww->zstd.profile;
+    ctx = ZSTD_createCCtx();
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, profile->level);
+    if (profile->use_long_distance_matching) {
+      ZSTD_CCtx_setParameter(ctx, ZSTD_c_enableLongDistanceMatching, 1);
+    }
+    if (profile->window_log != 0) {
+      ZSTD_CCtx_setParameter(ctx, ZSTD_c_windowLog, profile->window_log);
+    }
+  }
+
+  return ctx;
+}
+
+static void zstd_context_release(WriteWrap *ww, ZSTD_CCtx *ctx)
+{
+  BLI_mutex_lock(&ww->zstd.mutex);
+  /* There are never more contexts than threads in the pool. */
+  ww->zstd.free_contexts[ww->zstd.free_contexts_len++] = ctx;
+  BLI_mutex_unlock(&ww->zstd.mutex);
+}
+
 static void *zstd_write_task(void *userdata)
 {
   ZstdWriteBlockTask *task = userdata;
@@ -222,8 +279,11 @@ static void *zstd_write_task(void *userdata)
 
   size_t out_buf_len = ZSTD_compressBound(task->size);
   void *out_buf = MEM_mallocN(out_buf_len, "Zstd out buffer");
-  size_t out_size = ZSTD_compress(
-      out_buf, out_buf_len, task->data, task->size, ZSTD_COMPRESSION_LEVEL);
+
+  /* Each frame is compressed on its own so it can be decompressed without the others. */
+  ZSTD_CCtx *ctx = zstd_context_acquire(ww);
+  size_t out_size = ZSTD_compress2(ctx, out_buf, out_buf_len, task->data, task->size);
+  zstd_context_release(ww, ctx);
 
   MEM_freeN(task->data);
 
@@ -266,6 +326,8 @@ static bool ww_open_zstd(WriteWrap *ww, const char *filepath)
   /* Leave one thread open for the main writing logic, unless we only have one HW thread. */
   int num_threads = max_ii(1, BLI_system_thread_count() - 1);
   BLI_threadpool_init(&ww->zstd.threadpool, zstd_write_task, num_threads);
+  ww->zstd.free_contexts = MEM_calloc_arrayN(
+      (size_t)num_threads, sizeof(*ww->zstd.free_contexts), __func__);
   BLI_mutex_init(&ww->zstd.mutex);
   BLI_condition_init(&ww->zstd.condition);
 
@@ -318,6 +380,11 @@ static bool ww_close_zstd(WriteWrap *ww)
   BLI_threadpool_end(&ww->zstd.threadpool);
   BLI_freelistN(&ww->zstd.tasks);
 
+  for (int i = 0; i < ww->zstd.free_contexts_len; i++) {
+    ZSTD_freeCCtx(ww->zstd.free_contexts[i]);
+  }
+  MEM_freeN(ww->zstd.free_contexts);
+
   BLI_mutex_end(&ww->zstd.mutex);
   BLI_condition_end(&ww->zstd.condition);
 
@@ -365,12 +432,16 @@ static size_t ww_write_zstd(WriteWrap *ww, const char *buf, size_t buf_len)
 
 /* --- end compression types --- */
 
-static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
+static void ww_handle_init(eWriteWrapType ww_type,
+                           eBLO_WriteCompressionProfile compression_profile,
+                           WriteWrap *r_ww)
 {
   memset(r_ww, 0, sizeof(*r_ww));
 
   switch (ww_type) {
     case WW_WRAP_ZSTD: {
+      BLI_assert(compression_profile < ARRAY_SIZE(zstd_profiles));
+      r_ww->zstd.profile = &zstd_profiles[compression_profile];
       r_ww->open = ww_open_zstd;
       r_ww->close = ww_close_zstd;
       r_ww->write = ww_write_zstd;
@@ -446,6 +517,10 @@ static WriteData *writedata_new(WriteWrap *ww)
       wd->buffer.max_size = MEM_BUFFER_SIZE;
       wd->buffer.chunk_size = MEM_CHUNK_SIZE;
     }
+    else if (ww->zstd.profile != NULL) {
+      wd->buffer.max_size = ww->zstd.profile->chunk_size * 2;
+      wd->buffer.chunk_size = ww->zstd.profile->chunk_size;
+    }
     else {
       wd->buffer.max_size = ZSTD_BUFFER_SIZE;
       wd->buffer.chunk_size = ZSTD_CHUNK_SIZE;
@@ -541,7 +616,11 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
       }
 
       do {
-        size_t writelen = MIN2(len, wd->buffer.chunk_size);
+        /* For undo, split on content so the chunks still match the previous steps after some
+         * data was inserted or removed, see #BLO_memfile_chunk_split. */
+        size_t writelen = wd->use_memfile ?
+                              BLO_memfile_chunk_split(adr, len, wd->buffer.chunk_size) :
+                              MIN2(len, wd->buffer.chunk_size);
         writedata_do_write(wd, adr, writelen);
         adr = (const char *)adr + writelen;
         len -= writelen;
@@ -1344,7 +1423,9 @@ bool BLO_write_file(Main *mainvar,
   /* open temporary file, so we preserve the original in case we crash */
   BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
 
-  ww_handle_init((write_flags & G_FILE_COMPRESS) ? WW_WRAP_ZSTD : WW_WRAP_NONE, &ww);
+  ww_handle_init((write_flags & G_FILE_COMPRESS) ? WW_WRAP_ZSTD : WW_WRAP_NONE,
+                 params->compression_profile,
+                 &ww);
 
   if (ww.open(&ww, tempname) == false) {
     BKE_reportf(
@@ -0,0 +1,174 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2026 Blender Foundation. */
+#include "blendfile_loading_base_test.h"
+#include "blendfile_synthetic_mesh.h"
+
+#include <cstring>
+#include <string>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+
+#include "BKE_appdir.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
+
+#include "BLO_readfile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_sdna_types.h"
+
+#if 0
+#  include <iostream>
+
+#  include "BLI_timeit.hh"
+#endif
+
+/* Writes a synthetic file with dense meshes and checks that reading it, with the parallel
+ * decompression and conversion, gives back the same data. */
+class BlendfileReadPerformanceTest : public BlendfileLoadingBaseTest {
+ protected:
+  int meshes_num_ = 4;
+  int verts_num_ = 64 * 1024;
+
+  std::string filepath_;
+
+  void write_synthetic_file(const bool use_compression)
+  {
+    char filepath[FILE_MAX];
+    BLI_path_join(filepath,
+                  sizeof(filepath),
+                  BKE_tempdir_session(),
+                  use_compression ? "read_performance_zstd.blend" : "read_performance.blend",
+                  nullptr);
+    filepath_ = filepath;
+
+    Main *bmain = BKE_main_new();
+    synthetic_meshes_add(bmain, meshes_num_, verts_num_);
+
+    BlendFileWriteParams params{};
+    params.remap_mode = BLO_WRITE_PATH_REMAP_NONE;
+
+    const int write_flags = use_compression ? G_FILE_COMPRESS : 0;
+    EXPECT_TRUE(BLO_write_file(bmain, filepath_.c_str(), write_flags, &params, nullptr));
+
+    BKE_main_free(bmain);
+  }
+
+  /**
+   * Swap the `flag` and `bweight` members of #MVert in the SDNA stored in the file, as if the file
+   * was written by a version with a different struct layout. Reading the file then has to
+   * reconstruct every vertex array instead of copying it, and the two members come out swapped.
+   */
+  void swap_vertex_members_in_file_sdna()
+  {
+    size_t size = 0;
+    char *data = static_cast<char *>(
+        BLI_file_read_binary_as_mem(filepath_.c_str(), 0, &size));
+    ASSERT_NE(data, nullptr);
+
+    /* Uncompressed little-endian file with 8 byte pointers: 12 bytes of file header, then
+     * blocks with a 24 bytes header: code, length, old pointer, SDNA index and count. */
+    ASSERT_EQ(memcmp(data, "BLENDER-v", 9), 0);
+
+    bool found = false;
+    for (size_t offset = 12; offset + 24 <= size;) {
+      int len;
+      memcpy(&len, data + offset + 4, sizeof(len));
+
+      if (memcmp(data + offset, "DNA1", 4) == 0) {
+        const char *error_message = nullptr;
+        /* Without #data_alloc the SDNA refers to the file data, so it can be modified in place. */
+        SDNA *sdna = DNA_sdna_from_data(data + offset + 24, len, false, false, &error_message);
+        ASSERT_NE(sdna, nullptr) << error_message;
+
+        SDNA_Struct *mvert = sdna->structs[DNA_struct_find_nr(sdna, "MVert")];
+        ASSERT_STREQ(sdna->names[mvert->members[1].name], "flag");
+        ASSERT_STREQ(sdna->names[mvert->members[2].name], "bweight");
+        std::swap(mvert->members[1].name, mvert->members[2].name);
+
+        DNA_sdna_free(sdna);
+        found = true;
+        break;
+      }
+      offset += 24 + size_t(len);
+    }
+    EXPECT_TRUE(found);
+
+    FILE *file = BLI_fopen(filepath_.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(fwrite(data, 1, size, file), size);
+    fclose(file);
+    MEM_freeN(data);
+  }
+
+  void read_synthetic_file(const bool members_swapped = false)
+  {
+    BlendFileReadReport bf_reports = {nullptr};
+    bfile = BLO_read_from_file(filepath_.c_str(), BLO_READ_SKIP_NONE, &bf_reports);
+    ASSERT_NE(bfile, nullptr);
+
+    int meshes_read = 0;
+    LISTBASE_FOREACH (Mesh *, mesh, &bfile->main->meshes) {
+      EXPECT_EQ(synthetic_mesh_mismatches(mesh, verts_num_, members_swapped), 0);
+      meshes_read++;
+    }
+    EXPECT_EQ(meshes_read, meshes_num_);
+
+    blendfile_free();
+    BLI_delete(filepath_.c_str(), false, false);
+  }
+};
+
+TEST_F(BlendfileReadPerformanceTest, Uncompressed)
+{
+  write_synthetic_file(false);
+  read_synthetic_file();
+}
+
+TEST_F(BlendfileReadPerformanceTest, Zstd)
+{
+  write_synthetic_file(true);
+  read_synthetic_file();
+}
+
+/* A file from a different version runs the parallel conversion of the ID data. */
+TEST_F(BlendfileReadPerformanceTest, Converted)
+{
+  write_synthetic_file(false);
+  swap_vertex_members_in_file_sdna();
+  read_synthetic_file(true);
+}
+
+#if 0
+/* Reports the time and the peak memory of reading 16 meshes of 256k vertices. */
+TEST_F(BlendfileReadPerformanceTest, Benchmark)
+{
+  meshes_num_ = 16;
+  verts_num_ = 256 * 1024;
+
+  for (const bool use_compression : {false, true}) {
+    write_synthetic_file(use_compression);
+
+    const char *name = use_compression ? "read zstd" : "read uncompressed";
+    BlendFileReadReport bf_reports = {nullptr};
+    MEM_reset_peak_memory();
+    const size_t memory_before = MEM_get_memory_in_use();
+    {
+      SCOPED_TIMER(name);
+      bfile = BLO_read_from_file(filepath_.c_str(), BLO_READ_SKIP_NONE, &bf_reports);
+    }
+    ASSERT_NE(bfile, nullptr);
+    std::cout << name << ": peak memory " << (MEM_get_peak_memory() - memory_before) / 1024 / 1024
+              << " MB\n";
+
+    blendfile_free();
+    BLI_delete(filepath_.c_str(), false, false);
+  }
+}
+#endif /* Benchmark */
@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2026 Blender Foundation. */
+#include "blendfile_synthetic_mesh.h"
+
+#include <utility>
+
+#include "BLI_hash.h"
+
+#include "BKE_customdata.h"
+#include "BKE_mesh.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+static void synthetic_vert(MVert &vert, const int group, const int verts_num, const int v)
+{
+  vert.co[0] = BLI_hash_int_01(uint(group * verts_num + v));
+  vert.co[1] = float(v / 1024);
+  vert.co[2] = float(group);
+  /* Keep the hide flag clear, it is moved to an attribute on reading. */
+  vert.flag = 1;
+  vert.bweight = char(v % 16);
+}
+
+void synthetic_meshes_add(Main *bmain,
+                          const int meshes_num,
+                          const int verts_num,
+                          const int copies_num)
+{
+  for (int i = 0; i < meshes_num; i++) {
+    Mesh *mesh = BKE_mesh_add(bmain, "Mesh");
+    CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, nullptr, verts_num);
+    mesh->totvert = verts_num;
+    BKE_mesh_update_customdata_pointers(mesh, false);
+
+    for (int v = 0; v < verts_num; v++) {
+      synthetic_vert(mesh->mvert[v], i / copies_num, verts_num, v);
+    }
+  }
+}
+
+int synthetic_mesh_mismatches(const Mesh *mesh, const int verts_num, const bool members_swapped)
+{
+  if (mesh->totvert != verts_num || mesh->mvert == nullptr) {
+    return verts_num;
+  }
+
+  /* Reading may order the meshes differently, the group is stored in the `z` coordinate. */
+  const int group = int(mesh->mvert[0].co[2]);
+
+  int mismatches = 0;
+  for (int v = 0; v < verts_num; v++) {
+    MVert expected;
+    synthetic_vert(expected, group, verts_num, v);
+    if (members_swapped) {
+      std::swap(expected.flag, expected.bweight);
+    }
+
+    const MVert &vert = mesh->mvert[v];
+    if (vert.co[0] != expected.co[0] || vert.co[1] != expected.co[1] ||
+        vert.co[2] != expected.co[2] || vert.flag != expected.flag ||
+        vert.bweight != expected.bweight) {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2026 Blender Foundation. */
+
+#pragma once
+
+struct Main;
+struct Mesh;
+
+/**
+ * Add meshes with dense vertex arrays, to test reading, writing and undo of large data.
+ *
+ * The `x` coordinates are noise, so that the vertices don't compress too well. Every group of
+ * \a copies_num consecutive meshes gets the same vertices, a redundancy that compression only
+ * finds when matching over long distances. The other meshes are all different.
+ */
+void synthetic_meshes_add(Main *bmain, int meshes_num, int verts_num, int copies_num = 1);
+
+/**
+ * Count the vertices of a mesh added by #synthetic_meshes_add that don't have the values they
+ * were created with. With \a members_swapped, the values of the `flag` and `bweight` members of
+ * #MVert are expected to be swapped.
+ */
+int synthetic_mesh_mismatches(const Mesh *mesh, int verts_num, bool members_swapped = false);
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2026 Blender Foundation. */
+#include "blendfile_loading_base_test.h"
+#include "blendfile_synthetic_mesh.h"
+
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+
+#include "BKE_appdir.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
+
+#include "BLO_readfile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+
+#if 0
+#  include <iostream>
+
+#  include "BLI_timeit.hh"
+#endif
+
+/* Saves a synthetic file with every compression profile and checks that it can be read back. */
+class BlendfileWritePerformanceTest : public BlendfileLoadingBaseTest {
+ protected:
+  int meshes_num_ = 4;
+  int verts_num_ = 64 * 1024;
+
+  Main *bmain_ = nullptr;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+
+    /* Pairs of meshes share the same vertices. */
+    bmain_ = BKE_main_new();
+    synthetic_meshes_add(bmain_, meshes_num_, verts_num_, 2);
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /** Write the file, check that it reads back the same meshes and return its size. */
+  size_t write_file(const int write_flags, const eBLO_WriteCompressionProfile compression_profile)
+  {
+    char filepath[FILE_MAX];
+    BLI_path_join(
+        filepath, sizeof(filepath), BKE_tempdir_session(), "write_performance.blend", nullptr);
+
+    BlendFileWriteParams params{};
+    params.remap_mode = BLO_WRITE_PATH_REMAP_NONE;
+    params.compression_profile = compression_profile;
+
+    EXPECT_TRUE(BLO_write_file(bmain_, filepath, write_flags, &params, nullptr));
+    const size_t file_size = BLI_file_size(filepath);
+
+    /* The frames must stay readable by the regular reader. */
+    BlendFileReadReport bf_reports = {nullptr};
+    bfile = BLO_read_from_file(filepath, BLO_READ_SKIP_NONE, &bf_reports);
+    EXPECT_NE(bfile, nullptr);
+    if (bfile) {
+      EXPECT_EQ(BLI_listbase_count(&bfile->main->meshes), meshes_num_);
+      LISTBASE_FOREACH (Mesh *, mesh, &bfile->main->meshes) {
+        EXPECT_EQ(synthetic_mesh_mismatches(mesh, verts_num_), 0);
+      }
+      blendfile_free();
+    }
+
+    BLI_delete(filepath, false, false);
+    return file_size;
+  }
+};
+
+TEST_F(BlendfileWritePerformanceTest, Profiles)
+{
+  const size_t uncompressed_size = write_file(0, BLO_WRITE_COMPRESSION_DEFAULT);
+  const size_t default_size = write_file(G_FILE_COMPRESS, BLO_WRITE_COMPRESSION_DEFAULT);
+  const size_t fast_size = write_file(G_FILE_COMPRESS, BLO_WRITE_COMPRESSION_FAST);
+  const size_t archival_size = write_file(G_FILE_COMPRESS, BLO_WRITE_COMPRESSION_ARCHIVAL);
+
+  EXPECT_LT(default_size, uncompressed_size);
+  EXPECT_LT(fast_size, uncompressed_size);
+  EXPECT_LE(archival_size, default_size);
+}
+
+#if 0
+/* Reports the time and the file size of every profile for 16 meshes of 256k vertices. */
+TEST_F(BlendfileWritePerformanceTest, Benchmark)
+{
+  BKE_main_free(bmain_);
+  meshes_num_ = 16;
+  verts_num_ = 256 * 1024;
+  bmain_ = BKE_main_new();
+  synthetic_meshes_add(bmain_, meshes_num_, verts_num_, 2);
+
+  const struct {
+    const char *name;
+    int write_flags;
+    eBLO_WriteCompressionProfile profile;
+  } profiles[] = {
+      {"uncompressed", 0, BLO_WRITE_COMPRESSION_DEFAULT},
+      {"zstd default", G_FILE_COMPRESS, BLO_WRITE_COMPRESSION_DEFAULT},
+      {"zstd fast", G_FILE_COMPRESS, BLO_WRITE_COMPRESSION_FAST},
+      {"zstd archival", G_FILE_COMPRESS, BLO_WRITE_COMPRESSION_ARCHIVAL},
+  };
+  for (const auto &profile : profiles) {
+    size_t size;
+    {
+      SCOPED_TIMER(profile.name);
+      size = write_file(profile.write_flags, profile.profile);
+    }
+    std::cout << profile.name << ": " << size << " bytes\n";
+  }
+}
+#endif /* Benchmark */
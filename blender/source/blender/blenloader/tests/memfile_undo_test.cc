@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later
+ * Copyright 2026 Blender Foundation. */
+#include "blendfile_loading_base_test.h"
+#include "blendfile_synthetic_mesh.h"
+
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#if 0
+#  include <iostream>
+
+#  include "BLI_timeit.hh"
+#endif
+
+/* Pushes memfile undo steps of dense meshes and checks how much memory every step adds. */
+class MemfileUndoTest : public BlendfileLoadingBaseTest {
+ protected:
+  int meshes_num_ = 4;
+  int verts_num_ = 64 * 1024;
+
+  Main *bmain_ = nullptr;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    bmain_ = BKE_main_new();
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+    BlendfileLoadingBaseTest::TearDown();
+  }
+
+  /* Inserts some vertices at the start of the mesh, which shifts all the following data. */
+  static void insert_verts(Mesh *mesh, const int verts_len)
+  {
+    MVert *verts = static_cast<MVert *>(
+        MEM_calloc_arrayN(mesh->totvert + verts_len, sizeof(MVert), __func__));
+    memcpy(verts + verts_len, mesh->mvert, sizeof(MVert) * mesh->totvert);
+
+    const int totvert = mesh->totvert + verts_len;
+    CustomData_free(&mesh->vdata, mesh->totvert);
+    CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_ASSIGN, verts, totvert);
+    mesh->totvert = totvert;
+    BKE_mesh_update_customdata_pointers(mesh, false);
+  }
+
+  void encode(MemFile *prev, MemFile *current)
+  {
+    BLO_write_file_mem(bmain_, prev, current, G_FILE_RECOVER_WRITE);
+  }
+};
+
+TEST_F(MemfileUndoTest, SharedChunks)
+{
+  synthetic_meshes_add(bmain_, meshes_num_, verts_num_);
+  const size_t mesh_size = sizeof(MVert) * verts_num_;
+
+  MemFile step1 = {{nullptr}};
+  encode(nullptr, &step1);
+  EXPECT_GE(step1.size, mesh_size * meshes_num_);
+
+  /* Nothing changed, all the mesh chunks are shared with the previous step. */
+  MemFile step2 = {{nullptr}};
+  encode(&step1, &step2);
+  EXPECT_LT(step2.size, mesh_size / 64);
+
+  /* Only the chunks around the inserted vertices are stored again. */
+  insert_verts(static_cast<Mesh *>(bmain_->meshes.first), 3);
+  MemFile step3 = {{nullptr}};
+  encode(&step2, &step3);
+  EXPECT_LT(step3.size, mesh_size / 4);
+
+  Main *bmain_undo = BLO_memfile_main_get(&step3, bmain_, nullptr);
+  ASSERT_NE(bmain_undo, nullptr);
+  EXPECT_EQ(static_cast<Mesh *>(bmain_undo->meshes.first)->totvert, verts_num_ + 3);
+  BKE_main_free(bmain_undo);
+
+  /* Freeing the steps in any order keeps the shared chunks of the remaining ones alive. */
+  BLO_memfile_merge(&step2, &step3);
+  BLO_memfile_free(&step1);
+  bmain_undo = BLO_memfile_main_get(&step3, bmain_, nullptr);
+  ASSERT_NE(bmain_undo, nullptr);
+  BKE_main_free(bmain_undo);
+  BLO_memfile_free(&step3);
+}
+
+/* Identical data anywhere in the history is shared, not only at the same position. */
+TEST_F(MemfileUndoTest, SharedContent)
+{
+  synthetic_meshes_add(bmain_, 2, verts_num_, 2);
+  const size_t mesh_size = sizeof(MVert) * verts_num_;
+
+  MemFile step1 = {{nullptr}};
+  encode(nullptr, &step1);
+  EXPECT_LT(step1.size, mesh_size + mesh_size / 4);
+
+  BLO_memfile_free(&step1);
+}
+
+#if 0
+/* Reports the encode and decode time of 8 meshes of 256k vertices and the memory per step. */
+TEST_F(MemfileUndoTest, Benchmark)
+{
+  meshes_num_ = 8;
+  verts_num_ = 256 * 1024;
+  synthetic_meshes_add(bmain_, meshes_num_, verts_num_);
+
+  MemFile step1 = {{nullptr}};
+  {
+    SCOPED_TIMER("encode initial");
+    encode(nullptr, &step1);
+  }
+  MemFile step2 = {{nullptr}};
+  {
+    SCOPED_TIMER("encode unchanged");
+    encode(&step1, &step2);
+  }
+  insert_verts(static_cast<Mesh *>(bmain_->meshes.first), 3);
+  MemFile step3 = {{nullptr}};
+  {
+    SCOPED_TIMER("encode shifted");
+    encode(&step2, &step3);
+  }
+  std::cout << "Memory per undo step: " << step1.size << ", " << step2.size << ", "
+            << step3.size << " bytes\n";
+  {
+    SCOPED_TIMER("decode");
+    Main *bmain_undo = BLO_memfile_main_get(&step3, bmain_, nullptr);
+    BKE_main_free(bmain_undo);
+  }
+
+  BLO_memfile_free(&step1);
+  BLO_memfile_free(&step2);
+  BLO_memfile_free(&step3);
+}
+#endif /* Benchmark */
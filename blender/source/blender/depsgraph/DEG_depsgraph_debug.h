@@ -42,6 +42,17 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+/**
+ * Obtain the time spent in the steps of the last relations build of the depsgraph, in seconds.
+ * \param[out] r_nodes:     Time spent building the nodes.
+ * \param[out] r_relations: Time spent building the relations.
+ * \param[out] r_finalize:  Time spent on cycle detection and other post-processing.
+ */
+void DEG_stats_build_time(const struct Depsgraph *graph,
+                          double *r_nodes,
+                          double *r_relations,
+                          double *r_finalize);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
@@ -11,8 +11,12 @@
 
 #include "DNA_anim_types.h"
 
+#include "BLI_array.hh"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "BKE_anim_data.h"
+
 #include "BKE_animsys.h"
 
 #include "RNA_path.h"
@@ -66,10 +70,15 @@ uint64_t AnimatedPropertyID::hash() const
 
 namespace {
 
+using NestedAnimatedProperties = Vector<pair<const ID *, AnimatedPropertyID>>;
+
 struct AnimatedPropertyCallbackData {
   PointerRNA pointer_rna;
   AnimatedPropertyStorage *animated_property_storage;
   DepsgraphBuilderCache *builder_cache;
+  /* When not null, properties of other IDs are collected here instead of being added to their
+   * storages right away, so that the cache is not modified from multiple threads. */
+  NestedAnimatedProperties *nested_properties;
 };
 
 void animated_property_cb(ID * /*id*/, FCurve *fcurve, void *data_v)
@@ -89,6 +98,11 @@ void animated_property_cb(ID * /*id*/, FCurve *fcurve, void *data_v)
    * This is needed to deal with cases when nested datablock is animated by its parent. */
   AnimatedPropertyStorage *animated_property_storage = data->animated_property_storage;
   if (pointer_rna.owner_id != data->pointer_rna.owner_id) {
+    if (data->nested_properties != nullptr) {
+      data->nested_properties->append(
+          {pointer_rna.owner_id, AnimatedPropertyID(&pointer_rna, property_rna)});
+      return;
+    }
     animated_property_storage = data->builder_cache->ensureAnimatedPropertyStorage(
         pointer_rna.owner_id);
   }
@@ -96,6 +110,35 @@ void animated_property_cb(ID * /*id*/, FCurve *fcurve, void *data_v)
   animated_property_storage->tagPropertyAsAnimated(&pointer_rna, property_rna);
 }
 
+void initialize_animated_property_storage(AnimatedPropertyStorage *animated_property_storage,
+                                         DepsgraphBuilderCache *builder_cache,
+                                         const ID *id,
+                                         NestedAnimatedProperties *nested_properties)
+{
+  AnimatedPropertyCallbackData data;
+  RNA_id_pointer_create(const_cast<ID *>(id), &data.pointer_rna);
+  data.animated_property_storage = animated_property_storage;
+  data.builder_cache = builder_cache;
+  data.nested_properties = nested_properties;
+  BKE_fcurves_id_cb(const_cast<ID *>(id), animated_property_cb, &data);
+}
+
+struct InitializeStoragesData {
+  DepsgraphBuilderCache *builder_cache;
+  Span<const ID *> ids;
+  Span<AnimatedPropertyStorage *> storages;
+  MutableSpan<NestedAnimatedProperties> nested_properties;
+};
+
+void initialize_storage_func(void *__restrict data_v,
+                             const int i,
+                             const TaskParallelTLS *__restrict /*tls*/)
+{
+  InitializeStoragesData *data = static_cast<InitializeStoragesData *>(data_v);
+  initialize_animated_property_storage(
+      data->storages[i], data->builder_cache, data->ids[i], &data->nested_properties[i]);
+}
+
 }  // namespace
 
 AnimatedPropertyStorage::AnimatedPropertyStorage() : is_fully_initialized(false)
@@ -104,11 +147,7 @@ AnimatedPropertyStorage::AnimatedPropertyStorage() : is_fully_initialized(false)
 
 void AnimatedPropertyStorage::initializeFromID(DepsgraphBuilderCache *builder_cache, const ID *id)
 {
-  AnimatedPropertyCallbackData data;
-  RNA_id_pointer_create(const_cast<ID *>(id), &data.pointer_rna);
-  data.animated_property_storage = this;
-  data.builder_cache = builder_cache;
-  BKE_fcurves_id_cb(const_cast<ID *>(id), animated_property_cb, &data);
+  initialize_animated_property_storage(this, builder_cache, id, nullptr);
 }
 
 void AnimatedPropertyStorage::tagPropertyAsAnimated(const AnimatedPropertyID &property_id)
@@ -166,4 +205,41 @@ AnimatedPropertyStorage *DepsgraphBuilderCache::ensureInitializedAnimatedPropert
   return animated_property_storage;
 }
 
+void DepsgraphBuilderCache::initializeAnimatedPropertyStorages(Span<const ID *> ids)
+{
+  /* Create all the storages first, the map is not modified from the worker threads. */
+  Vector<const ID *> animated_ids;
+  Vector<AnimatedPropertyStorage *> storages;
+  for (const ID *id : ids) {
+    AnimatedPropertyStorage *animated_property_storage = ensureAnimatedPropertyStorage(id);
+    if (animated_property_storage->is_fully_initialized) {
+      continue;
+    }
+    if (BKE_animdata_from_id(id) == nullptr) {
+      /* Nothing to resolve, the storage could only be filled by other IDs. */
+      animated_property_storage->is_fully_initialized = true;
+      continue;
+    }
+    animated_ids.append(id);
+    storages.append(animated_property_storage);
+  }
+
+  Array<NestedAnimatedProperties> nested_properties(animated_ids.size());
+  InitializeStoragesData data = {this, animated_ids, storages, nested_properties};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
+  BLI_task_parallel_range(0, animated_ids.size(), &data, initialize_storage_func, &settings);
+
+  /* Add the properties of nested IDs in the order of the input, so that the result does not
+   * depend on the scheduling. */
+  for (const int i : animated_ids.index_range()) {
+    storages[i]->is_fully_initialized = true;
+    for (const pair<const ID *, AnimatedPropertyID> &item : nested_properties[i]) {
+      ensureAnimatedPropertyStorage(item.first)->tagPropertyAsAnimated(item.second);
+    }
+  }
+}
+
 }  // namespace blender::deg
@@ -73,6 +73,11 @@ class DepsgraphBuilderCache {
   AnimatedPropertyStorage *ensureAnimatedPropertyStorage(const ID *id);
   AnimatedPropertyStorage *ensureInitializedAnimatedPropertyStorage(const ID *id);
 
+  /* Initializes the storages of all the given IDs at once, using multiple threads.
+   * The result is the same as calling ensureInitializedAnimatedPropertyStorage() for each of
+   * them. */
+  void initializeAnimatedPropertyStorages(Span<const ID *> ids);
+
   /* Shortcuts to go through ensureInitializedAnimatedPropertyStorage and its
    * isPropertyAnimated.
    *
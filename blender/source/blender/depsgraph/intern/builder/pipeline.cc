@@ -26,18 +26,27 @@ AbstractBuilderPipeline::AbstractBuilderPipeline(::Depsgraph *graph)
 
 void AbstractBuilderPipeline::build()
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    start_time = PIL_check_seconds_timer();
-  }
+  const double start_time = PIL_check_seconds_timer();
 
   build_step_sanity_check();
   build_step_nodes();
+  const double nodes_end_time = PIL_check_seconds_timer();
   build_step_relations();
+  const double relations_end_time = PIL_check_seconds_timer();
   build_step_finalize();
+  const double finalize_end_time = PIL_check_seconds_timer();
+
+  DepsgraphBuildStats &stats = deg_graph_->build_stats;
+  stats.nodes_time = nodes_end_time - start_time;
+  stats.relations_time = relations_end_time - nodes_end_time;
+  stats.finalize_time = finalize_end_time - relations_end_time;
 
   if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
+    printf("Depsgraph built in %f seconds (nodes %f, relations %f, finalize %f).\n",
+           stats.total_time(),
+           stats.nodes_time,
+           stats.relations_time,
+           stats.finalize_time);
   }
 }
 
@@ -89,6 +98,9 @@ void AbstractBuilderPipeline::build_step_finalize()
     abort();
   }
 #endif
+  /* The operations were re-created without any timing, estimate their cost after the first
+   * evaluation. */
+  deg_graph_->critical_path_update_countdown = 0;
   /* Relations are up to date. */
   deg_graph_->need_update_relations = false;
 }
@@ -3,6 +3,12 @@
 
 #include "pipeline_view_layer.h"
 
+#include "BLI_listbase.h"
+#include "BLI_vector_set.hh"
+
+#include "DNA_layer_types.h"
+#include "DNA_object_types.h"
+
 #include "intern/builder/deg_builder_nodes.h"
 #include "intern/builder/deg_builder_relations.h"
 #include "intern/depsgraph.h"
@@ -16,6 +22,18 @@ ViewLayerBuilderPipeline::ViewLayerBuilderPipeline(::Depsgraph *graph)
 
 void ViewLayerBuilderPipeline::build_nodes(DepsgraphNodeBuilder &node_builder)
 {
+  /* Both builders check the animated visibility of every base of the view layer, resolve those
+   * F-Curves in parallel instead of on the first lookup. Other pipelines only build a subset of
+   * the IDs, so this is not done for them. */
+  VectorSet<const ID *> ids;
+  LISTBASE_FOREACH (Base *, base, &view_layer_->object_bases) {
+    ids.add(&base->object->id);
+    if (base->object->type == OB_ARMATURE && base->object->data != nullptr) {
+      ids.add(static_cast<const ID *>(base->object->data));
+    }
+  }
+  builder_cache_.initializeAnimatedPropertyStorages(ids);
+
   node_builder.build_view_layer(scene_, view_layer_, DEG_ID_LINKED_DIRECTLY);
 }
 
@@ -58,6 +58,7 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       ctime(BKE_scene_ctime_get(scene)),
       scene_cow(nullptr),
       is_active(false),
+      critical_path_update_countdown(0),
       is_evaluating(false),
       is_render_pipeline_depsgraph(false),
       use_editors_update(false)
@@ -26,6 +26,7 @@
 
 #include "intern/debug/deg_debug.h"
 #include "intern/depsgraph_type.h"
+#include "intern/eval/deg_eval_stats.h"
 
 struct ID;
 struct Scene;
@@ -149,6 +150,13 @@ struct Depsgraph {
 
   DepsgraphDebug debug;
 
+  /* Filled in by the builder pipeline, every time relations are rebuilt. */
+  DepsgraphBuildStats build_stats;
+
+  /* Number of evaluations left until the critical path estimates of the operations are updated.
+   * Zero means that they are updated after the next evaluation. */
+  int critical_path_update_countdown;
+
   bool is_evaluating;
 
   /* Is set to truth for dependency graph which are used for post-processing (compositor and
@@ -223,6 +223,19 @@ void DEG_stats_simple(const Depsgraph *graph,
   }
 }
 
+void DEG_stats_build_time(const Depsgraph *graph,
+                          double *r_nodes,
+                          double *r_relations,
+                          double *r_finalize)
+{
+  const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(graph);
+  const deg::DepsgraphBuildStats &stats = deg_graph->build_stats;
+
+  *r_nodes = stats.nodes_time;
+  *r_relations = stats.relations_time;
+  *r_finalize = stats.finalize_time;
+}
+
 static deg::string depsgraph_name_for_logging(struct Depsgraph *depsgraph)
 {
   const char *name = DEG_debug_name_get(depsgraph);
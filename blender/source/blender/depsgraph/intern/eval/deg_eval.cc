@@ -15,6 +15,7 @@
 #include "BLI_gsqueue.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.h"
 
@@ -48,6 +49,9 @@ namespace blender::deg {
 
 namespace {
 
+/* Number of evaluations between updates of the critical path estimates. */
+const int CRITICAL_PATH_UPDATE_INTERVAL = 16;
+
 struct DepsgraphEvalState;
 
 void deg_task_run_func(TaskPool *pool, void *taskdata);
@@ -63,6 +67,36 @@ void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), Tas
   BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
 }
 
+/* Children of an evaluated operation which became ready for evaluation. */
+struct ReadyChildren {
+  TaskPool *pool;
+  /* Child with the longest critical path, evaluated next by the same thread. */
+  OperationNode *critical_node;
+};
+
+/* Keep the most expensive chain of operations on the current thread instead of letting it wait
+ * in the pool behind cheap operations, the other children are pushed to the pool. */
+void schedule_node_to_ready_children(OperationNode *node,
+                                     const int thread_id,
+                                     ReadyChildren *ready_children)
+{
+  if (ready_children->critical_node == nullptr) {
+    ready_children->critical_node = node;
+    return;
+  }
+  if (node->critical_path_time > ready_children->critical_node->critical_path_time) {
+    std::swap(node, ready_children->critical_node);
+  }
+  schedule_node_to_pool(node, thread_id, ready_children->pool);
+}
+
+void schedule_node_to_vector(OperationNode *node,
+                             const int /*thread_id*/,
+                             Vector<OperationNode *> *nodes)
+{
+  nodes->append(node);
+}
+
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
   /* Stage 1: Only  Copy-on-Write operations are to be evaluated, prior to anything else.
@@ -98,13 +132,20 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double time = PIL_check_seconds_timer() - start_time;
+
   if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    operation_node->stats.current_time += time;
+  }
+
+  /* Used to estimate the critical path, only this thread writes to it. */
+  if (operation_node->average_time == 0.0f) {
+    operation_node->average_time = float(time);
   }
   else {
-    operation_node->evaluate(depsgraph);
+    operation_node->average_time = operation_node->average_time * 0.75f + float(time) * 0.25f;
   }
 
   /* Clear the flag early on, allowing partial updates without re-evaluating the same node multiple
@@ -120,12 +161,16 @@ void deg_task_run_func(TaskPool *pool, void *taskdata)
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  while (operation_node != nullptr) {
+    /* Evaluate node. */
+    evaluate_node(state, operation_node);
 
-  /* Schedule children. */
-  schedule_children(state, operation_node, schedule_node_to_pool, pool);
+    /* Schedule children, continuing with the most expensive one. */
+    ReadyChildren ready_children = {pool, nullptr};
+    schedule_children(state, operation_node, schedule_node_to_ready_children, &ready_children);
+    operation_node = ready_children.critical_node;
+  }
 }
 
 bool check_operation_node_visible(const DepsgraphEvalState *state, OperationNode *op_node)
@@ -335,7 +380,17 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, schedule_node_to_pool, task_pool);
+  /* Push the operations starting the longest chains first, so they are picked up first. */
+  Vector<OperationNode *> ready_nodes;
+  schedule_graph(state, schedule_node_to_vector, &ready_nodes);
+  std::stable_sort(ready_nodes.begin(),
+                   ready_nodes.end(),
+                   [](const OperationNode *a, const OperationNode *b) {
+                     return a->critical_path_time > b->critical_path_time;
+                   });
+  for (OperationNode *node : ready_nodes) {
+    schedule_node_to_pool(node, 0, task_pool);
+  }
   BLI_task_pool_work_and_wait(task_pool);
 }
 
@@ -467,6 +522,12 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     deg_eval_stats_aggregate(graph);
   }
 
+  /* The estimates only change slowly, no need to update them on every evaluation. */
+  if (graph->critical_path_update_countdown-- <= 0) {
+    deg_eval_stats_update_critical_path(graph);
+    graph->critical_path_update_countdown = CRITICAL_PATH_UPDATE_INTERVAL;
+  }
+
   /* Clear any uncleared tags. */
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
@@ -8,8 +8,10 @@
 #include "intern/eval/deg_eval_stats.h"
 
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 
 #include "intern/node/deg_node.h"
 #include "intern/node/deg_node_component.h"
@@ -38,4 +40,52 @@ void deg_eval_stats_aggregate(Depsgraph *graph)
   }
 }
 
+namespace {
+
+bool is_critical_path_relation(const Relation *rel)
+{
+  return rel->from->type == NodeType::OPERATION && rel->to->type == NodeType::OPERATION &&
+         (rel->flag & RELATION_FLAG_CYCLIC) == 0;
+}
+
+}  // namespace
+
+void deg_eval_stats_update_critical_path(Depsgraph *graph)
+{
+  /* Visit the operations in reverse topological order, starting from the ones nothing depends
+   * on, so every operation is visited after all its children. The number of children left to
+   * visit is stored in num_links_pending, which is only used while evaluating. Operations in
+   * dependency cycles are never visited and keep the longest path of their visited children. */
+  Vector<OperationNode *> queue;
+  for (OperationNode *op_node : graph->operations) {
+    op_node->critical_path_time = 0.0f;
+    op_node->num_links_pending = 0;
+    for (Relation *rel : op_node->outlinks) {
+      if (is_critical_path_relation(rel)) {
+        op_node->num_links_pending++;
+      }
+    }
+    if (op_node->num_links_pending == 0) {
+      queue.append(op_node);
+    }
+  }
+
+  while (!queue.is_empty()) {
+    OperationNode *op_node = queue.pop_last();
+    /* So far the critical path time is the longest path of the children. */
+    op_node->critical_path_time += op_node->average_time;
+
+    for (Relation *rel : op_node->inlinks) {
+      if (!is_critical_path_relation(rel)) {
+        continue;
+      }
+      OperationNode *parent = static_cast<OperationNode *>(rel->from);
+      parent->critical_path_time = max(parent->critical_path_time, op_node->critical_path_time);
+      if (--parent->num_links_pending == 0) {
+        queue.append(parent);
+      }
+    }
+  }
+}
+
 }  // namespace blender::deg
@@ -11,7 +11,23 @@ namespace blender::deg {
 
 struct Depsgraph;
 
+/* Time spent in the steps of the last dependency graph build, in seconds. */
+struct DepsgraphBuildStats {
+  double nodes_time = 0.0;
+  double relations_time = 0.0;
+  double finalize_time = 0.0;
+
+  double total_time() const
+  {
+    return nodes_time + relations_time + finalize_time;
+  }
+};
+
 /* Aggregate operation timings to overall component and ID nodes timing. */
 void deg_eval_stats_aggregate(Depsgraph *graph);
 
+/* Update the critical path estimate of every operation from the average time of the operations
+ * depending on it. */
+void deg_eval_stats_update_critical_path(Depsgraph *graph);
+
 }  // namespace blender::deg
@@ -267,6 +267,13 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Moving average of the time spent evaluating this operation, in seconds. */
+  float average_time;
+  /* Estimated time of the longest chain of operations starting at this one, including itself.
+   * Operations on the longest chains are scheduled first, see deg_eval_stats_update_critical_path.
+   */
+  float critical_path_time;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
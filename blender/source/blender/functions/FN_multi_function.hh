@@ -128,6 +128,29 @@ class MultiFunction {
 
   ExecutionHints execution_hints() const;
 
+  /**
+   * True when the function also implements #call_contiguous. That is only possible for functions
+   * with single inputs and outputs, whose outputs at an index only depend on the inputs at the same
+   * index.
+   */
+  virtual bool supports_contiguous_call() const
+  {
+    return false;
+  }
+
+  /**
+   * Process the first \a size elements of contiguous arrays, without an index mask and virtual
+   * arrays. This allows #MFProcedureExecutor to fuse multiple functions into a loop over small
+   * chunks whose intermediate values stay in the cache.
+   *
+   * \param arrays: An array for every parameter, in the order of the signature. Output arrays are
+   * uninitialized.
+   */
+  virtual void call_contiguous(Span<void *> UNUSED(arrays), int64_t UNUSED(size)) const
+  {
+    BLI_assert_unreachable();
+  }
+
  protected:
   /* Make the function use the given signature. This should be called once in the constructor of
    * child classes. No copy of the signature is made, so the caller has to make sure that the
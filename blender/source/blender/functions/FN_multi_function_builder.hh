@@ -315,6 +315,7 @@ void execute_materialized(TypeSequence<ParamTags...> /* param_tags */,
 template<typename... ParamTags> class CustomMF : public MultiFunction {
  private:
   std::function<void(IndexMask mask, MFParams params)> fn_;
+  std::function<void(Span<void *> arrays, int64_t size)> contiguous_fn_;
   MFSignature signature_;
 
   using TagsSequence = TypeSequence<ParamTags...>;
@@ -334,8 +335,36 @@ template<typename... ParamTags> class CustomMF : public MultiFunction {
       execute(
           element_fn, exec_preset, mask, params, std::make_index_sequence<TagsSequence::size()>());
     };
+    contiguous_fn_ = [element_fn](Span<void *> arrays, const int64_t size) {
+      execute_contiguous(
+          element_fn, arrays, size, std::make_index_sequence<TagsSequence::size()>());
+    };
   }
 
+  template<typename ElementFn, size_t... I>
+  static void execute_contiguous(ElementFn element_fn,
+                                 Span<void *> arrays,
+                                 const int64_t size,
+                                 std::index_sequence<I...> /* indices */)
+  {
+    /* Pass typed pointers to the arrays, so that the loop is optimized like the one for spans. */
+    detail::execute_array(TagsSequence(),
+                          std::index_sequence<I...>(),
+                          element_fn,
+                          IndexRange(size),
+                          typed_array<typename TagsSequence::template at_index<I>>(arrays[I])...);
+  }
+
+  template<typename ParamTag> static auto typed_array(void *array)
+  {
+    using T = typename ParamTag::base_type;
+    if constexpr (ParamTag::category == MFParamCategory::SingleInput) {
+      return static_cast<const T *>(array);
+    }
+    else {
+      return static_cast<T *>(array);
+    }
+  }
   template<typename ElementFn, typename ExecPreset, size_t... I>
   static void execute(ElementFn element_fn,
                       ExecPreset exec_preset,
@@ -412,6 +441,16 @@ template<typename... ParamTags> class CustomMF : public MultiFunction {
   {
     fn_(mask, params);
   }
+
+  bool supports_contiguous_call() const override
+  {
+    return true;
+  }
+
+  void call_contiguous(Span<void *> arrays, const int64_t size) const override
+  {
+    contiguous_fn_(arrays, size);
+  }
 };
 
 /**
@@ -591,6 +630,8 @@ class CustomMF_GenericConstant : public MultiFunction {
   CustomMF_GenericConstant(const CPPType &type, const void *value, bool make_value_copy);
   ~CustomMF_GenericConstant();
   void call(IndexMask mask, MFParams params, MFContext context) const override;
+  bool supports_contiguous_call() const override;
+  void call_contiguous(Span<void *> arrays, int64_t size) const override;
   uint64_t hash() const override;
   bool equals(const MultiFunction &other) const override;
 };
@@ -636,6 +677,16 @@ template<typename T> class CustomMF_Constant : public MultiFunction {
     });
   }
 
+  bool supports_contiguous_call() const override
+  {
+    return true;
+  }
+
+  void call_contiguous(Span<void *> arrays, const int64_t size) const override
+  {
+    uninitialized_fill_n(static_cast<T *>(arrays[0]), size, value_);
+  }
+
   uint64_t hash() const override
   {
     return get_default_hash(value_);
@@ -676,6 +727,8 @@ class CustomMF_GenericCopy : public MultiFunction {
  public:
   CustomMF_GenericCopy(MFDataType data_type);
   void call(IndexMask mask, MFParams params, MFContext context) const override;
+  bool supports_contiguous_call() const override;
+  void call_contiguous(Span<void *> arrays, int64_t size) const override;
 };
 
 }  // namespace blender::fn
@@ -10,14 +10,26 @@
 
 namespace blender::fn {
 
+class MFProcedureFusedKernel;
+
 /** A multi-function that executes a procedure internally. */
 class MFProcedureExecutor : public MultiFunction {
  private:
   MFSignature signature_;
   const MFProcedure &procedure_;
+  /**
+   * Evaluates the procedure in small chunks, when it only consists of element-wise functions.
+   * This is null when the procedure has to be interpreted instead.
+   */
+  std::unique_ptr<MFProcedureFusedKernel> fused_kernel_;
 
  public:
-  MFProcedureExecutor(const MFProcedure &procedure);
+  /**
+   * \param allow_fusion: Try to build a fused kernel for the procedure. Disabling it is mainly
+   * useful to compare the performance and results of both code paths.
+   */
+  MFProcedureExecutor(const MFProcedure &procedure, bool allow_fusion = true);
+  ~MFProcedureExecutor();
 
   void call(IndexMask mask, MFParams params, MFContext context) const override;
 
@@ -40,6 +40,16 @@ void CustomMF_GenericConstant::call(IndexMask mask,
   type_.fill_construct_indices(value_, output.data(), mask);
 }
 
+bool CustomMF_GenericConstant::supports_contiguous_call() const
+{
+  return true;
+}
+
+void CustomMF_GenericConstant::call_contiguous(Span<void *> arrays, const int64_t size) const
+{
+  type_.fill_construct_n(value_, arrays[0], size);
+}
+
 uint64_t CustomMF_GenericConstant::hash() const
 {
   return type_.hash_or_fallback(value_, (uintptr_t)this);
@@ -134,4 +144,15 @@ void CustomMF_GenericCopy::call(IndexMask mask, MFParams params, MFContext UNUSE
   }
 }
 
+bool CustomMF_GenericCopy::supports_contiguous_call() const
+{
+  return this->param_type(0).data_type().is_single();
+}
+
+void CustomMF_GenericCopy::call_contiguous(Span<void *> arrays, const int64_t size) const
+{
+  const CPPType &type = this->param_type(0).data_type().single_type();
+  type.copy_construct_n(arrays[0], arrays[1], size);
+}
+
 }  // namespace blender::fn
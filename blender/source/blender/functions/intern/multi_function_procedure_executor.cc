@@ -2,11 +2,252 @@
 
 #include "FN_multi_function_procedure_executor.hh"
 
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_stack.hh"
 
 namespace blender::fn {
 
-MFProcedureExecutor::MFProcedureExecutor(const MFProcedure &procedure) : procedure_(procedure)
+/**
+ * Many procedures built for fields are just a sequence of calls to simple element-wise functions,
+ * e.g. a chain of math nodes. Interpreting those with the generic executor below means that every
+ * function runs over the entire mask, and that every intermediate value is written to and read
+ * from a full-size array in main memory.
+ *
+ * This kernel evaluates such procedures chunk by chunk instead. The functions are called with
+ * #MultiFunction::call_contiguous on small arrays which stay in the cache for the entire chunk,
+ * and the arrays of variables that are not used anymore are reused by later functions.
+ *
+ * Procedures with branches, vector or non-trivial types, mutable parameters or functions that
+ * don't support contiguous calls are not supported and are handled by the interpreter.
+ */
+class MFProcedureFusedKernel : NonCopyable, NonMovable {
+ private:
+  static constexpr int64_t chunk_size = 256;
+
+  struct Step {
+    const MultiFunction *fn;
+    /* Slot of every parameter of the function. */
+    Vector<int> param_slots;
+  };
+
+  /* Byte offset of every slot in the chunk buffer. Every slot can contain #chunk_size values. */
+  Vector<int64_t> slot_offsets_;
+  int64_t buffer_size_ = 0;
+  /* Slot of every parameter of the procedure. */
+  Vector<int> param_slots_;
+  /* Steps whose inputs are the same for every index. They are only evaluated once per call. */
+  Vector<Step> uniform_steps_;
+  Vector<Step> steps_;
+
+  MFProcedureFusedKernel() = default;
+
+ public:
+  static std::unique_ptr<MFProcedureFusedKernel> try_build(const MFProcedure &procedure)
+  {
+    for (const MFVariable *variable : procedure.variables()) {
+      const MFDataType data_type = variable->data_type();
+      if (!data_type.is_single() || !data_type.single_type().is_trivial()) {
+        return {};
+      }
+    }
+
+    std::unique_ptr<MFProcedureFusedKernel> kernel{new MFProcedureFusedKernel()};
+    Map<const MFVariable *, int> slot_by_variable;
+    Set<const MFVariable *> uniform_variables;
+    /* Slots that can be reused, grouped by the size of a single value. */
+    Map<int64_t, Vector<int>> free_slots_by_value_size;
+
+    auto new_slot = [&](const CPPType &type, const bool reuse) {
+      if (reuse) {
+        Vector<int> *free_slots = free_slots_by_value_size.lookup_ptr(type.size());
+        if (free_slots != nullptr && !free_slots->is_empty()) {
+          return free_slots->pop_last();
+        }
+      }
+      const int slot = kernel->slot_offsets_.append_and_get_index(kernel->buffer_size_);
+      /* Align every slot to a cache line. */
+      kernel->buffer_size_ += (type.size() * chunk_size + 63) & ~int64_t(63);
+      return slot;
+    };
+    auto free_slot = [&](const CPPType &type, const int slot) {
+      free_slots_by_value_size.lookup_or_add_default(type.size()).append(slot);
+    };
+
+    kernel->param_slots_.resize(procedure.params().size(), -1);
+    for (const int param_index : procedure.params().index_range()) {
+      const ConstMFParameter &param = procedure.params()[param_index];
+      if (param.type == MFParamType::Mutable) {
+        return {};
+      }
+      if (param.type == MFParamType::Input) {
+        const int slot = new_slot(param.variable->data_type().single_type(), false);
+        slot_by_variable.add_new(param.variable, slot);
+        kernel->param_slots_[param_index] = slot;
+      }
+    }
+
+    const MFInstruction *instruction = procedure.entry();
+    while (instruction != nullptr && instruction->type() != MFInstructionType::Return) {
+      switch (instruction->type()) {
+        case MFInstructionType::Call: {
+          const MFCallInstruction &call_instruction = static_cast<const MFCallInstruction &>(
+              *instruction);
+          const MultiFunction &fn = call_instruction.fn();
+          if (!fn.supports_contiguous_call() || fn.depends_on_context()) {
+            return {};
+          }
+          bool is_uniform = true;
+          for (const int param_index : fn.param_indices()) {
+            const MFParamType::InterfaceType interface_type =
+                fn.param_type(param_index).interface_type();
+            if (interface_type == MFParamType::Mutable) {
+              return {};
+            }
+            if (interface_type == MFParamType::Input) {
+              is_uniform &= uniform_variables.contains(call_instruction.params()[param_index]);
+            }
+          }
+
+          Step step{&fn, {}};
+          Vector<std::pair<const CPPType *, int>> unused_output_slots;
+          for (const int param_index : fn.param_indices()) {
+            const MFParamType param_type = fn.param_type(param_index);
+            const MFVariable *variable = call_instruction.params()[param_index];
+            if (param_type.interface_type() == MFParamType::Input) {
+              step.param_slots.append(slot_by_variable.lookup(variable));
+              continue;
+            }
+            /* Outputs of uniform steps get slots that are never reused, because they are only
+             * written once before all chunks. */
+            const CPPType &type = param_type.data_type().single_type();
+            const int slot = new_slot(type, !is_uniform);
+            step.param_slots.append(slot);
+            if (variable == nullptr) {
+              unused_output_slots.append({&type, slot});
+            }
+            else {
+              slot_by_variable.add_new(variable, slot);
+              if (is_uniform) {
+                uniform_variables.add_new(variable);
+              }
+            }
+          }
+          if (is_uniform) {
+            kernel->uniform_steps_.append(std::move(step));
+          }
+          else {
+            /* Outputs that are not used can be overwritten by the next steps. */
+            for (const std::pair<const CPPType *, int> &item : unused_output_slots) {
+              free_slot(*item.first, item.second);
+            }
+            kernel->steps_.append(std::move(step));
+          }
+          instruction = call_instruction.next();
+          break;
+        }
+        case MFInstructionType::Destruct: {
+          const MFDestructInstruction &destruct_instruction =
+              static_cast<const MFDestructInstruction &>(*instruction);
+          const MFVariable *variable = destruct_instruction.variable();
+          const int slot = slot_by_variable.pop(variable);
+          if (!uniform_variables.remove(variable)) {
+            free_slot(variable->data_type().single_type(), slot);
+          }
+          instruction = destruct_instruction.next();
+          break;
+        }
+        case MFInstructionType::Dummy: {
+          instruction = static_cast<const MFDummyInstruction *>(instruction)->next();
+          break;
+        }
+        case MFInstructionType::Branch:
+        case MFInstructionType::Return: {
+          return {};
+        }
+      }
+    }
+    if (instruction == nullptr) {
+      return {};
+    }
+
+    for (const int param_index : procedure.params().index_range()) {
+      const ConstMFParameter &param = procedure.params()[param_index];
+      if (param.type == MFParamType::Output) {
+        const int *slot = slot_by_variable.lookup_ptr(param.variable);
+        if (slot == nullptr) {
+          return {};
+        }
+        kernel->param_slots_[param_index] = *slot;
+      }
+    }
+    return kernel;
+  }
+
+  void call(const MultiFunction &executor, const IndexMask full_mask, MFParams params) const
+  {
+    AlignedBuffer<4096, 64> local_buffer;
+    LinearAllocator<> allocator;
+    allocator.provide_buffer(local_buffer);
+    char *buffer = static_cast<char *>(allocator.allocate(buffer_size_, 64));
+
+    Vector<void *, 16> step_arrays;
+    auto run_step = [&](const Step &step, const int64_t size) {
+      step_arrays.clear();
+      for (const int slot : step.param_slots) {
+        step_arrays.append(buffer + slot_offsets_[slot]);
+      }
+      step.fn->call_contiguous(step_arrays, size);
+    };
+
+    /* Compute uniform values for an entire chunk, so that the following steps can read them at
+     * every index. */
+    for (const Step &step : uniform_steps_) {
+      run_step(step, chunk_size);
+    }
+
+    for (int64_t start = 0; start < full_mask.size(); start += chunk_size) {
+      const IndexMask mask = full_mask.slice(start, std::min(chunk_size, full_mask.size() - start));
+
+      for (const int param_index : executor.param_indices()) {
+        if (executor.param_type(param_index).interface_type() == MFParamType::Input) {
+          const GVArray &varray = params.readonly_single_input(param_index);
+          varray.materialize_compressed_to_uninitialized(
+              mask, buffer + slot_offsets_[param_slots_[param_index]]);
+        }
+      }
+
+      for (const Step &step : steps_) {
+        run_step(step, mask.size());
+      }
+
+      for (const int param_index : executor.param_indices()) {
+        if (executor.param_type(param_index).interface_type() != MFParamType::Output) {
+          continue;
+        }
+        GMutableSpan span = params.uninitialized_single_output_if_required(param_index);
+        if (span.is_empty()) {
+          continue;
+        }
+        /* All types are trivial, so the values can be copied to the caller's memory directly. */
+        const int64_t value_size = span.type().size();
+        const char *src = buffer + slot_offsets_[param_slots_[param_index]];
+        char *dst = static_cast<char *>(span.data());
+        if (mask.is_range()) {
+          memcpy(dst + mask[0] * value_size, src, mask.size() * value_size);
+        }
+        else {
+          for (const int64_t i : mask.index_range()) {
+            memcpy(dst + mask[i] * value_size, src + i * value_size, value_size);
+          }
+        }
+      }
+    }
+  }
+};
+
+MFProcedureExecutor::MFProcedureExecutor(const MFProcedure &procedure, const bool allow_fusion)
+    : procedure_(procedure)
 {
   MFSignatureBuilder signature("Procedure Executor");
 
@@ -16,8 +257,14 @@ MFProcedureExecutor::MFProcedureExecutor(const MFProcedure &procedure) : procedu
 
   signature_ = signature.build();
   this->set_signature(&signature_);
+
+  if (allow_fusion) {
+    fused_kernel_ = MFProcedureFusedKernel::try_build(procedure);
+  }
 }
 
+MFProcedureExecutor::~MFProcedureExecutor() = default;
+
 using IndicesSplitVectors = std::array<Vector<int64_t>, 2>;
 
 namespace {
@@ -1177,6 +1424,20 @@ void MFProcedureExecutor::call(IndexMask full_mask, MFParams params, MFContext c
 {
   BLI_assert(procedure_.validate());
 
+  if (fused_kernel_) {
+    /* When all inputs are single values, the interpreter only evaluates every function once. */
+    bool has_varying_input = false;
+    for (const int param_index : this->param_indices()) {
+      if (this->param_type(param_index).interface_type() == MFParamType::Input) {
+        has_varying_input |= !params.readonly_single_input(param_index).is_single();
+      }
+    }
+    if (has_varying_input) {
+      fused_kernel_->call(*this, full_mask, params);
+      return;
+    }
+  }
+
   AlignedBuffer<512, 64> local_buffer;
   LinearAllocator<> linear_allocator;
   linear_allocator.provide_buffer(local_buffer);
@@ -2,6 +2,10 @@
 
 #include "testing/testing.h"
 
+#include <iostream>
+
+#include "BLI_timeit.hh"
+
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_procedure_builder.hh"
 #include "FN_multi_function_procedure_executor.hh"
@@ -408,4 +412,237 @@ TEST(multi_function_procedure, OutputBufferReplaced)
   EXPECT_EQ(output[2], output_value);
 }
 
+/**
+ * procedure(float var_a, float var_b, float *var_out) {
+ *   float value = var_a;
+ *   for (int i = 0; i < 32; i++) {
+ *     value = value * 0.5f + var_b;
+ *   }
+ *   var_out = value;
+ * }
+ */
+class MultiplyAddChain {
+ public:
+  CustomMF_Constant<float> half_fn{0.5f};
+  CustomMF_SI_SI_SO<float, float, float> mul_fn{"mul", [](float a, float b) { return a * b; }};
+  CustomMF_SI_SI_SO<float, float, float> add_fn{"add", [](float a, float b) { return a + b; }};
+  MFProcedure procedure;
+
+  MultiplyAddChain()
+  {
+    MFProcedureBuilder builder{procedure};
+
+    MFVariable *var_a = &builder.add_single_input_parameter<float>();
+    MFVariable *var_b = &builder.add_single_input_parameter<float>();
+    auto [var_half] = builder.add_call<1>(half_fn);
+    MFVariable *value = var_a;
+    for (int i = 0; i < 32; i++) {
+      auto [var_mul] = builder.add_call<1>(mul_fn, {value, var_half});
+      if (value != var_a) {
+        builder.add_destruct(*value);
+      }
+      auto [var_add] = builder.add_call<1>(add_fn, {var_mul, var_b});
+      builder.add_destruct(*var_mul);
+      value = var_add;
+    }
+    builder.add_destruct({var_a, var_b, var_half});
+    builder.add_return();
+    builder.add_output_parameter(*value);
+  }
+
+  static Array<float> evaluate(const MultiFunction &fn,
+                               const IndexMask mask,
+                               const Span<float> values_a,
+                               const Span<float> values_b)
+  {
+    Array<float> results(values_a.size(), -1.0f);
+    MFParamsBuilder params{fn, values_a.size()};
+    params.add_readonly_single_input(values_a);
+    params.add_readonly_single_input(values_b);
+    params.add_uninitialized_single_output(results.as_mutable_span());
+    MFContextBuilder context;
+    fn.call(mask, params, context);
+    return results;
+  }
+};
+
+static void fill_chain_inputs(MutableSpan<float> values_a, MutableSpan<float> values_b)
+{
+  for (const int64_t i : values_a.index_range()) {
+    values_a[i] = float(i % 1000) * 0.01f;
+    values_b[i] = float(i % 7);
+  }
+}
+
+TEST(multi_function_procedure, FusedElementWiseChain)
+{
+  MultiplyAddChain chain;
+  EXPECT_TRUE(chain.procedure.validate());
+
+  MFProcedureExecutor fused_fn{chain.procedure};
+  MFProcedureExecutor interpreted_fn{chain.procedure, false};
+
+  /* Not a multiple of the chunk size, to also test the last partial chunk. */
+  const int64_t size = 1000;
+  Array<float> values_a(size);
+  Array<float> values_b(size);
+  fill_chain_inputs(values_a, values_b);
+
+  const Array<float> fused_results = MultiplyAddChain::evaluate(
+      fused_fn, IndexRange(size), values_a, values_b);
+  const Array<float> interpreted_results = MultiplyAddChain::evaluate(
+      interpreted_fn, IndexRange(size), values_a, values_b);
+  EXPECT_EQ(fused_results.as_span(), interpreted_results.as_span());
+
+  /* Indices that are not in the mask must not be written. */
+  Vector<int64_t> indices;
+  for (int64_t i = 1; i < size; i += 3) {
+    indices.append(i);
+  }
+  const Array<float> fused_masked_results = MultiplyAddChain::evaluate(
+      fused_fn, indices.as_span(), values_a, values_b);
+  for (const int64_t i : IndexRange(size)) {
+    EXPECT_EQ(fused_masked_results[i], i % 3 == 1 ? fused_results[i] : -1.0f);
+  }
+}
+
+TEST(multi_function_procedure, FusedUsesContiguousCalls)
+{
+  /**
+   * procedure(float var_a, float *var_out) {
+   *   var_out = var_a + 1;
+   * }
+   */
+  CountingAddOneFunction add_one_fn;
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+  MFVariable *var_a = &builder.add_single_input_parameter<float>();
+  auto [var_out] = builder.add_call<1>(add_one_fn, {var_a});
+  builder.add_destruct(*var_a);
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+  EXPECT_TRUE(procedure.validate());
+
+  MFProcedureExecutor procedure_fn{procedure};
+  Array<float> values = {1.0f, 2.0f, 3.0f};
+  Array<float> results(3);
+  MFParamsBuilder params{procedure_fn, 3};
+  params.add_readonly_single_input(values.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  procedure_fn.call(IndexRange(3), params, context);
+
+  EXPECT_EQ(results[0], 2.0f);
+  EXPECT_EQ(results[2], 4.0f);
+  EXPECT_GT(add_one_fn.contiguous_calls, 0);
+  EXPECT_EQ(add_one_fn.calls, 0);
+}
+
+TEST(multi_function_procedure, FusedFallbackForBranch)
+{
+  /**
+   * procedure(float var_a, bool var_cond, float *var_out) {
+   *   var_out = var_a + 1;
+   *   if (var_cond) {
+   *     var_tmp = var_out + 1;
+   *   }
+   * }
+   */
+  CountingAddOneFunction add_one_fn;
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+  MFVariable *var_a = &builder.add_single_input_parameter<float>();
+  MFVariable *var_cond = &builder.add_single_input_parameter<bool>();
+  auto [var_out] = builder.add_call<1>(add_one_fn, {var_a});
+  MFProcedureBuilder::Branch branch = builder.add_branch(*var_cond);
+  auto [var_tmp] = branch.branch_true.add_call<1>(add_one_fn, {var_out});
+  branch.branch_true.add_destruct(*var_tmp);
+  builder.set_cursor_after_branch(branch);
+  builder.add_destruct({var_a, var_cond});
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+  EXPECT_TRUE(procedure.validate());
+
+  MFProcedureExecutor procedure_fn{procedure};
+  Array<float> values = {1.0f, 2.0f, 3.0f};
+  Array<bool> conditions = {true, false, true};
+  Array<float> results(3);
+  MFParamsBuilder params{procedure_fn, 3};
+  params.add_readonly_single_input(values.as_span());
+  params.add_readonly_single_input(conditions.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  procedure_fn.call(IndexRange(3), params, context);
+
+  EXPECT_EQ(results[0], 2.0f);
+  EXPECT_EQ(results[1], 3.0f);
+  EXPECT_EQ(results[2], 4.0f);
+  EXPECT_EQ(add_one_fn.contiguous_calls, 0);
+  EXPECT_GT(add_one_fn.calls, 0);
+}
+
+TEST(multi_function_procedure, FusedFallbackForNonTrivialType)
+{
+  /**
+   * procedure(float var_a, std::string var_name, float *var_out) {
+   *   var_out = var_a + 1;
+   * }
+   */
+  CountingAddOneFunction add_one_fn;
+
+  MFProcedure procedure;
+  MFProcedureBuilder builder{procedure};
+  MFVariable *var_a = &builder.add_single_input_parameter<float>();
+  MFVariable *var_name = &builder.add_single_input_parameter<std::string>();
+  auto [var_out] = builder.add_call<1>(add_one_fn, {var_a});
+  builder.add_destruct({var_a, var_name});
+  builder.add_return();
+  builder.add_output_parameter(*var_out);
+  EXPECT_TRUE(procedure.validate());
+
+  MFProcedureExecutor procedure_fn{procedure};
+  Array<float> values = {1.0f, 2.0f, 3.0f};
+  Array<std::string> names = {"a", "b", "c"};
+  Array<float> results(3);
+  MFParamsBuilder params{procedure_fn, 3};
+  params.add_readonly_single_input(values.as_span());
+  params.add_readonly_single_input(names.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  procedure_fn.call(IndexRange(3), params, context);
+
+  EXPECT_EQ(results[0], 2.0f);
+  EXPECT_EQ(results[2], 4.0f);
+  EXPECT_EQ(add_one_fn.contiguous_calls, 0);
+  EXPECT_GT(add_one_fn.calls, 0);
+}
+
+#if 0
+TEST(multi_function_procedure, FusedElementWiseChainBenchmark)
+{
+  MultiplyAddChain chain;
+  MFProcedureExecutor fused_fn{chain.procedure};
+  MFProcedureExecutor interpreted_fn{chain.procedure, false};
+
+  const int64_t size = 4'000'000;
+  Array<float> values_a(size);
+  Array<float> values_b(size);
+  fill_chain_inputs(values_a, values_b);
+
+  for (const int run : IndexRange(3)) {
+    UNUSED_VARS(run);
+    for (const MFProcedureExecutor *fn : {&fused_fn, &interpreted_fn}) {
+      const timeit::TimePoint start = timeit::Clock::now();
+      MultiplyAddChain::evaluate(*fn, IndexRange(size), values_a, values_b);
+      const timeit::Nanoseconds duration = timeit::Clock::now() - start;
+      const double seconds = std::chrono::duration<double>(duration).count();
+      std::cout << (fn == &fused_fn ? "Fused:       " : "Interpreted: ")
+                << int64_t(double(size) / seconds) << " points/sec\n";
+    }
+  }
+}
+#endif /* Benchmark */
+
 }  // namespace blender::fn::tests
@@ -1,5 +1,7 @@
 /* SPDX-License-Identifier: Apache-2.0 */
 
+#include <atomic>
+
 #include "FN_multi_function.hh"
 
 namespace blender::fn::tests {
@@ -200,4 +202,53 @@ class OptionalOutputsFunction : public MultiFunction {
   }
 };
 
+/**
+ * Adds one to every value and counts how it is called. This allows checking whether a procedure
+ * is executed with fused contiguous calls or by the interpreter.
+ */
+class CountingAddOneFunction : public MultiFunction {
+ public:
+  mutable std::atomic<int> calls = 0;
+  mutable std::atomic<int> contiguous_calls = 0;
+
+  CountingAddOneFunction()
+  {
+    static MFSignature signature = create_signature();
+    this->set_signature(&signature);
+  }
+
+  static MFSignature create_signature()
+  {
+    MFSignatureBuilder signature{"Counting Add One"};
+    signature.single_input<float>("Value");
+    signature.single_output<float>("Result");
+    return signature.build();
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext UNUSED(context)) const override
+  {
+    calls++;
+    const VArray<float> &values = params.readonly_single_input<float>(0, "Value");
+    MutableSpan<float> results = params.uninitialized_single_output<float>(1, "Result");
+    for (int64_t i : mask) {
+      results[i] = values[i] + 1.0f;
+    }
+  }
+
+  bool supports_contiguous_call() const override
+  {
+    return true;
+  }
+
+  void call_contiguous(Span<void *> arrays, const int64_t size) const override
+  {
+    contiguous_calls++;
+    const float *values = static_cast<const float *>(arrays[0]);
+    float *results = static_cast<float *>(arrays[1]);
+    for (int64_t i = 0; i < size; i++) {
+      results[i] = values[i] + 1.0f;
+    }
+  }
+};
+
 }  // namespace blender::fn::tests
@@ -1,6 +1,8 @@
 /* SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "BLI_index_mask.hh"
+#include "BLI_math_vec_types.hh"
+#include "BLI_virtual_array.hh"
 
 #pragma once
 
@@ -13,6 +15,23 @@ class PointCloudComponent;
 
 namespace blender::geometry {
 
+/**
+ * Find the selected points that are within the \a merge_distance of other selected points. The
+ * points are visited in the order of the nodes of a balanced KD tree, and every point that is not
+ * merged yet becomes the target of all unmerged points within the distance. This gives the same
+ * result as #BLI_kdtree_3d_calc_duplicates_fast without index order, but the neighbors are found
+ * in parallel with a spatial hash grid, and the result doesn't depend on the number of threads.
+ * Unlike the KD tree, points at exactly the merge distance along an axis are never missed.
+ *
+ * \param r_merge_indices: Values of selected points are expected to be -1. Merged points get the
+ * index of the point they are merged into, and those points get their own index.
+ * \return The number of merged points.
+ */
+int find_merge_targets(const VArray<float3> &positions,
+                       IndexMask selection,
+                       float merge_distance,
+                       MutableSpan<int> r_merge_indices);
+
 /**
  * Merge selected points into other selected points within the \a merge_distance. The merged
  * indices favor speed over accuracy, since the results will depend on the order of the points.
@@ -2,9 +2,9 @@
 
 #include "BLI_array.hh"
 #include "BLI_index_mask.hh"
-#include "BLI_kdtree.h"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "DNA_mesh_types.h"
@@ -14,6 +14,7 @@
 #include "BKE_mesh.h"
 
 #include "GEO_mesh_merge_by_distance.hh"
+#include "GEO_point_merge_by_distance.hh"
 
 //#define USE_WELD_DEBUG
 //#define USE_WELD_NORMALS
@@ -1561,22 +1562,21 @@ static Mesh *create_merged_mesh(const Mesh &mesh,
 /** \name Merge Map Creation
  * \{ */
 
+static float3 get_vert_position(const MVert &vert)
+{
+  return float3(vert.co);
+}
+
 std::optional<Mesh *> mesh_merge_by_distance_all(const Mesh &mesh,
                                                  const IndexMask selection,
                                                  const float merge_distance)
 {
   Array<int> vert_dest_map(mesh.totvert, OUT_OF_CONTEXT);
 
-  KDTree_3d *tree = BLI_kdtree_3d_new(selection.size());
-
-  for (const int i : selection) {
-    BLI_kdtree_3d_insert(tree, i, mesh.mvert[i].co);
-  }
-
-  BLI_kdtree_3d_balance(tree);
-  const int vert_kill_len = BLI_kdtree_3d_calc_duplicates_fast(
-      tree, merge_distance, false, vert_dest_map.data());
-  BLI_kdtree_3d_free(tree);
+  const VArray<float3> positions = VArray<float3>::ForDerivedSpan<MVert, get_vert_position>(
+      {mesh.mvert, mesh.totvert});
+  const int vert_kill_len = find_merge_targets(
+      positions, selection, merge_distance, vert_dest_map);
 
   if (vert_kill_len == 0) {
     return std::nullopt;
@@ -1601,20 +1601,22 @@ std::optional<Mesh *> mesh_merge_by_distance_connected(const Mesh &mesh,
   int vert_kill_len = 0;
 
   /* From the original index of the vertex.
-   * This indicates which vert it is or is going to be merged. */
-  Array<int> vert_dest_map(mesh.totvert, OUT_OF_CONTEXT);
+   * This indicates which vert it is or is going to be merged. The root of every cluster of merged
+   * vertices is its vertex with the smallest index. */
+  Array<int> vert_parents(mesh.totvert);
 
   Array<WeldVertexCluster> vert_clusters(mesh.totvert);
 
-  for (const int i : verts.index_range()) {
-    WeldVertexCluster &vc = vert_clusters[i];
-    copy_v3_v3(vc.co, verts[i].co);
-    vc.merged_verts = 0;
-  }
+  threading::parallel_for(verts.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      WeldVertexCluster &vc = vert_clusters[i];
+      copy_v3_v3(vc.co, verts[i].co);
+      vc.merged_verts = 0;
+      vert_parents[i] = i;
+    }
+  });
   const float merge_dist_sq = square_f(merge_distance);
 
-  range_vn_i(vert_dest_map.data(), mesh.totvert, 0);
-
   /* Collapse Edges that are shorter than the threshold. */
   for (const int i : edges.index_range()) {
     int v1 = edges[i].v1;
@@ -1623,11 +1625,14 @@ std::optional<Mesh *> mesh_merge_by_distance_connected(const Mesh &mesh,
     if (only_loose_edges && (edges[i].flag & ME_LOOSEEDGE) == 0) {
       continue;
     }
-    while (v1 != vert_dest_map[v1]) {
-      v1 = vert_dest_map[v1];
+    /* Path halving keeps the chains to the roots short, the roots themselves don't change. */
+    while (v1 != vert_parents[v1]) {
+      vert_parents[v1] = vert_parents[vert_parents[v1]];
+      v1 = vert_parents[v1];
     }
-    while (v2 != vert_dest_map[v2]) {
-      v2 = vert_dest_map[v2];
+    while (v2 != vert_parents[v2]) {
+      vert_parents[v2] = vert_parents[vert_parents[v2]];
+      v2 = vert_parents[v2];
     }
     if (v1 == v2) {
       continue;
@@ -1650,7 +1655,7 @@ std::optional<Mesh *> mesh_merge_by_distance_connected(const Mesh &mesh,
       madd_v3_v3fl(v1_cluster->co, edgedir, influence);
 
       v1_cluster->merged_verts += v2_cluster->merged_verts + 1;
-      vert_dest_map[v2] = v1;
+      vert_parents[v2] = v1;
       vert_kill_len++;
     }
   }
@@ -1659,19 +1664,23 @@ std::optional<Mesh *> mesh_merge_by_distance_connected(const Mesh &mesh,
     return std::nullopt;
   }
 
-  for (const int i : IndexRange(mesh.totvert)) {
-    if (i == vert_dest_map[i]) {
-      vert_dest_map[i] = OUT_OF_CONTEXT;
-    }
-    else {
+  /* Vertices are merged into the root of their cluster, and roots of clusters with other vertices
+   * are merged into themselves. */
+  Array<int> vert_dest_map(mesh.totvert);
+  threading::parallel_for(verts.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
       int v = i;
-      while ((v != vert_dest_map[v]) && (vert_dest_map[v] != OUT_OF_CONTEXT)) {
-        v = vert_dest_map[v];
+      while (v != vert_parents[v]) {
+        v = vert_parents[v];
+      }
+      if (v == i && vert_clusters[i].merged_verts == 0) {
+        vert_dest_map[i] = OUT_OF_CONTEXT;
+      }
+      else {
+        vert_dest_map[i] = v;
       }
-      vert_dest_map[v] = v;
-      vert_dest_map[i] = v;
     }
-  }
+  });
 
   return create_merged_mesh(mesh, vert_dest_map, vert_kill_len);
 }
@@ -1,6 +1,9 @@
 /* SPDX-License-Identifier: GPL-2.0-or-later */
 
-#include "BLI_kdtree.h"
+#include <algorithm>
+
+#include "BLI_bounds.hh"
+#include "BLI_sort.hh"
 #include "BLI_task.hh"
 
 #include "DNA_pointcloud_types.h"
@@ -13,30 +16,359 @@
 
 namespace blender::geometry {
 
+/* -------------------------------------------------------------------- */
+/** \name Merge Target Finding
+ * \{ */
+
+/**
+ * A uniform grid whose cells are at least twice as large as the merge distance, so that all points
+ * within the distance of a point are in the 2x2x2 cells closest to it. The grid is stored as a
+ * spatial hash: the points are sorted by the hash of their cell, and every bucket of the hash
+ * table references a range of the sorted points. Unlike a KD tree, it can be built in parallel.
+ *
+ * The cells are padded by #cell_padding and there are at most #max_cells_per_axis along every
+ * axis, so that the rounding errors of the grid coordinates (below 0.01 cells) can never move a
+ * point at exactly the merge distance outside of the searched cells.
+ */
+struct PointGrid {
+  static constexpr float cell_padding = 1.05f;
+  static constexpr int max_cells_per_axis = 1 << 15;
+  static constexpr int cell_bits = 16;
+  static constexpr int max_cell = (1 << cell_bits) - 1;
+
+  float3 min;
+  float cell_size;
+  int hash_shift;
+
+  /* The position, cell and index in the selection of every point, sorted by the hash of the cell.
+   * Points in the same bucket are sorted by index. */
+  Array<float3> positions;
+  Array<uint64_t> cells;
+  Array<int> indices;
+  /* The start of every bucket in the sorted arrays, with an extra value at the end. */
+  Array<int> bucket_offsets;
+
+  float3 grid_coords(const float3 &position) const
+  {
+    const float3 coords = (position - this->min) / this->cell_size;
+    return float3(std::clamp(coords.x, 0.0f, float(max_cell)),
+                  std::clamp(coords.y, 0.0f, float(max_cell)),
+                  std::clamp(coords.z, 0.0f, float(max_cell)));
+  }
+
+  int3 cell_coords(const float3 &position) const
+  {
+    return int3(this->grid_coords(position));
+  }
+
+  static uint64_t cell_key(const int3 &coords)
+  {
+    return uint64_t(coords.x) | uint64_t(coords.y) << cell_bits |
+           uint64_t(coords.z) << (2 * cell_bits);
+  }
+
+  int bucket(const uint64_t cell) const
+  {
+    return int((cell * 0x9E3779B97F4A7C15ULL) >> this->hash_shift);
+  }
+
+  /**
+   * Call the function with the sorted index of every point in the cells that can contain points
+   * within the merge distance of the position. Besides the cell of the position, that is only the
+   * neighbor cell on the closer side along every axis.
+   */
+  template<typename Fn> void foreach_point_near(const float3 &position, const Fn &fn) const
+  {
+    const float3 coords = this->grid_coords(position);
+    const int3 center(coords);
+    int3 first;
+    int3 last;
+    for (const int axis : IndexRange(3)) {
+      const bool lower_half = coords[axis] - float(center[axis]) < 0.5f;
+      first[axis] = lower_half ? std::max(center[axis] - 1, 0) : center[axis];
+      last[axis] = lower_half ? center[axis] : std::min(center[axis] + 1, max_cell);
+    }
+    for (int z = first.z; z <= last.z; z++) {
+      for (int y = first.y; y <= last.y; y++) {
+        for (int x = first.x; x <= last.x; x++) {
+          const uint64_t cell = cell_key(int3(x, y, z));
+          const int bucket = this->bucket(cell);
+          for (const int i : IndexRange(bucket_offsets[bucket],
+                                        bucket_offsets[bucket + 1] - bucket_offsets[bucket])) {
+            /* Different cells can share a bucket. */
+            if (this->cells[i] == cell) {
+              fn(i);
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+static void build_point_grid(Span<float3> positions, const float merge_distance, PointGrid &grid)
+{
+  const bounds::MinMaxResult<float3> bounds = *bounds::min_max(positions);
+  const float3 extent = bounds.max - bounds.min;
+  const float max_extent = std::max({extent.x, extent.y, extent.z});
+
+  /* Make the cells larger than necessary when there would be too many along an axis. */
+  grid.min = bounds.min;
+  grid.cell_size = std::max(2.0f * merge_distance * PointGrid::cell_padding,
+                            max_extent / float(PointGrid::max_cells_per_axis));
+  if (grid.cell_size <= 0.0f) {
+    grid.cell_size = 1.0f;
+  }
+
+  const int size = positions.size();
+  int bucket_bits = 1;
+  while ((1 << bucket_bits) < size && bucket_bits < 30) {
+    bucket_bits++;
+  }
+  const int buckets_num = 1 << bucket_bits;
+  grid.hash_shift = 64 - bucket_bits;
+
+  Array<uint64_t> point_cells(size);
+  threading::parallel_for(positions.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      point_cells[i] = PointGrid::cell_key(grid.cell_coords(positions[i]));
+    }
+  });
+
+  /* Sort the bucket and index of every point packed into a single integer, which is much faster
+   * than sorting indices with a custom comparison. */
+  Array<uint64_t> order(size);
+  threading::parallel_for(order.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      order[i] = uint64_t(grid.bucket(point_cells[i])) << 32 | uint64_t(i);
+    }
+  });
+  parallel_sort(order.begin(), order.end());
+
+  grid.positions.reinitialize(size);
+  grid.cells.reinitialize(size);
+  grid.indices.reinitialize(size);
+  threading::parallel_for(IndexRange(size), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int index = int(order[i] & 0xFFFFFFFFu);
+      grid.indices[i] = index;
+      grid.positions[i] = positions[index];
+      grid.cells[i] = point_cells[index];
+    }
+  });
+
+  /* Every sorted point that starts a new bucket fills the offsets of the empty buckets before it,
+   * so that every offset is written exactly once. */
+  grid.bucket_offsets.reinitialize(buckets_num + 1);
+  threading::parallel_for(IndexRange(size), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const int bucket = grid.bucket(grid.cells[i]);
+      const int prev_bucket = i == 0 ? -1 : grid.bucket(grid.cells[i - 1]);
+      for (int b = prev_bucket + 1; b <= bucket; b++) {
+        grid.bucket_offsets[b] = i;
+      }
+      if (i == size - 1) {
+        for (int b = bucket + 1; b <= buckets_num; b++) {
+          grid.bucket_offsets[b] = size;
+        }
+      }
+    }
+  });
+}
+
+struct OrderNode {
+  float3 co;
+  int index;
+};
+
+/**
+ * Reorder the nodes exactly like #BLI_kdtree_3d_balance does: the median along the axis is found
+ * with the same quick-select, and both halves are balanced recursively along the next axis. The
+ * resulting order is the node order of the balanced tree. Unlike the tree's balancing, the halves
+ * are processed in parallel, so only the partitioning of the largest nodes is serial.
+ */
+static void kdtree_balance_order(MutableSpan<OrderNode> nodes, const int axis)
+{
+  const int nodes_len = int(nodes.size());
+  if (nodes_len <= 1) {
+    return;
+  }
+
+  /* Quick-sort style sorting around median, see #kdtree_balance. */
+  int left = 0;
+  int right = nodes_len - 1;
+  const int median = nodes_len / 2;
+
+  while (right > left) {
+    const float co = nodes[right].co[axis];
+    int i = left - 1;
+    int j = right;
+
+    while (true) {
+      while (nodes[++i].co[axis] < co) {
+        /* Pass. */
+      }
+      while (nodes[--j].co[axis] > co && j > left) {
+        /* Pass. */
+      }
+      if (i >= j) {
+        break;
+      }
+      std::swap(nodes[i], nodes[j]);
+    }
+
+    std::swap(nodes[i], nodes[right]);
+    if (i >= median) {
+      right = i - 1;
+    }
+    if (i <= median) {
+      left = i + 1;
+    }
+  }
+
+  const int next_axis = (axis + 1) % 3;
+  threading::parallel_invoke(
+      nodes_len > 16384,
+      [&]() { kdtree_balance_order(nodes.take_front(median), next_axis); },
+      [&]() { kdtree_balance_order(nodes.drop_front(median + 1), next_axis); });
+}
+
+int find_merge_targets(const VArray<float3> &positions,
+                       const IndexMask selection,
+                       const float merge_distance,
+                       MutableSpan<int> r_merge_indices)
+{
+  const int size = selection.size();
+  if (size == 0) {
+    return 0;
+  }
+
+  /* The points are visited in the order of the nodes of a balanced KD tree, which is the order
+   * #BLI_kdtree_3d_calc_duplicates_fast used for merging before, so that the same points are
+   * merged. The order is computed without building the tree, see #kdtree_balance_order. */
+  Array<int> order(size);
+  Array<float3> ordered_positions(size);
+  {
+    Array<float3> selected_positions(size);
+    positions.materialize_compressed_to_uninitialized(selection, selected_positions);
+
+    Array<OrderNode> nodes(size);
+    threading::parallel_for(IndexRange(size), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        nodes[i] = {selected_positions[i], i};
+      }
+    });
+    kdtree_balance_order(nodes, 0);
+
+    threading::parallel_for(IndexRange(size), 4096, [&](IndexRange range) {
+      for (const int i : range) {
+        order[i] = nodes[i].index;
+        ordered_positions[i] = nodes[i].co;
+      }
+    });
+  }
+
+  PointGrid grid;
+  build_point_grid(ordered_positions, merge_distance, grid);
+  const float merge_distance_sq = merge_distance * merge_distance;
+
+  /* The position in the visiting order of the point that every point is merged into. */
+  Array<int> targets(size, -1);
+  int merged_num = 0;
+
+  /* Finding the neighbors is done for a block of points in parallel. Then the greedy merging is
+   * done in the visiting order, which is cheap since the neighbors are known already. Blocks limit
+   * the memory used to store the neighbors, and allow skipping points that were merged before. */
+  const int block_size = 65536;
+  const int chunk_size = 1024;
+  struct ChunkNeighbors {
+    Vector<int> offsets;
+    Vector<int> indices;
+  };
+  Array<ChunkNeighbors> chunks(block_size / chunk_size);
+
+  for (int block_start = 0; block_start < size; block_start += block_size) {
+    const IndexRange block(block_start, std::min(block_size, size - block_start));
+    const int chunks_num = (block.size() + chunk_size - 1) / chunk_size;
+
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](IndexRange chunk_range) {
+      for (const int chunk_i : chunk_range) {
+        ChunkNeighbors &chunk = chunks[chunk_i];
+        chunk.offsets.clear();
+        chunk.indices.clear();
+        const int chunk_start = chunk_i * chunk_size;
+        const IndexRange points = block.slice(
+            chunk_start, std::min<int64_t>(chunk_size, block.size() - chunk_start));
+        for (const int i : points) {
+          chunk.offsets.append(chunk.indices.size());
+          if (targets[i] != -1) {
+            continue;
+          }
+          /* Only points after this one have to be found. The points before it were visited
+           * already, so they are merged or would have merged this point. */
+          const float3 &position = ordered_positions[i];
+          grid.foreach_point_near(position, [&](const int sorted_i) {
+            const int neighbor = grid.indices[sorted_i];
+            if (neighbor > i && targets[neighbor] == -1 &&
+                math::distance_squared(position, grid.positions[sorted_i]) <= merge_distance_sq) {
+              chunk.indices.append(neighbor);
+            }
+          });
+        }
+        chunk.offsets.append(chunk.indices.size());
+      }
+    });
+
+    for (const int chunk_i : IndexRange(chunks_num)) {
+      const ChunkNeighbors &chunk = chunks[chunk_i];
+      for (const int point_i : IndexRange(chunk.offsets.size() - 1)) {
+        const int i = block.start() + chunk_i * chunk_size + point_i;
+        if (targets[i] != -1) {
+          continue;
+        }
+        bool found = false;
+        for (const int neighbor : chunk.indices.as_span().slice(
+                 chunk.offsets[point_i], chunk.offsets[point_i + 1] - chunk.offsets[point_i])) {
+          if (targets[neighbor] == -1) {
+            targets[neighbor] = i;
+            merged_num++;
+            found = true;
+          }
+        }
+        if (found) {
+          /* Prevent chains of merged points. */
+          targets[i] = i;
+        }
+      }
+    }
+  }
+
+  threading::parallel_for(targets.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      if (targets[i] != -1) {
+        r_merge_indices[selection[order[i]]] = selection[order[targets[i]]];
+      }
+    }
+  });
+
+  return merged_num;
+}
+
+/** \} */
+
 PointCloud *point_merge_by_distance(const PointCloud &src_points,
                                     const float merge_distance,
                                     const IndexMask selection)
 {
   const bke::AttributeAccessor src_attributes = bke::pointcloud_attributes(src_points);
-  VArraySpan<float3> positions = src_attributes.lookup_or_default<float3>(
+  const VArray<float3> positions = src_attributes.lookup_or_default<float3>(
       "position", ATTR_DOMAIN_POINT, float3(0));
   const int src_size = positions.size();
 
-  /* Create the KD tree based on only the selected points, to speed up merge detection and
-   * balancing. */
-  KDTree_3d *tree = BLI_kdtree_3d_new(selection.size());
-  for (const int i : selection.index_range()) {
-    BLI_kdtree_3d_insert(tree, i, positions[selection[i]]);
-  }
-  BLI_kdtree_3d_balance(tree);
-
-  /* Find the duplicates in the KD tree. Because the tree only contains the selected points, the
-   * resulting indices are indices into the selection, rather than indices of the source point
-   * cloud. */
-  Array<int> selection_merge_indices(selection.size(), -1);
-  const int duplicate_count = BLI_kdtree_3d_calc_duplicates_fast(
-      tree, merge_distance, false, selection_merge_indices.data());
-  BLI_kdtree_3d_free(tree);
+  /* Find the duplicates, only the selected points are considered. */
+  Array<int> merge_indices(src_size, -1);
+  const int duplicate_count = find_merge_targets(
+      positions, selection, merge_distance, merge_indices);
 
   /* Create the new point cloud and add it to a temporary component for the attribute API. */
   const int dst_size = src_size - duplicate_count;
@@ -44,21 +376,14 @@ PointCloud *point_merge_by_distance(const PointCloud &src_points,
   bke::MutableAttributeAccessor dst_attributes = bke::pointcloud_attributes_for_write(
       *dst_pointcloud);
 
-  /* By default, every point is just "merged" with itself. Then fill in the results of the merge
-   * finding, converting from indices into the selection to indices into the full input point
-   * cloud. */
-  Array<int> merge_indices(src_size);
-  for (const int i : merge_indices.index_range()) {
-    merge_indices[i] = i;
-  }
-  for (const int i : selection_merge_indices.index_range()) {
-    const int merge_index = selection_merge_indices[i];
-    if (merge_index != -1) {
-      const int src_merge_index = selection[merge_index];
-      const int src_index = selection[i];
-      merge_indices[src_index] = src_merge_index;
+  /* Every point that is not merged is just "merged" with itself. */
+  threading::parallel_for(merge_indices.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      if (merge_indices[i] == -1) {
+        merge_indices[i] = i;
+      }
     }
-  }
+  });
 
   /* For every source index, find the corresponding index in the result by iterating through the
    * source indices and counting how many merges happened before that point. */
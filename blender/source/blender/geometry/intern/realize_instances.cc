@@ -9,6 +9,8 @@
 #include "DNA_object_types.h"
 #include "DNA_pointcloud_types.h"
 
+#include "BLI_color.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_noise.hh"
 #include "BLI_task.hh"
 
@@ -101,6 +103,12 @@ struct MeshRealizeInfo {
   Array<std::optional<GVArraySpan>> attributes;
   /** Vertex ids stored on the mesh. If there are no ids, this #Span is empty. */
   Span<int> stored_vertex_ids;
+  /**
+   * Normals that are already computed on the mesh and can be transformed instead of being
+   * recomputed on the result. If they can't be used, these spans are empty.
+   */
+  Span<float3> vertex_normals;
+  Span<float3> poly_normals;
 };
 
 struct RealizeMeshTask {
@@ -181,6 +189,8 @@ struct AllMeshesInfo {
   /** Ordered materials on the output mesh. */
   VectorSet<Material *> materials;
   bool create_id_attribute = false;
+  /** True when the normals of all meshes are available in their #MeshRealizeInfo. */
+  bool transfer_normals = false;
 };
 
 struct AllCurvesInfo {
@@ -257,13 +267,59 @@ struct InstanceContext {
   }
 };
 
+/**
+ * Same as `transform * position`, but inlined so that loops over many positions can be
+ * vectorized, instead of calling #mul_v3_m4v3 for every element.
+ */
+BLI_INLINE float3 transform_position(const float4x4 &transform, const float3 &position)
+{
+  const float(*m)[4] = transform.values;
+  return {m[0][0] * position.x + m[1][0] * position.y + m[2][0] * position.z + m[3][0],
+          m[0][1] * position.x + m[1][1] * position.y + m[2][1] * position.z + m[3][1],
+          m[0][2] * position.x + m[1][2] * position.y + m[2][2] * position.z + m[3][2]};
+}
+
+/**
+ * Transform a normal with a transform that passes #transform_preserves_angles. The result is the
+ * same as the normal that would be computed from the transformed geometry. The sign is negative
+ * when the transform mirrors the geometry, because the winding order of the faces stays the same.
+ */
+BLI_INLINE float3 transform_normal(const float4x4 &transform,
+                                   const float sign,
+                                   const float3 &normal)
+{
+  const float(*m)[4] = transform.values;
+  const float3 result{m[0][0] * normal.x + m[1][0] * normal.y + m[2][0] * normal.z,
+                      m[0][1] * normal.x + m[1][1] * normal.y + m[2][1] * normal.z,
+                      m[0][2] * normal.x + m[1][2] * normal.y + m[2][2] * normal.z};
+  return math::normalize(result) * sign;
+}
+
+/**
+ * Only transforms that rotate, mirror and scale uniformly keep angles between edges unchanged.
+ * Normals of geometry transformed that way can be transformed directly instead of recomputing
+ * them from the new positions.
+ */
+static bool transform_preserves_angles(const float4x4 &transform)
+{
+  const float3 x{transform.values[0]};
+  const float3 y{transform.values[1]};
+  const float3 z{transform.values[2]};
+  const float length_squared = math::length_squared(x);
+  const float epsilon = length_squared * 1e-5f;
+  return length_squared > 0.0f && std::abs(math::length_squared(y) - length_squared) <= epsilon &&
+         std::abs(math::length_squared(z) - length_squared) <= epsilon &&
+         std::abs(math::dot(x, y)) <= epsilon && std::abs(math::dot(x, z)) <= epsilon &&
+         std::abs(math::dot(y, z)) <= epsilon;
+}
+
 static void copy_transformed_positions(const Span<float3> src,
                                        const float4x4 &transform,
                                        MutableSpan<float3> dst)
 {
   threading::parallel_for(src.index_range(), 1024, [&](const IndexRange range) {
     for (const int i : range) {
-      dst[i] = transform * src[i];
+      dst[i] = transform_position(transform, src[i]);
     }
   });
 }
@@ -285,32 +341,77 @@ static void threaded_fill(const GPointer value, GMutableSpan dst)
   });
 }
 
+template<typename T> static void threaded_copy(const Span<T> src, MutableSpan<T> dst)
+{
+  threading::parallel_for(src.index_range(), 4096, [&](const IndexRange range) {
+    dst.slice(range).copy_from(src.slice(range));
+  });
+}
+
+template<typename T> static void threaded_fill(const T &value, MutableSpan<T> dst)
+{
+  threading::parallel_for(dst.index_range(), 4096, [&](const IndexRange range) {
+    dst.slice(range).fill(value);
+  });
+}
+
+/**
+ * Copy the generic attributes of a batch of tasks to the result. The outer loop is over the
+ * attributes, so that every attribute type is resolved only once per batch and each destination
+ * array is written front to back. When many small geometries are realized, this avoids that the
+ * per-task overhead dominates the actual copying.
+ *
+ * \param src_attributes_fn: Returns the source attributes of a task, ordered like
+ * #ordered_attributes.
+ * \param range_fn: Returns the range in the result that a task writes to for a given domain.
+ */
+template<typename Task, typename SrcAttributesFn, typename RangeFn>
 static void copy_generic_attributes_to_result(
-    const Span<std::optional<GVArraySpan>> src_attributes,
-    const AttributeFallbacksArray &attribute_fallbacks,
+    const Span<Task> tasks,
+    const SrcAttributesFn &src_attributes_fn,
     const OrderedAttributes &ordered_attributes,
-    const FunctionRef<IndexRange(eAttrDomain)> &range_fn,
+    const RangeFn &range_fn,
     MutableSpan<GSpanAttributeWriter> dst_attribute_writers)
 {
-  threading::parallel_for(
-      dst_attribute_writers.index_range(), 10, [&](const IndexRange attribute_range) {
-        for (const int attribute_index : attribute_range) {
-          const eAttrDomain domain = ordered_attributes.kinds[attribute_index].domain;
-          const IndexRange element_slice = range_fn(domain);
-
-          GMutableSpan dst_span = dst_attribute_writers[attribute_index].span.slice(element_slice);
-          if (src_attributes[attribute_index].has_value()) {
-            threaded_copy(*src_attributes[attribute_index], dst_span);
+  for (const int attribute_index : ordered_attributes.index_range()) {
+    const eAttrDomain domain = ordered_attributes.kinds[attribute_index].domain;
+    const GMutableSpan dst_span = dst_attribute_writers[attribute_index].span;
+    const CPPType &cpp_type = dst_span.type();
+    cpp_type.to_static_type_tag<float,
+                                float2,
+                                float3,
+                                int,
+                                bool,
+                                int8_t,
+                                ColorGeometry4f,
+                                ColorGeometry4b>([&](auto type_tag) {
+      using T = typename decltype(type_tag)::type;
+      for (const Task &task : tasks) {
+        const std::optional<GVArraySpan> &src = src_attributes_fn(task)[attribute_index];
+        const IndexRange element_slice = range_fn(task, domain);
+        const void *fallback = task.attribute_fallbacks.array[attribute_index] == nullptr ?
+                                   cpp_type.default_value() :
+                                   task.attribute_fallbacks.array[attribute_index];
+        if constexpr (std::is_void_v<T>) {
+          if (src.has_value()) {
+            threaded_copy(*src, dst_span.slice(element_slice));
           }
           else {
-            const CPPType &cpp_type = dst_span.type();
-            const void *fallback = attribute_fallbacks.array[attribute_index] == nullptr ?
-                                       cpp_type.default_value() :
-                                       attribute_fallbacks.array[attribute_index];
-            threaded_fill({cpp_type, fallback}, dst_span);
+            threaded_fill({cpp_type, fallback}, dst_span.slice(element_slice));
           }
         }
-      });
+        else {
+          const MutableSpan<T> dst = dst_span.typed<T>().slice(element_slice);
+          if (src.has_value()) {
+            threaded_copy(src->template typed<T>(), dst);
+          }
+          else {
+            threaded_fill(*static_cast<const T *>(fallback), dst);
+          }
+        }
+      }
+    });
+  }
 }
 
 static void create_result_ids(const RealizeInstancesOptions &options,
@@ -440,6 +541,98 @@ static void foreach_geometry_in_reference(
   }
 }
 
+static void add_pointcloud_task(GatherTasksInfo &gather_info,
+                                const PointCloudRealizeInfo &pointcloud_info,
+                                const float4x4 &transform,
+                                const InstanceContext &instance_context)
+{
+  gather_info.r_tasks.pointcloud_tasks.append({gather_info.r_offsets.pointcloud_offset,
+                                               &pointcloud_info,
+                                               transform,
+                                               instance_context.pointclouds,
+                                               instance_context.id});
+  gather_info.r_offsets.pointcloud_offset += pointcloud_info.pointcloud->totpoint;
+}
+
+static void add_mesh_task(GatherTasksInfo &gather_info,
+                          const MeshRealizeInfo &mesh_info,
+                          const float4x4 &transform,
+                          const InstanceContext &instance_context)
+{
+  const Mesh &mesh = *mesh_info.mesh;
+  gather_info.r_tasks.mesh_tasks.append({gather_info.r_offsets.mesh_offsets,
+                                         &mesh_info,
+                                         transform,
+                                         instance_context.meshes,
+                                         instance_context.id});
+  gather_info.r_offsets.mesh_offsets.vertex += mesh.totvert;
+  gather_info.r_offsets.mesh_offsets.edge += mesh.totedge;
+  gather_info.r_offsets.mesh_offsets.loop += mesh.totloop;
+  gather_info.r_offsets.mesh_offsets.poly += mesh.totpoly;
+}
+
+static void add_curve_task(GatherTasksInfo &gather_info,
+                           const RealizeCurveInfo &curve_info,
+                           const float4x4 &transform,
+                           const InstanceContext &instance_context)
+{
+  const Curves &curves = *curve_info.curves;
+  gather_info.r_tasks.curve_tasks.append({gather_info.r_offsets.curves_offsets,
+                                          &curve_info,
+                                          transform,
+                                          instance_context.curves,
+                                          instance_context.id});
+  gather_info.r_offsets.curves_offsets.point += curves.geometry.point_num;
+  gather_info.r_offsets.curves_offsets.curve += curves.geometry.curve_num;
+}
+
+/**
+ * Preprocessed geometry of an instance reference that does not contain nested instances. It is
+ * resolved once per reference instead of once per instance, which avoids the recursion and the
+ * lookups of the same geometry when there are many instances of few references.
+ */
+struct ReferenceRealizeInfo {
+  const PointCloudRealizeInfo *pointcloud_info = nullptr;
+  const MeshRealizeInfo *mesh_info = nullptr;
+  const RealizeCurveInfo *curve_info = nullptr;
+  /** When false, the reference has to be handled by #gather_realize_tasks_recursive. */
+  bool is_leaf = false;
+};
+
+static ReferenceRealizeInfo get_reference_realize_info(const GatherTasksInfo &gather_info,
+                                                       const InstanceReference &reference)
+{
+  ReferenceRealizeInfo info;
+  if (reference.type() != InstanceReference::Type::GeometrySet) {
+    return info;
+  }
+  const GeometrySet &geometry_set = reference.geometry_set();
+  if (geometry_set.has_instances() || geometry_set.has<VolumeComponent>() ||
+      geometry_set.has<GeometryComponentEditData>()) {
+    return info;
+  }
+  if (const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read()) {
+    if (pointcloud->totpoint > 0) {
+      const int pointcloud_index = gather_info.pointclouds.order.index_of(pointcloud);
+      info.pointcloud_info = &gather_info.pointclouds.realize_info[pointcloud_index];
+    }
+  }
+  if (const Mesh *mesh = geometry_set.get_mesh_for_read()) {
+    if (mesh->totvert > 0) {
+      const int mesh_index = gather_info.meshes.order.index_of(mesh);
+      info.mesh_info = &gather_info.meshes.realize_info[mesh_index];
+    }
+  }
+  if (const Curves *curves = geometry_set.get_curves_for_read()) {
+    if (curves->geometry.curve_num > 0) {
+      const int curve_index = gather_info.curves.order.index_of(curves);
+      info.curve_info = &gather_info.curves.realize_info[curve_index];
+    }
+  }
+  info.is_leaf = true;
+  return info;
+}
+
 static void gather_realize_tasks_for_instances(GatherTasksInfo &gather_info,
                                                const InstancesComponent &instances_component,
                                                const float4x4 &base_transform,
@@ -449,6 +642,11 @@ static void gather_realize_tasks_for_instances(GatherTasksInfo &gather_info,
   const Span<int> handles = instances_component.instance_reference_handles();
   const Span<float4x4> transforms = instances_component.instance_transforms();
 
+  Array<ReferenceRealizeInfo> reference_infos(references.size());
+  for (const int i : references.index_range()) {
+    reference_infos[i] = get_reference_realize_info(gather_info, references[i]);
+  }
+
   Span<int> stored_instance_ids;
   if (gather_info.create_id_attribute_on_any_component) {
     std::optional<GSpan> ids = instances_component.instance_attributes().get_for_read("id");
@@ -494,6 +692,24 @@ static void gather_realize_tasks_for_instances(GatherTasksInfo &gather_info,
     }
     const uint32_t instance_id = noise::hash(base_instance_context.id, local_instance_id);
 
+    const ReferenceRealizeInfo &reference_info = reference_infos[handle];
+    if (reference_info.is_leaf) {
+      instance_context.id = instance_id;
+      if (reference_info.pointcloud_info) {
+        add_pointcloud_task(
+            gather_info, *reference_info.pointcloud_info, new_base_transform, instance_context);
+      }
+      if (reference_info.mesh_info) {
+        add_mesh_task(
+            gather_info, *reference_info.mesh_info, new_base_transform, instance_context);
+      }
+      if (reference_info.curve_info) {
+        add_curve_task(
+            gather_info, *reference_info.curve_info, new_base_transform, instance_context);
+      }
+      continue;
+    }
+
     /* Add realize tasks for all referenced geometry sets recursively. */
     foreach_geometry_in_reference(reference,
                                   new_base_transform,
@@ -527,15 +743,7 @@ static void gather_realize_tasks_recursive(GatherTasksInfo &gather_info,
         if (mesh != nullptr && mesh->totvert > 0) {
           const int mesh_index = gather_info.meshes.order.index_of(mesh);
           const MeshRealizeInfo &mesh_info = gather_info.meshes.realize_info[mesh_index];
-          gather_info.r_tasks.mesh_tasks.append({gather_info.r_offsets.mesh_offsets,
-                                                 &mesh_info,
-                                                 base_transform,
-                                                 base_instance_context.meshes,
-                                                 base_instance_context.id});
-          gather_info.r_offsets.mesh_offsets.vertex += mesh->totvert;
-          gather_info.r_offsets.mesh_offsets.edge += mesh->totedge;
-          gather_info.r_offsets.mesh_offsets.loop += mesh->totloop;
-          gather_info.r_offsets.mesh_offsets.poly += mesh->totpoly;
+          add_mesh_task(gather_info, mesh_info, base_transform, base_instance_context);
         }
         break;
       }
@@ -547,12 +755,7 @@ static void gather_realize_tasks_recursive(GatherTasksInfo &gather_info,
           const int pointcloud_index = gather_info.pointclouds.order.index_of(pointcloud);
           const PointCloudRealizeInfo &pointcloud_info =
               gather_info.pointclouds.realize_info[pointcloud_index];
-          gather_info.r_tasks.pointcloud_tasks.append({gather_info.r_offsets.pointcloud_offset,
-                                                       &pointcloud_info,
-                                                       base_transform,
-                                                       base_instance_context.pointclouds,
-                                                       base_instance_context.id});
-          gather_info.r_offsets.pointcloud_offset += pointcloud->totpoint;
+          add_pointcloud_task(gather_info, pointcloud_info, base_transform, base_instance_context);
         }
         break;
       }
@@ -562,13 +765,7 @@ static void gather_realize_tasks_recursive(GatherTasksInfo &gather_info,
         if (curves != nullptr && curves->geometry.curve_num > 0) {
           const int curve_index = gather_info.curves.order.index_of(curves);
           const RealizeCurveInfo &curve_info = gather_info.curves.realize_info[curve_index];
-          gather_info.r_tasks.curve_tasks.append({gather_info.r_offsets.curves_offsets,
-                                                  &curve_info,
-                                                  base_transform,
-                                                  base_instance_context.curves,
-                                                  base_instance_context.id});
-          gather_info.r_offsets.curves_offsets.point += curves->geometry.point_num;
-          gather_info.r_offsets.curves_offsets.curve += curves->geometry.curve_num;
+          add_curve_task(gather_info, curve_info, base_transform, base_instance_context);
         }
         break;
       }
@@ -683,13 +880,10 @@ static AllPointCloudsInfo preprocess_pointclouds(const GeometrySet &geometry_set
   return info;
 }
 
-static void execute_realize_pointcloud_task(
-    const RealizeInstancesOptions &options,
-    const RealizePointCloudTask &task,
-    const OrderedAttributes &ordered_attributes,
-    MutableSpan<GSpanAttributeWriter> dst_attribute_writers,
-    MutableSpan<int> all_dst_ids,
-    MutableSpan<float3> all_dst_positions)
+static void execute_realize_pointcloud_task(const RealizeInstancesOptions &options,
+                                            const RealizePointCloudTask &task,
+                                            MutableSpan<int> all_dst_ids,
+                                            MutableSpan<float3> all_dst_positions)
 {
   const PointCloudRealizeInfo &pointcloud_info = *task.pointcloud_info;
   const PointCloud &pointcloud = *pointcloud_info.pointcloud;
@@ -703,17 +897,6 @@ static void execute_realize_pointcloud_task(
     create_result_ids(
         options, pointcloud_info.stored_ids, task.id, all_dst_ids.slice(point_slice));
   }
-
-  copy_generic_attributes_to_result(
-      pointcloud_info.attributes,
-      task.attribute_fallbacks,
-      ordered_attributes,
-      [&](const eAttrDomain domain) {
-        BLI_assert(domain == ATTR_DOMAIN_POINT);
-        UNUSED_VARS_NDEBUG(domain);
-        return point_slice;
-      },
-      dst_attribute_writers);
 }
 
 static void execute_realize_pointcloud_tasks(const RealizeInstancesOptions &options,
@@ -760,13 +943,20 @@ static void execute_realize_pointcloud_tasks(const RealizeInstancesOptions &opti
   threading::parallel_for(tasks.index_range(), 100, [&](const IndexRange task_range) {
     for (const int task_index : task_range) {
       const RealizePointCloudTask &task = tasks[task_index];
-      execute_realize_pointcloud_task(options,
-                                      task,
-                                      ordered_attributes,
-                                      dst_attribute_writers,
-                                      point_ids.span,
-                                      positions.span);
+      execute_realize_pointcloud_task(options, task, point_ids.span, positions.span);
     }
+    copy_generic_attributes_to_result(
+        tasks.slice(task_range),
+        [](const RealizePointCloudTask &task) {
+          return task.pointcloud_info->attributes.as_span();
+        },
+        ordered_attributes,
+        [](const RealizePointCloudTask &task, const eAttrDomain domain) {
+          BLI_assert(domain == ATTR_DOMAIN_POINT);
+          UNUSED_VARS_NDEBUG(domain);
+          return IndexRange(task.start_index, task.pointcloud_info->pointcloud->totpoint);
+        },
+        dst_attribute_writers);
   });
 
   /* Tag modified attributes. */
@@ -827,6 +1017,19 @@ static void gather_meshes_to_realize(const GeometrySet &geometry_set,
   }
 }
 
+/**
+ * Loose vertices get their normal from their position, which is why these normals can't be
+ * transformed like the others.
+ */
+static bool mesh_has_loose_vertices(const Mesh &mesh)
+{
+  Array<bool> used_vertices(mesh.totvert, false);
+  for (const MLoop &loop : Span<MLoop>(mesh.mloop, mesh.totloop)) {
+    used_vertices[loop.v] = true;
+  }
+  return used_vertices.as_span().contains(false);
+}
+
 static AllMeshesInfo preprocess_meshes(const GeometrySet &geometry_set,
                                        const RealizeInstancesOptions &options)
 {
@@ -873,16 +1076,29 @@ static AllMeshesInfo preprocess_meshes(const GeometrySet &geometry_set,
         mesh_info.stored_vertex_ids = ids_attribute.varray.get_internal_span().typed<int>();
       }
     }
+
+    /* Only use normals that don't have to be computed just for the realized mesh. */
+    if (!BKE_mesh_vertex_normals_are_dirty(mesh) && !BKE_mesh_poly_normals_are_dirty(mesh) &&
+        !mesh_has_loose_vertices(*mesh)) {
+      mesh_info.vertex_normals = {
+          reinterpret_cast<const float3 *>(BKE_mesh_vertex_normals_ensure(mesh)), mesh->totvert};
+      mesh_info.poly_normals = {
+          reinterpret_cast<const float3 *>(BKE_mesh_poly_normals_ensure(mesh)), mesh->totpoly};
+    }
   }
+  info.transfer_normals = std::all_of(
+      info.realize_info.begin(), info.realize_info.end(), [](const MeshRealizeInfo &mesh_info) {
+        return !mesh_info.vertex_normals.is_empty();
+      });
   return info;
 }
 
 static void execute_realize_mesh_task(const RealizeInstancesOptions &options,
                                       const RealizeMeshTask &task,
-                                      const OrderedAttributes &ordered_attributes,
                                       Mesh &dst_mesh,
-                                      MutableSpan<GSpanAttributeWriter> dst_attribute_writers,
-                                      MutableSpan<int> all_dst_vertex_ids)
+                                      MutableSpan<int> all_dst_vertex_ids,
+                                      MutableSpan<float3> all_dst_vertex_normals,
+                                      MutableSpan<float3> all_dst_poly_normals)
 {
   const MeshRealizeInfo &mesh_info = *task.mesh_info;
   const Mesh &mesh = *mesh_info.mesh;
@@ -904,7 +1120,7 @@ static void execute_realize_mesh_task(const RealizeInstancesOptions &options,
       const MVert &src_vert = src_verts[i];
       MVert &dst_vert = dst_verts[i];
       dst_vert = src_vert;
-      copy_v3_v3(dst_vert.co, task.transform * float3(src_vert.co));
+      copy_v3_v3(dst_vert.co, transform_position(task.transform, src_vert.co));
     }
   });
   threading::parallel_for(IndexRange(mesh.totedge), 1024, [&](const IndexRange edge_range) {
@@ -948,26 +1164,24 @@ static void execute_realize_mesh_task(const RealizeInstancesOptions &options,
                       all_dst_vertex_ids.slice(task.start_indices.vertex, mesh.totvert));
   }
 
-  copy_generic_attributes_to_result(
-      mesh_info.attributes,
-      task.attribute_fallbacks,
-      ordered_attributes,
-      [&](const eAttrDomain domain) {
-        switch (domain) {
-          case ATTR_DOMAIN_POINT:
-            return IndexRange(task.start_indices.vertex, mesh.totvert);
-          case ATTR_DOMAIN_EDGE:
-            return IndexRange(task.start_indices.edge, mesh.totedge);
-          case ATTR_DOMAIN_CORNER:
-            return IndexRange(task.start_indices.loop, mesh.totloop);
-          case ATTR_DOMAIN_FACE:
-            return IndexRange(task.start_indices.poly, mesh.totpoly);
-          default:
-            BLI_assert_unreachable();
-            return IndexRange();
-        }
-      },
-      dst_attribute_writers);
+  if (!all_dst_vertex_normals.is_empty()) {
+    const float sign = task.transform.is_negative() ? -1.0f : 1.0f;
+    MutableSpan<float3> dst_vertex_normals = all_dst_vertex_normals.slice(
+        task.start_indices.vertex, mesh.totvert);
+    MutableSpan<float3> dst_poly_normals = all_dst_poly_normals.slice(task.start_indices.poly,
+                                                                     mesh.totpoly);
+    threading::parallel_for(IndexRange(mesh.totvert), 1024, [&](const IndexRange vert_range) {
+      for (const int i : vert_range) {
+        dst_vertex_normals[i] = transform_normal(
+            task.transform, sign, mesh_info.vertex_normals[i]);
+      }
+    });
+    threading::parallel_for(IndexRange(mesh.totpoly), 1024, [&](const IndexRange poly_range) {
+      for (const int i : poly_range) {
+        dst_poly_normals[i] = transform_normal(task.transform, sign, mesh_info.poly_normals[i]);
+      }
+    });
+  }
 }
 
 static void execute_realize_mesh_tasks(const RealizeInstancesOptions &options,
@@ -1020,15 +1234,64 @@ static void execute_realize_mesh_tasks(const RealizeInstancesOptions &options,
         dst_attributes.lookup_or_add_for_write_only_span(attribute_id, domain, data_type));
   }
 
+  /* Prepare normals. They are only transformed when all transforms keep angles unchanged.
+   * Otherwise they stay dirty and are recomputed from the new positions when they are needed. */
+  std::atomic<bool> transfer_normals = all_meshes_info.transfer_normals;
+  MutableSpan<float3> vertex_normals;
+  MutableSpan<float3> poly_normals;
+  if (transfer_normals) {
+    vertex_normals = {reinterpret_cast<float3 *>(BKE_mesh_vertex_normals_for_write(dst_mesh)),
+                      tot_vertices};
+    poly_normals = {reinterpret_cast<float3 *>(BKE_mesh_poly_normals_for_write(dst_mesh)),
+                    tot_poly};
+  }
+
   /* Actually execute all tasks. */
   threading::parallel_for(tasks.index_range(), 100, [&](const IndexRange task_range) {
     for (const int task_index : task_range) {
       const RealizeMeshTask &task = tasks[task_index];
-      execute_realize_mesh_task(
-          options, task, ordered_attributes, *dst_mesh, dst_attribute_writers, vertex_ids.span);
+      bool transfer_task_normals = false;
+      if (transfer_normals.load(std::memory_order_relaxed)) {
+        transfer_task_normals = transform_preserves_angles(task.transform);
+        if (!transfer_task_normals) {
+          transfer_normals.store(false, std::memory_order_relaxed);
+        }
+      }
+      execute_realize_mesh_task(options,
+                                task,
+                                *dst_mesh,
+                                vertex_ids.span,
+                                transfer_task_normals ? vertex_normals : MutableSpan<float3>(),
+                                transfer_task_normals ? poly_normals : MutableSpan<float3>());
     }
+    copy_generic_attributes_to_result(
+        tasks.slice(task_range),
+        [](const RealizeMeshTask &task) { return task.mesh_info->attributes.as_span(); },
+        ordered_attributes,
+        [](const RealizeMeshTask &task, const eAttrDomain domain) {
+          const Mesh &mesh = *task.mesh_info->mesh;
+          switch (domain) {
+            case ATTR_DOMAIN_POINT:
+              return IndexRange(task.start_indices.vertex, mesh.totvert);
+            case ATTR_DOMAIN_EDGE:
+              return IndexRange(task.start_indices.edge, mesh.totedge);
+            case ATTR_DOMAIN_CORNER:
+              return IndexRange(task.start_indices.loop, mesh.totloop);
+            case ATTR_DOMAIN_FACE:
+              return IndexRange(task.start_indices.poly, mesh.totpoly);
+            default:
+              BLI_assert_unreachable();
+              return IndexRange();
+          }
+        },
+        dst_attribute_writers);
   });
 
+  if (transfer_normals) {
+    BKE_mesh_vertex_normals_clear_dirty(dst_mesh);
+    BKE_mesh_poly_normals_clear_dirty(dst_mesh);
+  }
+
   /* Tag modified attributes. */
   for (GSpanAttributeWriter &dst_attribute : dst_attribute_writers) {
     dst_attribute.finish();
@@ -1148,9 +1411,7 @@ static AllCurvesInfo preprocess_curves(const GeometrySet &geometry_set,
 static void execute_realize_curve_task(const RealizeInstancesOptions &options,
                                        const AllCurvesInfo &all_curves_info,
                                        const RealizeCurveTask &task,
-                                       const OrderedAttributes &ordered_attributes,
                                        bke::CurvesGeometry &dst_curves,
-                                       MutableSpan<GSpanAttributeWriter> dst_attribute_writers,
                                        MutableSpan<int> all_dst_ids,
                                        MutableSpan<float3> all_handle_left,
                                        MutableSpan<float3> all_handle_right,
@@ -1212,23 +1473,6 @@ static void execute_realize_curve_task(const RealizeInstancesOptions &options,
     create_result_ids(
         options, curves_info.stored_ids, task.id, all_dst_ids.slice(dst_point_range));
   }
-
-  copy_generic_attributes_to_result(
-      curves_info.attributes,
-      task.attribute_fallbacks,
-      ordered_attributes,
-      [&](const eAttrDomain domain) {
-        switch (domain) {
-          case ATTR_DOMAIN_POINT:
-            return IndexRange(task.start_indices.point, curves.points_num());
-          case ATTR_DOMAIN_CURVE:
-            return IndexRange(task.start_indices.curve, curves.curves_num());
-          default:
-            BLI_assert_unreachable();
-            return IndexRange();
-        }
-      },
-      dst_attribute_writers);
 }
 
 static void execute_realize_curve_tasks(const RealizeInstancesOptions &options,
@@ -1305,15 +1549,31 @@ static void execute_realize_curve_tasks(const RealizeInstancesOptions &options,
       execute_realize_curve_task(options,
                                  all_curves_info,
                                  task,
-                                 ordered_attributes,
                                  dst_curves,
-                                 dst_attribute_writers,
                                  point_ids.span,
                                  handle_left.span,
                                  handle_right.span,
                                  radius.span,
                                  resolution.span);
     }
+    copy_generic_attributes_to_result(
+        tasks.slice(task_range),
+        [](const RealizeCurveTask &task) { return task.curve_info->attributes.as_span(); },
+        ordered_attributes,
+        [](const RealizeCurveTask &task, const eAttrDomain domain) {
+          const bke::CurvesGeometry &curves = bke::CurvesGeometry::wrap(
+              task.curve_info->curves->geometry);
+          switch (domain) {
+            case ATTR_DOMAIN_POINT:
+              return IndexRange(task.start_indices.point, curves.points_num());
+            case ATTR_DOMAIN_CURVE:
+              return IndexRange(task.start_indices.curve, curves.curves_num());
+            default:
+              BLI_assert_unreachable();
+              return IndexRange();
+          }
+        },
+        dst_attribute_writers);
   });
 
   /* Type counts have to be updated eagerly. */
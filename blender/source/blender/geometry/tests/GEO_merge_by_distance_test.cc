@@ -0,0 +1,352 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_kdtree.h"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "GEO_mesh_merge_by_distance.hh"
+#include "GEO_point_merge_by_distance.hh"
+
+namespace blender::geometry::tests {
+
+/* Points on a jittered lattice, where every lattice point is used multiple times in random order,
+ * so that there are clusters of points within the merge distance. */
+static Array<float3> random_lattice_points(const int size, const int duplicates, const int seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float3> positions(size);
+  const int lattice_size = size / duplicates;
+  const int resolution = int(std::cbrt(float(lattice_size))) + 1;
+  for (const int i : positions.index_range()) {
+    const int lattice_i = int(rng.get_float() * lattice_size) % lattice_size;
+    const float3 lattice_position(lattice_i % resolution,
+                                  (lattice_i / resolution) % resolution,
+                                  lattice_i / (resolution * resolution));
+    positions[i] = lattice_position + float3(rng.get_float(), rng.get_float(), rng.get_float()) *
+                                          0.2f;
+  }
+  return positions;
+}
+
+static Array<int> kdtree_merge_indices(Span<float3> positions,
+                                       const float merge_distance,
+                                       const bool use_index_order)
+{
+  KDTree_3d *tree = BLI_kdtree_3d_new(positions.size());
+  for (const int i : positions.index_range()) {
+    BLI_kdtree_3d_insert(tree, i, positions[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+  Array<int> merge_indices(positions.size(), -1);
+  BLI_kdtree_3d_calc_duplicates_fast(tree, merge_distance, use_index_order, merge_indices.data());
+  BLI_kdtree_3d_free(tree);
+  return merge_indices;
+}
+
+TEST(merge_by_distance, MatchesKDTree)
+{
+  const Array<float3> positions = random_lattice_points(100000, 4, 0);
+  const float merge_distance = 0.25f;
+
+  Array<int> merge_indices(positions.size(), -1);
+  const int merged_num = find_merge_targets(
+      VArray<float3>::ForSpan(positions), IndexMask(positions.size()), merge_distance, merge_indices);
+  const Array<int> expected = kdtree_merge_indices(positions, merge_distance, false);
+
+  EXPECT_GT(merged_num, 0);
+  EXPECT_EQ(merge_indices.as_span(), expected.as_span());
+}
+
+TEST(merge_by_distance, Selection)
+{
+  const Array<float3> positions = random_lattice_points(20000, 3, 1);
+  const float merge_distance = 0.3f;
+
+  Vector<int64_t> selection;
+  Vector<float3> selected_positions;
+  for (const int i : positions.index_range()) {
+    if (i % 3 != 0) {
+      selection.append(i);
+      selected_positions.append(positions[i]);
+    }
+  }
+
+  Array<int> merge_indices(positions.size(), -1);
+  find_merge_targets(
+      VArray<float3>::ForSpan(positions), selection.as_span(), merge_distance, merge_indices);
+  const Array<int> expected = kdtree_merge_indices(selected_positions, merge_distance, false);
+
+  for (const int i : selection.index_range()) {
+    const int expected_index = expected[i] == -1 ? -1 : int(selection[expected[i]]);
+    EXPECT_EQ(merge_indices[selection[i]], expected_index);
+  }
+  /* Unselected points are not changed. */
+  for (int i = 0; i < positions.size(); i += 3) {
+    EXPECT_EQ(merge_indices[i], -1);
+  }
+}
+
+TEST(merge_by_distance, ZeroDistance)
+{
+  const Array<float3> positions = {
+      float3(0, 0, 0), float3(1, 0, 0), float3(0, 0, 0), float3(1, 0, 0), float3(2, 0, 0)};
+
+  Array<int> merge_indices(positions.size(), -1);
+  const int merged_num = find_merge_targets(
+      VArray<float3>::ForSpan(positions), IndexMask(positions.size()), 0.0f, merge_indices);
+
+  /* The KD tree doesn't find these, because it skips nodes at exactly the merge distance along
+   * their split axis. */
+  EXPECT_EQ(merged_num, 2);
+  EXPECT_EQ(merge_indices[0], merge_indices[2]);
+  EXPECT_EQ(merge_indices[1], merge_indices[3]);
+  EXPECT_NE(merge_indices[0], -1);
+  EXPECT_NE(merge_indices[1], -1);
+  EXPECT_EQ(merge_indices[4], -1);
+}
+
+/* Points on a regular grid with the merge distance as spacing, far from the origin, so that many
+ * pairs are at the merge distance up to rounding errors. Rounding the grid coordinates must not make
+ * any of them miss each other. */
+TEST(merge_by_distance, GridSpacingDistance)
+{
+  const float merge_distance = 0.1f;
+  const int resolution = 12;
+  Array<float3> positions(resolution * resolution * resolution);
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(1000.3f, -500.7f, 20.1f) +
+                   float3(i % resolution, (i / resolution) % resolution, i / resolution / resolution) *
+                       merge_distance;
+  }
+
+  Array<int> merge_indices(positions.size(), -1);
+  const int merged_num = find_merge_targets(
+      VArray<float3>::ForSpan(positions), IndexMask(positions.size()), merge_distance, merge_indices);
+
+  /* Merge greedily in the same order, checking the distance to all other points. */
+  Array<int> order(positions.size());
+  KDTree_3d *tree = BLI_kdtree_3d_new(positions.size());
+  for (const int i : positions.index_range()) {
+    BLI_kdtree_3d_insert(tree, i, positions[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+  BLI_kdtree_3d_calc_node_order(tree, order.data());
+  BLI_kdtree_3d_free(tree);
+  Array<int> expected(positions.size(), -1);
+  int expected_merged_num = 0;
+  for (const int i : order) {
+    if (expected[i] != -1) {
+      continue;
+    }
+    for (const int j : positions.index_range()) {
+      if (j != i && expected[j] == -1 &&
+          math::distance_squared(positions[i], positions[j]) <= merge_distance * merge_distance) {
+        expected[j] = i;
+        expected[i] = i;
+        expected_merged_num++;
+      }
+    }
+  }
+
+  EXPECT_GT(merged_num, 0);
+  EXPECT_EQ(merged_num, expected_merged_num);
+  EXPECT_EQ(merge_indices.as_span(), expected.as_span());
+}
+
+class MergeByDistanceMeshTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+  static Mesh *create_edge_mesh(Span<float3> positions, Span<int2> edges)
+  {
+    Mesh *mesh = BKE_mesh_new_nomain(positions.size(), edges.size(), 0, 0, 0);
+    for (const int i : positions.index_range()) {
+      copy_v3_v3(mesh->mvert[i].co, positions[i]);
+    }
+    for (const int i : edges.index_range()) {
+      mesh->medge[i].v1 = edges[i].x;
+      mesh->medge[i].v2 = edges[i].y;
+    }
+    return mesh;
+  }
+};
+
+TEST_F(MergeByDistanceMeshTest, Connected)
+{
+  /* The last vertex is close to the first, but not connected to it. */
+  const Array<float3> positions = {float3(0.0f, 0, 0),
+                                   float3(0.05f, 0, 0),
+                                   float3(0.1f, 0, 0),
+                                   float3(1.0f, 0, 0),
+                                   float3(1.05f, 0, 0),
+                                   float3(0.01f, 0, 0)};
+  const Array<int2> edges = {int2(0, 1), int2(1, 2), int2(2, 3), int2(3, 4)};
+  Mesh *mesh = create_edge_mesh(positions, edges);
+
+  /* The center of the first two vertices is too far from the third after merging them. */
+  std::optional<Mesh *> result = mesh_merge_by_distance_connected(*mesh, {}, 0.06f, false);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((*result)->totvert, 4);
+  EXPECT_EQ((*result)->totedge, 2);
+  EXPECT_V3_NEAR((*result)->mvert[0].co, float3(0.025f, 0, 0), 1e-6f);
+  EXPECT_V3_NEAR((*result)->mvert[1].co, float3(0.1f, 0, 0), 1e-6f);
+  EXPECT_V3_NEAR((*result)->mvert[2].co, float3(1.025f, 0, 0), 1e-6f);
+  EXPECT_V3_NEAR((*result)->mvert[3].co, float3(0.01f, 0, 0), 1e-6f);
+  BKE_id_free(nullptr, *result);
+
+  /* Unselected vertices are not merged. */
+  const Array<bool> selection = {true, true, true, true, false, true};
+  result = mesh_merge_by_distance_connected(*mesh, selection, 0.06f, false);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((*result)->totvert, 5);
+  BKE_id_free(nullptr, *result);
+
+  /* Only the loose edges are collapsed. */
+  mesh->medge[3].flag |= ME_LOOSEEDGE;
+  result = mesh_merge_by_distance_connected(*mesh, {}, 0.06f, true);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ((*result)->totvert, 5);
+  BKE_id_free(nullptr, *result);
+
+  EXPECT_FALSE(mesh_merge_by_distance_connected(*mesh, {}, 0.01f, false).has_value());
+
+  BKE_id_free(nullptr, mesh);
+}
+
+/**
+ * The cluster roots of the connected merging, as they were found before it used path halving.
+ * Vertices that are not merged get -1.
+ */
+static Array<int> connected_merge_roots_reference(Span<float3> positions,
+                                                  Span<int2> edges,
+                                                  const float merge_distance)
+{
+  Array<int> dest_map(positions.size());
+  Array<float3> cluster_positions(positions);
+  Array<int> merged_num(positions.size(), 0);
+  for (const int i : dest_map.index_range()) {
+    dest_map[i] = i;
+  }
+  for (const int2 &edge : edges) {
+    int v1 = edge.x;
+    int v2 = edge.y;
+    while (v1 != dest_map[v1]) {
+      v1 = dest_map[v1];
+    }
+    while (v2 != dest_map[v2]) {
+      v2 = dest_map[v2];
+    }
+    if (v1 == v2) {
+      continue;
+    }
+    if (v1 > v2) {
+      std::swap(v1, v2);
+    }
+    const float3 edge_dir = cluster_positions[v2] - cluster_positions[v1];
+    if (math::length_squared(edge_dir) <= merge_distance * merge_distance) {
+      const float influence = (merged_num[v2] + 1) / float(merged_num[v1] + merged_num[v2] + 2);
+      cluster_positions[v1] += edge_dir * influence;
+      merged_num[v1] += merged_num[v2] + 1;
+      dest_map[v2] = v1;
+    }
+  }
+  Array<int> roots(positions.size());
+  for (const int i : roots.index_range()) {
+    int v = i;
+    while (v != dest_map[v]) {
+      v = dest_map[v];
+    }
+    roots[i] = (v == i && merged_num[i] == 0) ? -1 : v;
+  }
+  return roots;
+}
+
+TEST_F(MergeByDistanceMeshTest, ConnectedMatchesReference)
+{
+  /* Rows of vertices that are connected to their neighbors and to random other vertices, so that
+   * large clusters with long paths to their roots are built. */
+  RandomNumberGenerator rng(4);
+  const int verts_num = 5000;
+  const float merge_distance = 0.015f;
+  Array<float3> positions(verts_num);
+  for (const int i : positions.index_range()) {
+    positions[i] = float3((i % 500) * 0.01f, (i / 500) * 0.1f, 0) +
+                   float3(rng.get_float(), rng.get_float(), rng.get_float()) * 0.004f;
+  }
+  Vector<int2> edges;
+  for (const int i : IndexRange(verts_num - 1)) {
+    edges.append(int2(i, i + 1));
+    const int other = rng.get_int32(verts_num);
+    if (other != i) {
+      edges.append(int2(other, i));
+    }
+  }
+  Mesh *mesh = create_edge_mesh(positions, edges);
+
+  const Array<int> roots = connected_merge_roots_reference(positions, edges, merge_distance);
+  std::optional<Mesh *> result = mesh_merge_by_distance_connected(
+      *mesh, {}, merge_distance, false);
+  ASSERT_TRUE(result.has_value());
+
+  /* Every cluster is welded into a vertex at the position of its root, at the average of the
+   * positions of the cluster. */
+  Array<float3> position_sums(verts_num, float3(0));
+  Array<int> counts(verts_num, 0);
+  for (const int i : roots.index_range()) {
+    const int root = roots[i] == -1 ? i : roots[i];
+    position_sums[root] += positions[i];
+    counts[root]++;
+  }
+  Vector<float3> expected_positions;
+  for (const int i : roots.index_range()) {
+    if (counts[i] > 0) {
+      expected_positions.append(position_sums[i] / float(counts[i]));
+    }
+  }
+  ASSERT_EQ((*result)->totvert, int(expected_positions.size()));
+  EXPECT_LT(expected_positions.size(), verts_num / 2);
+  for (const int i : expected_positions.index_range()) {
+    EXPECT_V3_NEAR((*result)->mvert[i].co, expected_positions[i], 1e-5f);
+  }
+
+  BKE_id_free(nullptr, *result);
+  BKE_id_free(nullptr, mesh);
+}
+
+#if 0
+TEST(merge_by_distance, Benchmark)
+{
+  const Array<float3> positions = random_lattice_points(4'000'000, 2, 2);
+  const float merge_distance = 0.25f;
+
+  Array<int> merge_indices(positions.size(), -1);
+  {
+    SCOPED_TIMER("spatial hash");
+    find_merge_targets(VArray<float3>::ForSpan(positions),
+                       IndexMask(positions.size()),
+                       merge_distance,
+                       merge_indices);
+  }
+  {
+    SCOPED_TIMER("kd tree");
+    kdtree_merge_indices(positions, merge_distance, false);
+  }
+}
+#endif /* Benchmark */
+
+}  // namespace blender::geometry::tests
@@ -0,0 +1,128 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_float4x4.hh"
+#include "BLI_math_vector.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "GEO_realize_instances.hh"
+
+namespace blender::geometry::tests {
+
+class RealizeInstancesNormalsTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+
+  /** An irregular tetrahedron with computed normals and no loose vertices. */
+  static Mesh *create_tetrahedron()
+  {
+    const float3 positions[4] = {
+        float3(0, 0, 0), float3(1.3f, 0.1f, 0), float3(0.2f, 0.9f, 0.1f), float3(0.4f, 0.3f, 1.1f)};
+    const int corners[4][3] = {{0, 2, 1}, {0, 1, 3}, {1, 2, 3}, {0, 3, 2}};
+
+    Mesh *mesh = BKE_mesh_new_nomain(4, 0, 0, 12, 4);
+    for (const int i : IndexRange(4)) {
+      copy_v3_v3(mesh->mvert[i].co, positions[i]);
+      mesh->mpoly[i].loopstart = i * 3;
+      mesh->mpoly[i].totloop = 3;
+      for (const int j : IndexRange(3)) {
+        mesh->mloop[i * 3 + j].v = corners[i][j];
+      }
+    }
+    BKE_mesh_calc_edges(mesh, false, false);
+    BKE_mesh_vertex_normals_ensure(mesh);
+    BKE_mesh_poly_normals_ensure(mesh);
+    return mesh;
+  }
+
+  static GeometrySet realize_tetrahedron_instances(Span<float4x4> transforms)
+  {
+    GeometrySet instances_geometry;
+    InstancesComponent &instances =
+        instances_geometry.get_component_for_write<InstancesComponent>();
+    const int handle = instances.add_reference(
+        GeometrySet::create_with_mesh(create_tetrahedron()));
+    for (const float4x4 &transform : transforms) {
+      instances.add_instance(handle, transform);
+    }
+    return realize_instances(std::move(instances_geometry), RealizeInstancesOptions());
+  }
+
+  /** Compare the normals of the mesh with normals computed from its positions. */
+  static void expect_normals_match_recomputed(const Mesh &mesh)
+  {
+    Mesh *recomputed = BKE_mesh_copy_for_eval(&mesh, false);
+    BKE_mesh_normals_tag_dirty(recomputed);
+
+    const Span<float3> vertex_normals{
+        reinterpret_cast<const float3 *>(BKE_mesh_vertex_normals_ensure(&mesh)), mesh.totvert};
+    const Span<float3> expected_vertex_normals{
+        reinterpret_cast<const float3 *>(BKE_mesh_vertex_normals_ensure(recomputed)),
+        recomputed->totvert};
+    for (const int i : vertex_normals.index_range()) {
+      EXPECT_V3_NEAR(vertex_normals[i], expected_vertex_normals[i], 1e-5f);
+    }
+
+    const Span<float3> poly_normals{
+        reinterpret_cast<const float3 *>(BKE_mesh_poly_normals_ensure(&mesh)), mesh.totpoly};
+    const Span<float3> expected_poly_normals{
+        reinterpret_cast<const float3 *>(BKE_mesh_poly_normals_ensure(recomputed)),
+        recomputed->totpoly};
+    for (const int i : poly_normals.index_range()) {
+      EXPECT_V3_NEAR(poly_normals[i], expected_poly_normals[i], 1e-5f);
+    }
+
+    BKE_id_free(nullptr, recomputed);
+  }
+};
+
+TEST_F(RealizeInstancesNormalsTest, TransferredNormals)
+{
+  const Array<float4x4> transforms = {
+      /* Rotated. */
+      float4x4::from_loc_eul_scale(float3(1, 2, 3), float3(0.3f, 1.1f, -0.7f), float3(1)),
+      /* Rotated and uniformly scaled. */
+      float4x4::from_loc_eul_scale(float3(-4, 0, 1), float3(-1.2f, 0.4f, 2.5f), float3(2.5f)),
+      /* Mirrored along one axis. */
+      float4x4::from_loc_eul_scale(float3(0, 5, 0), float3(0), float3(-1.5f, 1.5f, 1.5f)),
+      /* Rotated and mirrored along all axes. */
+      float4x4::from_loc_eul_scale(float3(0, 0, -2), float3(0.8f, 0, 0.2f), float3(-0.5f)),
+  };
+  const GeometrySet realized = realize_tetrahedron_instances(transforms);
+  const Mesh *mesh = realized.get_mesh_for_read();
+  ASSERT_NE(mesh, nullptr);
+  EXPECT_EQ(mesh->totvert, 4 * transforms.size());
+
+  EXPECT_FALSE(BKE_mesh_vertex_normals_are_dirty(mesh));
+  EXPECT_FALSE(BKE_mesh_poly_normals_are_dirty(mesh));
+  expect_normals_match_recomputed(*mesh);
+}
+
+TEST_F(RealizeInstancesNormalsTest, NonUniformScaleFallback)
+{
+  const Array<float4x4> transforms = {
+      float4x4::from_loc_eul_scale(float3(1, 2, 3), float3(0.3f, 1.1f, -0.7f), float3(1)),
+      float4x4::from_loc_eul_scale(float3(0, 5, 0), float3(0.5f, 0, 0), float3(1, 3, 0.5f)),
+  };
+  const GeometrySet realized = realize_tetrahedron_instances(transforms);
+  const Mesh *mesh = realized.get_mesh_for_read();
+  ASSERT_NE(mesh, nullptr);
+
+  /* A single transform that changes angles means that the normals are recomputed lazily. */
+  EXPECT_TRUE(BKE_mesh_vertex_normals_are_dirty(mesh));
+  EXPECT_TRUE(BKE_mesh_poly_normals_are_dirty(mesh));
+  expect_normals_match_recomputed(*mesh);
+}
+
+}  // namespace blender::geometry::tests
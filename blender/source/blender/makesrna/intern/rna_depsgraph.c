@@ -4,6 +4,7 @@
  * \ingroup RNA
  */
 
+#include <float.h>
 #include <stdlib.h>
 
 #include "BLI_path_util.h"
@@ -257,6 +258,18 @@ static void rna_Depsgraph_debug_stats(Depsgraph *depsgraph, char *result)
                outer);
 }
 
+static void rna_Depsgraph_debug_build_time(Depsgraph *depsgraph,
+                                           float *r_nodes,
+                                           float *r_relations,
+                                           float *r_finalize)
+{
+  double nodes, relations, finalize;
+  DEG_stats_build_time(depsgraph, &nodes, &relations, &finalize);
+  *r_nodes = (float)nodes;
+  *r_relations = (float)relations;
+  *r_finalize = (float)finalize;
+}
+
 static void rna_Depsgraph_update(Depsgraph *depsgraph, Main *bmain, ReportList *reports)
 {
   if (DEG_is_evaluating(depsgraph)) {
@@ -662,6 +675,16 @@ static void rna_def_depsgraph(BlenderRNA *brna)
   RNA_def_parameter_flags(parm, PROP_THICK_WRAP, 0); /* needed for string return value */
   RNA_def_function_output(func, parm);
 
+  func = RNA_def_function(srna, "debug_build_time", "rna_Depsgraph_debug_build_time");
+  RNA_def_function_ui_description(
+      func, "Report the time spent in the steps of the last relations build, in seconds");
+  parm = RNA_def_float(func, "nodes", 0.0f, 0.0f, FLT_MAX, "Nodes", "", 0.0f, FLT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_float(func, "relations", 0.0f, 0.0f, FLT_MAX, "Relations", "", 0.0f, FLT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_float(func, "finalize", 0.0f, 0.0f, FLT_MAX, "Finalize", "", 0.0f, FLT_MAX);
+  RNA_def_function_output(func, parm);
+
   /* Updates. */
 
   func = RNA_def_function(srna, "update", "rna_Depsgraph_update");
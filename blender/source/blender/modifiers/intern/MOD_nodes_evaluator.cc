@@ -2,6 +2,7 @@
 
 #include "MOD_nodes_evaluator.hh"
 
+#include "BKE_global.h"
 #include "BKE_type_conversions.hh"
 
 #include "NOD_geometry_exec.hh"
@@ -9,6 +10,8 @@
 
 #include "DEG_depsgraph_query.h"
 
+#include "DNA_object_types.h"
+
 #include "FN_field.hh"
 #include "FN_field_cpp_type.hh"
 #include "FN_multi_function.hh"
@@ -23,6 +26,7 @@
 #include "BLI_vector_set.hh"
 
 #include <chrono>
+#include <cstdio>
 
 namespace blender::modifiers::geometry_nodes {
 
@@ -400,9 +404,25 @@ static bool node_supports_laziness(const DNode node)
   return node->typeinfo()->geometry_node_execute_supports_laziness;
 }
 
+/**
+ * Nodes without a geometry execute callback are multi-function nodes (or nodes that are not
+ * supported). The evaluator only builds fields with them or calls them for a single value, which
+ * is much cheaper than passing them through the task pool.
+ */
+static bool node_is_cheap(const DNode node)
+{
+  return node->typeinfo()->geometry_node_execute == nullptr;
+}
+
 struct NodeTaskRunState {
   /** The node that should be run on the same thread after the current node finished. */
   DNode next_node_to_run;
+  /**
+   * Cheap nodes that became ready while running the current node. They are run on the same
+   * thread before #next_node_to_run, so that chains of field nodes don't go through the task
+   * pool for every node.
+   */
+  Vector<DNode, 8> cheap_nodes_to_run;
 };
 
 /** Implements the callbacks that might be called when a node is executed. */
@@ -465,18 +485,31 @@ class GeometryNodesEvaluator {
   GeometryNodesEvaluationParams &params_;
   const blender::bke::DataTypeConversions &conversions_;
 
+  /**
+   * Execution time of every node run, gathered to print a summary when the evaluation is done.
+   * Only used with `--debug-depsgraph-time`, the node editor gets the times from the logger.
+   */
+  bool print_execution_times_;
+  threading::EnumerableThreadSpecific<Vector<std::pair<DNode, std::chrono::nanoseconds>>>
+      execution_times_;
+
   friend NodeParamsProvider;
 
+  using Clock = std::chrono::steady_clock;
+
  public:
   GeometryNodesEvaluator(GeometryNodesEvaluationParams &params)
       : outer_allocator_(params.allocator),
         params_(params),
-        conversions_(blender::bke::get_implicit_type_conversions())
+        conversions_(blender::bke::get_implicit_type_conversions()),
+        print_execution_times_(G.debug & G_DEBUG_DEPSGRAPH_TIME)
   {
   }
 
   void execute()
   {
+    const Clock::time_point begin = Clock::now();
+
     task_pool_ = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
 
     this->create_states_for_reachable_nodes();
@@ -489,6 +522,45 @@ class GeometryNodesEvaluator {
 
     this->extract_group_outputs();
     this->destruct_node_states();
+
+    if (print_execution_times_) {
+      this->print_execution_times(Clock::now() - begin);
+    }
+  }
+
+  void print_execution_times(const Clock::duration total_time)
+  {
+    Map<DNode, std::chrono::nanoseconds> time_by_node;
+    int executions_num = 0;
+    for (const Vector<std::pair<DNode, std::chrono::nanoseconds>> &times : execution_times_) {
+      for (const std::pair<DNode, std::chrono::nanoseconds> &item : times) {
+        time_by_node.lookup_or_add(item.first, std::chrono::nanoseconds::zero()) += item.second;
+      }
+      executions_num += times.size();
+    }
+
+    Vector<std::pair<DNode, std::chrono::nanoseconds>> sorted_times;
+    for (const auto item : time_by_node.items()) {
+      sorted_times.append({item.key, item.value});
+    }
+    std::sort(sorted_times.begin(), sorted_times.end(), [](const auto &a, const auto &b) {
+      return a.second > b.second;
+    });
+
+    printf("Geometry nodes \"%s\" on \"%s\": %.3f ms, %d of %d nodes executed (%d runs)\n",
+           params_.modifier_->modifier.name,
+           params_.self_object->id.name + 2,
+           std::chrono::duration<double, std::milli>(total_time).count(),
+           int(time_by_node.size()),
+           int(node_states_.size()),
+           executions_num);
+    const int nodes_to_print = std::min<int>(sorted_times.size(), 10);
+    for (const std::pair<DNode, std::chrono::nanoseconds> &item :
+         sorted_times.as_span().take_front(nodes_to_print)) {
+      printf("  %10.3f ms  %s\n",
+             std::chrono::duration<double, std::milli>(item.second).count(),
+             item.first->name().c_str());
+    }
   }
 
   void create_states_for_reachable_nodes()
@@ -744,11 +816,21 @@ class GeometryNodesEvaluator {
      * - Helps with cpu cache efficiency, because a thread is more likely to process data that it
      *   has processed shortly before.
      */
-    DNode next_node_to_run = root_node_with_state->node;
-    while (next_node_to_run) {
-      NodeTaskRunState run_state;
-      evaluator.node_task_run(next_node_to_run, &run_state);
-      next_node_to_run = run_state.next_node_to_run;
+    NodeTaskRunState run_state;
+    run_state.next_node_to_run = root_node_with_state->node;
+    while (true) {
+      DNode node_to_run;
+      if (!run_state.cheap_nodes_to_run.is_empty()) {
+        node_to_run = run_state.cheap_nodes_to_run.pop_last();
+      }
+      else if (run_state.next_node_to_run) {
+        node_to_run = run_state.next_node_to_run;
+        run_state.next_node_to_run = {};
+      }
+      else {
+        break;
+      }
+      evaluator.node_task_run(node_to_run, &run_state);
     }
   }
 
@@ -959,37 +1041,45 @@ class GeometryNodesEvaluator {
     }
     node_state.has_been_executed = true;
 
-    /* Use the geometry node execute callback if it exists. */
+    const Clock::time_point begin = Clock::now();
+
     if (bnode.typeinfo->geometry_node_execute != nullptr) {
+      /* Use the geometry node execute callback if it exists. */
       this->execute_geometry_node(node, node_state, run_state);
-      return;
     }
-
-    /* Use the multi-function implementation if it exists. */
-    const nodes::NodeMultiFunctions::Item &fn_item = params_.mf_by_node->try_get(node);
-    if (fn_item.fn != nullptr) {
-      this->execute_multi_function_node(node, fn_item, node_state, run_state);
-      return;
+    else {
+      /* Use the multi-function implementation if it exists. */
+      const nodes::NodeMultiFunctions::Item &fn_item = params_.mf_by_node->try_get(node);
+      if (fn_item.fn != nullptr) {
+        this->execute_multi_function_node(node, fn_item, node_state, run_state);
+      }
+      else {
+        this->execute_unknown_node(node, node_state, run_state);
+      }
     }
 
-    this->execute_unknown_node(node, node_state, run_state);
+    this->log_execution_time(node, Clock::now() - begin);
+  }
+
+  void log_execution_time(const DNode node, const Clock::duration duration)
+  {
+    if (params_.geo_logger != nullptr) {
+      params_.geo_logger->local().log_execution_time(
+          node, std::chrono::duration_cast<std::chrono::microseconds>(duration));
+    }
+    if (print_execution_times_) {
+      execution_times_.local().append(
+          {node, std::chrono::duration_cast<std::chrono::nanoseconds>(duration)});
+    }
   }
 
   void execute_geometry_node(const DNode node, NodeState &node_state, NodeTaskRunState *run_state)
   {
-    using Clock = std::chrono::steady_clock;
     const bNode &bnode = *node->bnode();
 
     NodeParamsProvider params_provider{*this, node, node_state, run_state};
     GeoNodeExecParams params{params_provider};
-    Clock::time_point begin = Clock::now();
     bnode.typeinfo->geometry_node_execute(params);
-    Clock::time_point end = Clock::now();
-    const std::chrono::microseconds duration =
-        std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
-    if (params_.geo_logger != nullptr) {
-      params_.geo_logger->local().log_execution_time(node, duration);
-    }
   }
 
   void execute_multi_function_node(const DNode node,
@@ -1724,7 +1814,11 @@ class GeometryNodesEvaluator {
       this->send_output_unused_notification(socket, run_state);
     }
     for (const DNode &node_to_schedule : locked_node.delayed_scheduled_nodes) {
-      if (run_state != nullptr && !run_state->next_node_to_run) {
+      if (run_state != nullptr && node_is_cheap(node_to_schedule)) {
+        /* Running the node costs less than scheduling it in the task pool. */
+        run_state->cheap_nodes_to_run.append(node_to_schedule);
+      }
+      else if (run_state != nullptr && !run_state->next_node_to_run) {
         /* Execute the node on the same thread after the current node finished. */
         /* Currently, this assumes that it is always best to run the first node that is scheduled
          * on the same thread. That is usually correct, because the geometry socket which carries
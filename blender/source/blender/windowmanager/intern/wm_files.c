@@ -1721,6 +1721,7 @@ static bool wm_file_write(bContext *C,
                           const char *filepath,
                           int fileflags,
                           eBLO_WritePathRemap remap_mode,
+                          eBLO_WriteCompressionProfile compression_profile,
                           bool use_save_as_copy,
                           ReportList *reports)
 {
@@ -1833,6 +1834,7 @@ static bool wm_file_write(bContext *C,
                      fileflags,
                      &(const struct BlendFileWriteParams){
                          .remap_mode = remap_mode,
+                         .compression_profile = compression_profile,
                          .use_save_versions = true,
                          .use_save_as_copy = use_save_as_copy,
                          .thumb = thumb,
@@ -3009,6 +3011,21 @@ static void wm_filepath_default(const Main *bmain, char *filepath)
   }
 }
 
+static const EnumPropertyItem save_compression_profile_items[] = {
+    {BLO_WRITE_COMPRESSION_DEFAULT,
+     "DEFAULT",
+     0,
+     "Default",
+     "Balance the saving time and the file size"},
+    {BLO_WRITE_COMPRESSION_FAST, "FAST", 0, "Fast", "Save faster, making larger files"},
+    {BLO_WRITE_COMPRESSION_ARCHIVAL,
+     "ARCHIVAL",
+     0,
+     "Archival",
+     "Make the smallest files, saving is considerably slower"},
+    {0, NULL, 0, NULL, NULL},
+};
+
 static void save_set_compress(wmOperator *op)
 {
   PropertyRNA *prop;
@@ -3109,7 +3126,11 @@ static int wm_save_as_mainfile_exec(bContext *C, wmOperator *op)
   /* set compression flag */
   SET_FLAG_FROM_TEST(fileflags, RNA_boolean_get(op->ptr, "compress"), G_FILE_COMPRESS);
 
-  const bool ok = wm_file_write(C, path, fileflags, remap_mode, use_save_as_copy, op->reports);
+  const eBLO_WriteCompressionProfile compression_profile = RNA_enum_get(op->ptr,
+                                                                       "compression_profile");
+
+  const bool ok = wm_file_write(
+      C, path, fileflags, remap_mode, compression_profile, use_save_as_copy, op->reports);
 
   if ((op->flag & OP_IS_INVOKE) == 0) {
     /* OP_IS_INVOKE is set when the operator is called from the GUI.
@@ -3188,6 +3209,12 @@ void WM_OT_save_as_mainfile(wmOperatorType *ot)
                                  FILE_DEFAULTDISPLAY,
                                  FILE_SORT_DEFAULT);
   RNA_def_boolean(ot->srna, "compress", false, "Compress", "Write compressed .blend file");
+  RNA_def_enum(ot->srna,
+               "compression_profile",
+               save_compression_profile_items,
+               BLO_WRITE_COMPRESSION_DEFAULT,
+               "Compression Profile",
+               "Trade-off between saving time and file size of compressed files");
   RNA_def_boolean(ot->srna,
                   "relative_remap",
                   true,
@@ -3259,6 +3286,12 @@ void WM_OT_save_mainfile(wmOperatorType *ot)
                                  FILE_DEFAULTDISPLAY,
                                  FILE_SORT_DEFAULT);
   RNA_def_boolean(ot->srna, "compress", false, "Compress", "Write compressed .blend file");
+  RNA_def_enum(ot->srna,
+               "compression_profile",
+               save_compression_profile_items,
+               BLO_WRITE_COMPRESSION_DEFAULT,
+               "Compression Profile",
+               "Trade-off between saving time and file size of compressed files");
   RNA_def_boolean(ot->srna,
                   "relative_remap",
                   false,
@@ -0,0 +1,85 @@
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    num_objects = args['num_objects']
+    mode = args['mode']
+
+    # Generate a scene with meshes sharing data, parenting, modifiers and animation, so that all
+    # the common kinds of relations are built. A quarter of the objects are animated with several
+    # F-Curves each, so resolving animated properties is a noticeable part of building nodes.
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    mesh = bpy.data.meshes.new("Mesh")
+
+    parent = None
+    for i in range(num_objects):
+        ob = bpy.data.objects.new(f"Object{i}", mesh)
+        scene.collection.objects.link(ob)
+        if i % 16 != 0:
+            ob.parent = parent
+        else:
+            parent = ob
+        if i % 4 == 0:
+            ob.modifiers.new("Subdivision", 'SUBSURF')
+        if i % 4 == 0:
+            ob.keyframe_insert("location", frame=1)
+            ob.keyframe_insert("rotation_euler", frame=1)
+            ob.keyframe_insert("scale", frame=1)
+            ob.keyframe_insert("hide_viewport", frame=1)
+
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+
+    start_time = time.time()
+    elapsed_time = 0.0
+    num_builds = 0
+
+    while elapsed_time < 10.0:
+        if mode == 'ADD_OBJECT':
+            # Add an object and remove it again, so that every build sees the same scene size.
+            ob = bpy.data.objects.new("Added", mesh)
+            scene.collection.objects.link(ob)
+            bpy.context.view_layer.update()
+            bpy.data.objects.remove(ob)
+            bpy.context.view_layer.update()
+            num_builds += 2
+        else:
+            depsgraph.debug_tag_update()
+            bpy.context.view_layer.update()
+            num_builds += 1
+        elapsed_time = time.time() - start_time
+
+    nodes_time, relations_time, finalize_time = depsgraph.debug_build_time()
+    print(f"Last build: nodes {nodes_time:.4f}s, relations {relations_time:.4f}s, "
+          f"finalize {finalize_time:.4f}s")
+
+    result = {'time': elapsed_time / num_builds}
+    return result
+
+
+class DepsgraphBuildTest(api.Test):
+    def __init__(self, num_objects, mode):
+        self.num_objects = num_objects
+        self.mode = mode
+
+    def name(self):
+        return f"{self.mode.lower()}_{self.num_objects}_objects"
+
+    def category(self):
+        return "depsgraph_build"
+
+    def run(self, env, device_id):
+        args = {'num_objects': self.num_objects, 'mode': self.mode}
+        result, _ = env.run_in_blender(_run, args, ['--factory-startup'])
+        return result
+
+
+def generate(env):
+    return [DepsgraphBuildTest(num_objects, mode)
+            for num_objects in (1000, 10000, 50000)
+            for mode in ('REBUILD', 'ADD_OBJECT')]
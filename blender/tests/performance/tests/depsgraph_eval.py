@@ -0,0 +1,112 @@
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    num_rigs = args['num_rigs']
+    num_bones = args['num_bones']
+
+    # Generate animated rigs with long constraint chains, each deforming a dense mesh. Every rig
+    # is a long single threaded chain of operations, next to many cheap ones.
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.frame_start = 1
+    scene.frame_end = 50
+
+    size = 128
+    verts = [(x / size, y / size, 0.0) for y in range(size) for x in range(size)]
+    faces = [(y * size + x, y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x)
+             for y in range(size - 1) for x in range(size - 1)]
+
+    for i in range(num_rigs):
+        armature = bpy.data.armatures.new(f"Armature{i}")
+        rig = bpy.data.objects.new(f"Rig{i}", armature)
+        scene.collection.objects.link(rig)
+        rig.location.x = i * 2.0
+
+        bpy.context.view_layer.objects.active = rig
+        bpy.ops.object.mode_set(mode='EDIT')
+        parent = None
+        for b in range(num_bones):
+            bone = armature.edit_bones.new(f"Bone{b}")
+            bone.head = (0.0, 0.0, b * 0.1)
+            bone.tail = (0.0, 0.0, (b + 1) * 0.1)
+            bone.parent = parent
+            bone.use_connect = parent is not None
+            parent = bone
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+        pose_bones = rig.pose.bones
+        for b in range(1, num_bones):
+            constraint = pose_bones[b].constraints.new('COPY_ROTATION')
+            constraint.target = rig
+            constraint.subtarget = pose_bones[b - 1].name
+            constraint.mix_mode = 'ADD'
+            constraint.influence = 0.5
+        pose_bones[0].rotation_mode = 'XYZ'
+        pose_bones[0].rotation_euler = (0.0, 0.0, 0.0)
+        pose_bones[0].keyframe_insert("rotation_euler", frame=scene.frame_start)
+        pose_bones[0].rotation_euler = (0.5, 0.0, 0.0)
+        pose_bones[0].keyframe_insert("rotation_euler", frame=scene.frame_end)
+
+        mesh = bpy.data.meshes.new(f"Mesh{i}")
+        mesh.from_pydata(verts, [], faces)
+        ob = bpy.data.objects.new(f"Object{i}", mesh)
+        scene.collection.objects.link(ob)
+        ob.parent = rig
+        modifier = ob.modifiers.new("Armature", 'ARMATURE')
+        modifier.object = rig
+        modifier.use_vertex_groups = False
+        modifier.use_bone_envelopes = True
+
+    # Cheap animated objects competing for the same threads.
+    for i in range(num_rigs * 50):
+        ob = bpy.data.objects.new(f"Empty{i}", None)
+        scene.collection.objects.link(ob)
+        ob.keyframe_insert("location", frame=scene.frame_start)
+        ob.location.z = 1.0
+        ob.keyframe_insert("location", frame=scene.frame_end)
+
+    # Evaluate a few frames first, the scheduler uses timings of previous evaluations.
+    for i in range(scene.frame_start, scene.frame_end + 1):
+        scene.frame_set(i)
+
+    start_time = time.time()
+    elapsed_time = 0.0
+    num_frames = 0
+
+    while elapsed_time < 10.0:
+        for i in range(scene.frame_start, scene.frame_end + 1):
+            scene.frame_set(i)
+
+        num_frames += scene.frame_end + 1 - scene.frame_start
+        elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time / num_frames}
+    return result
+
+
+class DepsgraphEvalTest(api.Test):
+    def __init__(self, num_rigs, num_bones):
+        self.num_rigs = num_rigs
+        self.num_bones = num_bones
+
+    def name(self):
+        return f"rigs_{self.num_rigs}x{self.num_bones}_bones"
+
+    def category(self):
+        return "depsgraph_eval"
+
+    def run(self, env, device_id):
+        args = {'num_rigs': self.num_rigs, 'num_bones': self.num_bones}
+        result, _ = env.run_in_blender(_run, args, ['--factory-startup'])
+        return result
+
+
+def generate(env):
+    return [DepsgraphEvalTest(num_rigs, num_bones)
+            for num_rigs, num_bones in ((4, 500), (16, 200), (64, 50))]
@@ -0,0 +1,137 @@
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    tree_type = args['tree_type']
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    tree = bpy.data.node_groups.new("Benchmark", 'GeometryNodeTree')
+    tree.outputs.new('NodeSocketGeometry', "Geometry")
+    nodes = tree.nodes
+    links = tree.links
+    group_output = nodes.new('NodeGroupOutput')
+
+    def enabled_socket(sockets, name):
+        return next(socket for socket in sockets if socket.enabled and socket.name == name)
+
+    def grid(vertices):
+        node = nodes.new('GeometryNodeMeshGrid')
+        node.inputs["Vertices X"].default_value = vertices
+        node.inputs["Vertices Y"].default_value = vertices
+        return node.outputs["Mesh"]
+
+    if tree_type == 'FIELDS':
+        # A long chain of cheap math nodes, where the per-node overhead dominates.
+        set_position = nodes.new('GeometryNodeSetPosition')
+        links.new(grid(1000), set_position.inputs["Geometry"])
+        value = nodes.new('GeometryNodeInputPosition').outputs["Position"]
+        for i in range(500):
+            math = nodes.new('ShaderNodeVectorMath')
+            math.operation = 'MULTIPLY_ADD' if i % 2 else 'SINE'
+            links.new(value, math.inputs[0])
+            if i % 2:
+                math.inputs[1].default_value = (0.5, 0.5, 0.5)
+                math.inputs[2].default_value = (0.1, 0.0, 0.0)
+            value = math.outputs["Vector"]
+        links.new(value, set_position.inputs["Offset"])
+        output_socket = set_position.outputs["Geometry"]
+    elif tree_type == 'BRANCHES':
+        # Independent heavy branches that can be evaluated in parallel.
+        join = nodes.new('GeometryNodeJoinGeometry')
+        for i in range(16):
+            sphere = nodes.new('GeometryNodeMeshIcoSphere')
+            sphere.inputs["Subdivisions"].default_value = 5
+            sphere.inputs["Radius"].default_value = 1.0 + i
+            subdivide = nodes.new('GeometryNodeSubdivideMesh')
+            subdivide.inputs["Level"].default_value = 1
+            links.new(sphere.outputs["Mesh"], subdivide.inputs["Mesh"])
+            links.new(subdivide.outputs["Mesh"], join.inputs["Geometry"])
+        output_socket = join.outputs["Geometry"]
+    elif tree_type == 'LAZY':
+        # Only one of the switched branches is requested, the other one must not be computed.
+        switch = nodes.new('GeometryNodeSwitch')
+        switch.input_type = 'GEOMETRY'
+        enabled_socket(switch.inputs, "Switch").default_value = False
+        subdivide = nodes.new('GeometryNodeSubdivideMesh')
+        subdivide.inputs["Level"].default_value = 6
+        links.new(grid(200), subdivide.inputs["Mesh"])
+        links.new(grid(300), enabled_socket(switch.inputs, "False"))
+        links.new(subdivide.outputs["Mesh"], enabled_socket(switch.inputs, "True"))
+        output_socket = enabled_socket(switch.outputs, "Output")
+    elif tree_type == 'REALIZE':
+        # Ten million instances of a single triangle, where the per-instance overhead dominates.
+        points = nodes.new('GeometryNodePoints')
+        points.inputs["Count"].default_value = 10000000
+        triangle = nodes.new('GeometryNodeMeshCircle')
+        triangle.fill_type = 'NGON'
+        triangle.inputs["Vertices"].default_value = 3
+        triangle.inputs["Radius"].default_value = 0.01
+        instance = nodes.new('GeometryNodeInstanceOnPoints')
+        links.new(points.outputs["Geometry"], instance.inputs["Points"])
+        links.new(triangle.outputs["Mesh"], instance.inputs["Instance"])
+        realize = nodes.new('GeometryNodeRealizeInstances')
+        links.new(instance.outputs["Instances"], realize.inputs["Geometry"])
+        output_socket = realize.outputs["Geometry"]
+    else:
+        # Many instances of a small mesh which are realized.
+        instance = nodes.new('GeometryNodeInstanceOnPoints')
+        sphere = nodes.new('GeometryNodeMeshIcoSphere')
+        sphere.inputs["Radius"].default_value = 0.01
+        links.new(grid(300), instance.inputs["Points"])
+        links.new(sphere.outputs["Mesh"], instance.inputs["Instance"])
+        realize = nodes.new('GeometryNodeRealizeInstances')
+        links.new(instance.outputs["Instances"], realize.inputs["Geometry"])
+        output_socket = realize.outputs["Geometry"]
+
+    links.new(output_socket, group_output.inputs[0])
+
+    mesh = bpy.data.meshes.new("Mesh")
+    ob = bpy.data.objects.new("Object", mesh)
+    scene.collection.objects.link(ob)
+    modifier = ob.modifiers.new("Nodes", 'NODES')
+    modifier.node_group = tree
+
+    bpy.context.view_layer.update()
+
+    start_time = time.time()
+    elapsed_time = 0.0
+    num_evaluations = 0
+
+    while elapsed_time < 10.0:
+        ob.update_tag(refresh={'DATA'})
+        bpy.context.view_layer.update()
+
+        num_evaluations += 1
+        elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time / num_evaluations}
+    return result
+
+
+class GeometryNodesTest(api.Test):
+    def __init__(self, tree_type):
+        self.tree_type = tree_type
+
+    def name(self):
+        return self.tree_type.lower()
+
+    def category(self):
+        return "geometry_nodes"
+
+    def run(self, env, device_id):
+        args = {'tree_type': self.tree_type}
+        # Per-node timings are printed with --debug-depsgraph-time when running manually.
+        result, _ = env.run_in_blender(_run, args, ['--factory-startup'])
+        return result
+
+
+def generate(env):
+    return [GeometryNodesTest(tree_type)
+            for tree_type in ('FIELDS', 'BRANCHES', 'LAZY', 'INSTANCES', 'REALIZE')]
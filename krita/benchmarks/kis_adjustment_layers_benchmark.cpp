@@ -0,0 +1,162 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_adjustment_layers_benchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "filter/KisFilterResultCache.h"
+#include "kis_adjustment_layer.h"
+#include "kis_debug.h"
+#include "kis_group_layer.h"
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_paint_layer.h"
+#include "kis_surrogate_undo_store.h"
+
+namespace {
+
+const QRect imageRect(0, 0, 4096, 4096);
+
+KisImageSP createImage(KisPaintLayerSP &layer, QVector<KisAdjustmentLayerSP> &adjustmentLayers)
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "benchmark image");
+
+    layer = new KisPaintLayer(image, "paint", OPACITY_OPAQUE_U8);
+    image->addNode(layer);
+
+    for (int i = 0; i < 64; i++) {
+        const QRect rc((i * 379) % 3584, (i * 827) % 3584, 512, 512);
+        layer->paintDevice()->fill(rc, KoColor(QColor::fromHsv(i * 37 % 360, 200, 200), cs));
+    }
+
+    const QStringList filterIds({"blur", "hsvadjustment", "invert", "desaturate", "levels"});
+
+    for (int i = 0; i < 10; i++) {
+        KisFilterSP filter = KisFilterRegistry::instance()->value(filterIds[i % filterIds.size()]);
+        KIS_ASSERT(filter);
+
+        KisFilterConfigurationSP config =
+            filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+        KisAdjustmentLayerSP adjustmentLayer =
+            new KisAdjustmentLayer(image, QString("adjustment %1").arg(i), config->cloneWithResourcesSnapshot(), 0);
+        image->addNode(adjustmentLayer);
+
+        adjustmentLayers << adjustmentLayer;
+    }
+
+    image->initialRefreshGraph();
+
+    return image;
+}
+
+void setCacheLimits(const QVector<KisAdjustmentLayerSP> &adjustmentLayers, bool useCache)
+{
+    // the total limit should fit the results of all the layers
+    KisFilterResultCache::setTotalMemoryLimit(qint64(1024) * 1024 * 1024);
+
+    Q_FOREACH (KisAdjustmentLayerSP layer, adjustmentLayers) {
+        layer->filterResultCache()->setMemoryLimit(useCache ? 256 * 1024 * 1024 : 0);
+    }
+}
+
+void printCacheStats(const QVector<KisAdjustmentLayerSP> &adjustmentLayers)
+{
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 memoryUsage = 0;
+
+    Q_FOREACH (KisAdjustmentLayerSP layer, adjustmentLayers) {
+        const KisFilterResultCache::Stats stats = layer->filterResultCache()->stats();
+        hits += stats.hits;
+        misses += stats.misses;
+        memoryUsage += stats.memoryUsage;
+    }
+
+    qDebug() << "Filter result cache:" << ppVar(hits) << ppVar(misses) << "memory:" << memoryUsage / 1024 / 1024 << "MiB";
+}
+
+}
+
+void KisAdjustmentLayersBenchmark::benchmarkRefresh_data()
+{
+    QTest::addColumn<bool>("useCache");
+
+    QTest::addRow("uncached") << false;
+    QTest::addRow("cached") << true;
+}
+
+void KisAdjustmentLayersBenchmark::benchmarkRefresh()
+{
+    QFETCH(bool, useCache);
+
+    KisPaintLayerSP layer;
+    QVector<KisAdjustmentLayerSP> adjustmentLayers;
+    KisImageSP image = createImage(layer, adjustmentLayers);
+
+    setCacheLimits(adjustmentLayers, useCache);
+
+    // fill the caches, the cells are stored when they are
+    // filtered for the second time
+    for (int i = 0; i < 2; i++) {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    QBENCHMARK {
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    printCacheStats(adjustmentLayers);
+}
+
+void KisAdjustmentLayersBenchmark::benchmarkColdRefresh_data()
+{
+    QTest::addColumn<bool>("useCache");
+
+    QTest::addRow("uncached") << false;
+    QTest::addRow("cached") << true;
+}
+
+void KisAdjustmentLayersBenchmark::benchmarkColdRefresh()
+{
+    QFETCH(bool, useCache);
+
+    KisPaintLayerSP layer;
+    QVector<KisAdjustmentLayerSP> adjustmentLayers;
+    KisImageSP image = createImage(layer, adjustmentLayers);
+
+    setCacheLimits(adjustmentLayers, useCache);
+
+    int iteration = 0;
+
+    /**
+     * The whole layer is changed before every refresh, so the cache
+     * never hits. That is the overhead of the cache on the first render
+     * of a node.
+     */
+    QBENCHMARK {
+        const KoColor color(QColor::fromHsv(iteration++ * 13 % 360, 150, 150), layer->colorSpace());
+        layer->paintDevice()->fill(imageRect, color);
+
+        image->refreshGraphAsync();
+        image->waitForDone();
+    }
+
+    printCacheStats(adjustmentLayers);
+}
+
+SIMPLE_TEST_MAIN(KisAdjustmentLayersBenchmark)
@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_ADJUSTMENT_LAYERS_BENCHMARK_H
+#define KIS_ADJUSTMENT_LAYERS_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisAdjustmentLayersBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkRefresh_data();
+    void benchmarkRefresh();
+
+    void benchmarkColdRefresh_data();
+    void benchmarkColdRefresh();
+};
+
+#endif
@@ -9,6 +9,9 @@
 
 #include <simpletest.h>
 #include <kis_datamanager.h>
+#include <tiles3/kis_tile_data_store.h>
+
+#include <QElapsedTimer>
 
 // RGBA
 #define PIXEL_SIZE 4
@@ -186,5 +189,56 @@ void KisDatamanagerBenchmark::benchmarkMemCpy()
     delete[] dst;
 }
 
+void KisDatamanagerBenchmark::benchmarkUndoHistory()
+{
+    // emulates a painting session of 1000 strokes, where every
+    // second stroke doesn't actually change the pixels of the device
+    const int numStrokes = 1000;
+    const int strokeSize = 256;
+
+    quint8 *p = new quint8[PIXEL_SIZE];
+    memset(p, 0, PIXEL_SIZE);
+    KisDataManager dm(PIXEL_SIZE, p);
+
+    quint8 *bytes = new quint8[PIXEL_SIZE * strokeSize * strokeSize];
+
+    QVector<KisMementoSP> history;
+    history.reserve(numStrokes);
+
+    const qint32 numTilesBefore = KisTileDataStore::instance()->numTiles();
+
+    QBENCHMARK_ONCE {
+        for (int i = 0; i < numStrokes; i++) {
+            const int x = (i * 97) % (NO_TILE_EXACT_BOUNDARY_WIDTH - strokeSize);
+            const int y = (i * 61) % (NO_TILE_EXACT_BOUNDARY_HEIGHT - strokeSize);
+
+            history.append(dm.getMemento());
+
+            if (i & 0x1) {
+                dm.readBytes(bytes, x, y, strokeSize, strokeSize);
+            } else {
+                memset(bytes, i & 0xff, PIXEL_SIZE * strokeSize * strokeSize);
+            }
+
+            dm.writeBytes(bytes, x, y, strokeSize, strokeSize);
+            dm.commit();
+        }
+    }
+
+    qDebug() << "Tiles used by the history:"
+             << KisTileDataStore::instance()->numTiles() - numTilesBefore;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = history.size() - 1; i >= 0; i--) {
+        dm.rollback(history[i]);
+    }
+
+    qDebug() << "Undoing" << numStrokes << "strokes took" << timer.elapsed() << "ms";
+
+    delete[] bytes;
+    delete[] p;
+}
 
 SIMPLE_TEST_MAIN(KisDatamanagerBenchmark)
@@ -24,6 +24,7 @@ private Q_SLOTS:
     void benchmarkExtent();
     void benchmarkClear();
     void benchmarkMemCpy();
+    void benchmarkUndoHistory();
 };
 
 #endif
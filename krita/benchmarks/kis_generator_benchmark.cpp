@@ -0,0 +1,122 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_generator_benchmark.h"
+
+#include <simpletest.h>
+
+#include <QtConcurrent>
+
+#include <KoColorSpaceRegistry.h>
+#include <KisGlobalResourcesInterface.h>
+
+#include "generator/kis_generator.h"
+#include "generator/kis_generator_registry.h"
+#include "filter/kis_filter_configuration.h"
+#include "kis_default_bounds.h"
+#include "kis_paint_device.h"
+#include "kis_processing_information.h"
+#include "kis_selection.h"
+#include "krita_utils.h"
+
+namespace {
+
+const QRect imageRect(0, 0, 8192, 8192);
+
+const char *seexprScript =
+    "$val=voronoi(5*[$u,$v,.5],4,.6,.2);\n"
+    "$color=ccurve($val,\n"
+    "    0.000, [0.141, 0.059, 0.051], 4,\n"
+    "    0.185, [0.302, 0.176, 0.122], 4,\n"
+    "    0.301, [0.651, 0.447, 0.165], 4,\n"
+    "    0.462, [0.976, 0.976, 0.976], 4);\n"
+    "$color\n";
+
+void generatorData()
+{
+    QTest::addColumn<QString>("generatorId");
+
+    QTest::addRow("screentone") << "screentone";
+    QTest::addRow("seexpr") << "seexpr";
+}
+
+KisFilterConfigurationSP createConfiguration(KisGeneratorSP generator)
+{
+    KisFilterConfigurationSP config =
+        generator->defaultConfiguration(KisGlobalResourcesInterface::instance());
+
+    if (generator->id() == "seexpr") {
+        config->setProperty("script", seexprScript);
+    }
+
+    return config;
+}
+
+KisPaintDeviceSP createDevice()
+{
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->setDefaultBounds(new KisWrapAroundBoundsWrapper(new KisDefaultBounds(), imageRect));
+    return dev;
+}
+
+}
+
+void KisGeneratorBenchmark::initTestCase()
+{
+    KisGeneratorRegistry::instance();
+}
+
+void KisGeneratorBenchmark::benchmarkGenerate_data()
+{
+    generatorData();
+}
+
+void KisGeneratorBenchmark::benchmarkGenerate()
+{
+    QFETCH(QString, generatorId);
+
+    KisGeneratorSP generator = KisGeneratorRegistry::instance()->value(generatorId);
+    QVERIFY(generator);
+
+    KisFilterConfigurationSP config = createConfiguration(generator);
+
+    QBENCHMARK {
+        KisPaintDeviceSP dev = createDevice();
+        generator->generate(KisProcessingInformation(dev, imageRect.topLeft(), KisSelectionSP()),
+                            imageRect.size(), config);
+    }
+}
+
+void KisGeneratorBenchmark::benchmarkGeneratePatches_data()
+{
+    generatorData();
+}
+
+void KisGeneratorBenchmark::benchmarkGeneratePatches()
+{
+    QFETCH(QString, generatorId);
+
+    KisGeneratorSP generator = KisGeneratorRegistry::instance()->value(generatorId);
+    QVERIFY(generator);
+    QVERIFY(generator->allowsSplittingIntoPatches());
+
+    KisFilterConfigurationSP config = createConfiguration(generator);
+
+    // split the same way KisGeneratorStrokeStrategy does
+    QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(imageRect, KritaUtils::optimalPatchSize());
+
+    QBENCHMARK {
+        KisPaintDeviceSP dev = createDevice();
+
+        QtConcurrent::blockingMap(patches, [dev, generator, config] (const QRect &rc) {
+            generator->generate(KisProcessingInformation(dev, rc.topLeft(), KisSelectionSP()),
+                                rc.size(), config);
+        });
+    }
+}
+
+SIMPLE_TEST_MAIN(KisGeneratorBenchmark)
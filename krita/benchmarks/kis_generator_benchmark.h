@@ -0,0 +1,25 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_GENERATOR_BENCHMARK_H
+#define KIS_GENERATOR_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisGeneratorBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkGenerate_data();
+    void benchmarkGenerate();
+
+    void benchmarkGeneratePatches_data();
+    void benchmarkGeneratePatches();
+};
+
+#endif
@@ -18,6 +18,8 @@
 #include <KoCompositeOpRegistry.h>
 
 #include <kis_image.h>
+#include <kis_pixel_selection.h>
+#include <kis_selection.h>
 
 #include "kis_gradient_benchmark.h"
 
@@ -70,6 +72,72 @@ void KisGradientBenchmark::benchmarkGradient()
     out.save("fill_output.png");
 }
 
+void KisGradientBenchmark::benchmarkGradientShapes_data()
+{
+    QTest::addColumn<int>("shape");
+    QTest::addColumn<int>("repeat");
+
+    const QVector<QPair<KisGradientPainter::enumGradientShape, QString>> shapes = {
+        {KisGradientPainter::GradientShapeLinear, "linear"},
+        {KisGradientPainter::GradientShapeBiLinear, "bilinear"},
+        {KisGradientPainter::GradientShapeRadial, "radial"},
+        {KisGradientPainter::GradientShapeSquare, "square"},
+        {KisGradientPainter::GradientShapeConical, "conical"},
+        {KisGradientPainter::GradientShapeConicalSymetric, "conical-symmetric"},
+        {KisGradientPainter::GradientShapeSpiral, "spiral"},
+        {KisGradientPainter::GradientShapeReverseSpiral, "reverse-spiral"},
+        {KisGradientPainter::GradientShapePolygonal, "polygonal"}
+    };
+
+    const QVector<QPair<KisGradientPainter::enumGradientRepeat, QString>> repeats = {
+        {KisGradientPainter::GradientRepeatNone, "none"},
+        {KisGradientPainter::GradientRepeatForwards, "forwards"},
+        {KisGradientPainter::GradientRepeatAlternate, "alternate"}
+    };
+
+    for (auto shape : shapes) {
+        for (auto repeat : repeats) {
+            // the polygonal shape ignores the repeat mode
+            if (shape.first == KisGradientPainter::GradientShapePolygonal &&
+                repeat.first != KisGradientPainter::GradientRepeatNone) {
+                continue;
+            }
+
+            QTest::addRow("%s-%s", qPrintable(shape.second), qPrintable(repeat.second))
+                << int(shape.first) << int(repeat.first);
+        }
+    }
+}
+
+void KisGradientBenchmark::benchmarkGradientShapes()
+{
+    QFETCH(int, shape);
+    QFETCH(int, repeat);
+
+    QLinearGradient grad;
+    grad.setColorAt(0, Qt::white);
+    grad.setColorAt(0.5, Qt::blue);
+    grad.setColorAt(1.0, Qt::red);
+    KoAbstractGradientSP kograd(KoStopGradient::fromQGradient(&grad));
+
+    const QRect rect(0, 0, GMP_IMAGE_WIDTH, GMP_IMAGE_HEIGHT);
+
+    // the polygonal shape is calculated from the outline of the selection
+    KisSelectionSP selection = new KisSelection();
+    selection->pixelSelection()->select(rect.adjusted(100, 100, -100, -100));
+
+    QBENCHMARK
+    {
+        KisGradientPainter fillPainter(m_device, selection);
+        fillPainter.setGradient(kograd);
+        fillPainter.setOpacity(OPACITY_OPAQUE_U8);
+        fillPainter.setCompositeOpId(COMPOSITE_OVER);
+        fillPainter.setGradientShape(KisGradientPainter::enumGradientShape(shape));
+        fillPainter.paintGradient(QPointF(1000, 800), QPointF(1600, 1100),
+                                  KisGradientPainter::enumGradientRepeat(repeat),
+                                  1.0, false, rect);
+    }
+}
 
 void KisGradientBenchmark::cleanupTestCase()
 {
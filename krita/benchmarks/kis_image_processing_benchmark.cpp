@@ -0,0 +1,77 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_image_processing_benchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_filter_strategy.h"
+#include "kis_image.h"
+#include "kis_paint_device.h"
+#include "kis_paint_layer.h"
+#include "kis_surrogate_undo_store.h"
+
+namespace {
+
+const QRect imageRect(0, 0, 2048, 2048);
+const int numLayers = 50;
+
+KisImageSP createImage()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisImageSP image = new KisImage(new KisSurrogateUndoStore(), imageRect.width(), imageRect.height(), cs, "benchmark image");
+
+    for (int i = 0; i < numLayers; i++) {
+        KisPaintLayerSP layer = new KisPaintLayer(image, QString("layer %1").arg(i), OPACITY_OPAQUE_U8);
+
+        for (int j = 0; j < 8; j++) {
+            const QRect rc((i * 131 + j * 379) % 1536, (i * 257 + j * 827) % 1536, 512, 512);
+            layer->paintDevice()->fill(rc, KoColor(QColor::fromHsv((i * 8 + j) * 37 % 360, 200, 200), cs));
+        }
+
+        image->addNode(layer);
+    }
+
+    image->initialRefreshGraph();
+
+    return image;
+}
+
+}
+
+void KisImageProcessingBenchmark::benchmarkScaleImage()
+{
+    KisImageSP image = createImage();
+    KisFilterStrategy *filter = KisFilterStrategyRegistry::instance()->value("Bicubic");
+
+    QBENCHMARK_ONCE {
+        image->scaleImage(QSize(3000, 3000), image->xRes(), image->yRes(), filter);
+        image->waitForDone();
+    }
+}
+
+void KisImageProcessingBenchmark::benchmarkConvertImageColorSpace()
+{
+    KisImageSP image = createImage();
+
+    const KoColorSpace *dstColorSpace =
+        KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(),
+                                                     Float32BitsColorDepthID.id(),
+                                                     KoColorSpaceRegistry::instance()->p709G10Profile());
+
+    QBENCHMARK_ONCE {
+        image->convertImageColorSpace(dstColorSpace,
+                                      KoColorConversionTransformation::internalRenderingIntent(),
+                                      KoColorConversionTransformation::internalConversionFlags());
+        image->waitForDone();
+    }
+}
+
+SIMPLE_TEST_MAIN(KisImageProcessingBenchmark)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_IMAGE_PROCESSING_BENCHMARK_H
+#define KIS_IMAGE_PROCESSING_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisImageProcessingBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkScaleImage();
+    void benchmarkConvertImageColorSpace();
+};
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_mypaint_surface_benchmark.h"
+
+#include <simpletest.h>
+#include <QtMath>
+
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_painter.h>
+
+#include "MyPaintSurface.h"
+
+void KisMyPaintSurfaceBenchmark::benchmarkStroke()
+{
+    KisPaintDeviceSP dst = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb16());
+    KisPainter painter(dst);
+
+    QScopedPointer<KisMyPaintSurface> surface(new KisMyPaintSurface(&painter, dst));
+
+    float r = 0.0f;
+    float g = 0.0f;
+    float b = 0.0f;
+    float a = 0.0f;
+
+    // emulates a smudging stroke: every dab samples the surface first
+    QBENCHMARK {
+        for (int i = 0; i < 200; i++) {
+            const float x = 50 + 2 * i;
+            const float y = 250 + 50 * qSin(0.05 * i);
+
+            surface->get_color(surface->surface(), x, y, 30, &r, &g, &b, &a);
+            surface->draw_dab(surface->surface(), x, y, 30, 0, 0, 1, 1, 0.8, 1, 1, 90, 0, 0);
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisMyPaintSurfaceBenchmark)
@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_MYPAINT_SURFACE_BENCHMARK_H
+#define KIS_MYPAINT_SURFACE_BENCHMARK_H
+
+#include <QObject>
+
+class KisMyPaintSurfaceBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkStroke();
+};
+
+#endif // KIS_MYPAINT_SURFACE_BENCHMARK_H
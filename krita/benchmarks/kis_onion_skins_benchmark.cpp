@@ -0,0 +1,106 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_onion_skins_benchmark.h"
+
+#include <simpletest.h>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_default_bounds.h"
+#include "kis_image_config.h"
+#include "kis_onion_skin_compositor.h"
+#include "kis_paint_device.h"
+#include "kis_paint_device_frames_interface.h"
+#include "kis_raster_keyframe_channel.h"
+
+namespace {
+
+const QRect imageRect(0, 0, 2048, 2048);
+const int numFrames = 24;
+
+class TimedDefaultBounds : public KisDefaultBounds
+{
+public:
+    int currentTime() const override {
+        return time;
+    }
+
+    int time = 0;
+};
+
+}
+
+void KisOnionSkinsBenchmark::benchmarkSwitchFrames_data()
+{
+    QTest::addColumn<int>("numberOfSkins");
+    QTest::addColumn<bool>("useCache");
+
+    for (int skins : {1, 3, 6, 10}) {
+        QTest::addRow("%d skins, uncached", skins) << skins << false;
+        QTest::addRow("%d skins, cached", skins) << skins << true;
+    }
+}
+
+void KisOnionSkinsBenchmark::benchmarkSwitchFrames()
+{
+    QFETCH(int, numberOfSkins);
+    QFETCH(bool, useCache);
+
+    {
+        KisImageConfig config(false);
+        config.setNumberOfOnionSkins(numberOfSkins);
+        config.setOnionSkinTintFactor(192);
+        config.setOnionSkinState(0, true);
+        config.setOnionSkinOpacity(0, 255);
+
+        for (int i = 1; i <= numberOfSkins; i++) {
+            config.setOnionSkinState(-i, true);
+            config.setOnionSkinState(i, true);
+            config.setOnionSkinOpacity(-i, 255 - i * 20);
+            config.setOnionSkinOpacity(i, 255 - i * 20);
+        }
+    }
+
+    KisOnionSkinCompositor *compositor = KisOnionSkinCompositor::instance();
+    compositor->configChanged();
+
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+
+    TimedDefaultBounds *bounds = new TimedDefaultBounds();
+    KisPaintDeviceSP device = new KisPaintDevice(cs);
+    device->setDefaultBounds(bounds);
+
+    KisRasterKeyframeChannel *channel = device->createKeyframeChannel(KoID());
+
+    for (int i = 0; i < numFrames; i++) {
+        channel->addKeyframe(i);
+
+        KisPaintDeviceSP frameContent = new KisPaintDevice(cs);
+        for (int j = 0; j < 6; j++) {
+            const QRect rc((i * 131 + j * 379) % 1536, (i * 257 + j * 827) % 1536, 512, 512);
+            frameContent->fill(rc, KoColor(QColor::fromHsv((i * 6 + j) * 37 % 360, 200, 200), cs));
+        }
+
+        const int frameId = channel->keyframeAt<KisRasterKeyframe>(i)->frameID();
+        device->framesInterface()->uploadFrame(frameId, frameContent);
+    }
+
+    KisOnionSkinCompositor::TintedFramesCache cache;
+    KisPaintDeviceSP projection = new KisPaintDevice(cs);
+
+    // each iteration steps through the whole animation, updating the skins on every frame
+    QBENCHMARK {
+        for (int time = 0; time < numFrames; time++) {
+            bounds->time = time;
+            projection->clear();
+            compositor->composite(device, projection, imageRect, useCache ? &cache : nullptr);
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisOnionSkinsBenchmark)
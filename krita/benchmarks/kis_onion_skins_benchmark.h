@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_ONION_SKINS_BENCHMARK_H
+#define KIS_ONION_SKINS_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisOnionSkinsBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkSwitchFrames_data();
+    void benchmarkSwitchFrames();
+};
+
+#endif
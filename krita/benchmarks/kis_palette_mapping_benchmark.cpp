@@ -0,0 +1,163 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_palette_mapping_benchmark.h"
+
+#include <simpletest.h>
+
+#include <QDataStream>
+
+#include <KoColor.h>
+#include <KoColorModelStandardIds.h>
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+#include <KisDitherOp.h>
+
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+#include "filter/kis_filter_registry.h"
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+#include "krita_utils.h"
+#include <KisGlobalResourcesInterface.h>
+
+namespace {
+
+const int imageSize = 8192;
+const int stripeHeight = 64;
+
+/**
+ * Serializes the palette generator config of the Index Colors filter. The
+ * palette is built of four base colors and three ramps of 84 shades
+ * between them, which makes 256 colors in total.
+ */
+QByteArray paletteGeneratorConfig()
+{
+    const QColor baseColors[4] = {Qt::white, Qt::red, Qt::blue, Qt::black};
+
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    // version
+    stream << 0;
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            stream << baseColors[i];
+        }
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            stream << (j == 0);
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        stream << 84;
+    }
+
+    stream << 0; // in-between ramp steps
+    stream << false; // diagonal gradients
+
+    return result;
+}
+
+void fillNoise(KisPaintDeviceSP dev, const QRect &rc, int numColors)
+{
+    const KoColorSpace *cs = dev->colorSpace();
+    QVector<KoColor> colors;
+
+    for (int i = 0; i < numColors; i++) {
+        colors << KoColor(QColor(rand() % 256, rand() % 256, rand() % 256), cs);
+    }
+
+    KisSequentialIterator it(dev, rc);
+    while (it.nextPixel()) {
+        memcpy(it.rawData(), colors[rand() % numColors].data(), cs->pixelSize());
+    }
+}
+
+}
+
+void KisPaletteMappingBenchmark::benchmarkDitherOp_data()
+{
+    QTest::addColumn<int>("ditherType");
+
+    QTest::addRow("none") << int(DITHER_NONE);
+    QTest::addRow("bayer") << int(DITHER_BAYER);
+    QTest::addRow("blue-noise") << int(DITHER_BLUE_NOISE);
+}
+
+void KisPaletteMappingBenchmark::benchmarkDitherOp()
+{
+    QFETCH(int, ditherType);
+
+    const KoColorSpace *srcCS = KoColorSpaceRegistry::instance()->rgb16();
+    const KoColorSpace *dstCS = KoColorSpaceRegistry::instance()->rgb8();
+
+    const KisDitherOp *op = srcCS->ditherOp(dstCS->colorDepthId().id(), DitherType(ditherType));
+    QVERIFY(op);
+
+    /**
+     * The whole 8k image would take too much memory, so the same stripe
+     * is dithered until the full image area is covered.
+     */
+    const int srcStride = imageSize * srcCS->pixelSize();
+    const int dstStride = imageSize * dstCS->pixelSize();
+
+    QVector<quint8> src(srcStride * stripeHeight);
+    QVector<quint8> dst(dstStride * stripeHeight);
+
+    for (int i = 0; i < src.size(); i++) {
+        src[i] = quint8(rand());
+    }
+
+    QBENCHMARK {
+        for (int y = 0; y < imageSize; y += stripeHeight) {
+            op->dither(src.constData(), srcStride, dst.data(), dstStride, 0, y, imageSize, stripeHeight);
+        }
+    }
+}
+
+void KisPaletteMappingBenchmark::benchmarkIndexColors_data()
+{
+    QTest::addColumn<int>("numImageColors");
+
+    QTest::addRow("few-colors") << 64;
+    QTest::addRow("many-colors") << 16384;
+}
+
+void KisPaletteMappingBenchmark::benchmarkIndexColors()
+{
+    QFETCH(int, numImageColors);
+
+    KisFilterSP filter = KisFilterRegistry::instance()->value("indexcolors");
+    QVERIFY(filter);
+
+    KisFilterConfigurationSP config = filter->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    config->setProperty("paletteGen", paletteGeneratorConfig());
+
+    const QRect rc(0, 0, imageSize, imageSize);
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+
+    srand(31524744);
+    fillNoise(dev, rc, numImageColors);
+
+    KisPaintDeviceSP dst = new KisPaintDevice(dev->colorSpace());
+    const QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc, KritaUtils::optimalPatchSize());
+
+    QBENCHMARK_ONCE {
+        Q_FOREACH (const QRect &patch, patches) {
+            filter->process(dev, dst, 0, patch, config);
+        }
+    }
+}
+
+SIMPLE_TEST_MAIN(KisPaletteMappingBenchmark)
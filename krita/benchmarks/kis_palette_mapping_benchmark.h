@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_PALETTE_MAPPING_BENCHMARK_H
+#define KIS_PALETTE_MAPPING_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisPaletteMappingBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkDitherOp_data();
+    void benchmarkDitherOp();
+
+    void benchmarkIndexColors_data();
+    void benchmarkIndexColors();
+};
+
+#endif
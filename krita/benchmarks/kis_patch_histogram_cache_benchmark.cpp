@@ -0,0 +1,62 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <simpletest.h>
+
+#include "kis_patch_histogram_cache_benchmark.h"
+
+#include <KoColorSpace.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+#include <KisPatchHistogramCache.h>
+
+// the size of a typical brush dab
+static const QRect dabRect(1000, 1000, 100, 100);
+
+void KisPatchHistogramCacheBenchmark::initTestCase()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    m_device = new KisPaintDevice(cs);
+    m_bounds = QRect(0, 0, 4096, 4096);
+
+    srand(31524744);
+
+    KisSequentialIterator it(m_device, m_bounds);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        pixel[0] = rand() % 256;
+        pixel[1] = rand() % 256;
+        pixel[2] = rand() % 256;
+        pixel[3] = 255;
+    }
+}
+
+void KisPatchHistogramCacheBenchmark::benchmarkFullScan()
+{
+    KisPatchHistogramCache cache;
+
+    QBENCHMARK {
+        cache.invalidateAll();
+        cache.update(m_device, m_bounds);
+        cache.mergedBins();
+    }
+}
+
+void KisPatchHistogramCacheBenchmark::benchmarkIncremental()
+{
+    KisPatchHistogramCache cache;
+    cache.update(m_device, m_bounds);
+
+    QBENCHMARK {
+        cache.invalidateRect(dabRect);
+        cache.update(m_device, m_bounds);
+        cache.mergedBins();
+    }
+}
+
+SIMPLE_TEST_MAIN(KisPatchHistogramCacheBenchmark)
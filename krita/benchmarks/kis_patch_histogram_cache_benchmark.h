@@ -0,0 +1,28 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_PATCH_HISTOGRAM_CACHE_BENCHMARK_H
+#define KIS_PATCH_HISTOGRAM_CACHE_BENCHMARK_H
+
+#include <simpletest.h>
+#include <kis_types.h>
+
+class KisPatchHistogramCacheBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    KisPaintDeviceSP m_device;
+    QRect m_bounds;
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void benchmarkFullScan();
+    void benchmarkIncremental();
+};
+
+#endif // KIS_PATCH_HISTOGRAM_CACHE_BENCHMARK_H
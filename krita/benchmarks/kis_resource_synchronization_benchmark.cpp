@@ -0,0 +1,91 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_resource_synchronization_benchmark.h"
+
+#include <simpletest.h>
+
+#include <QDir>
+#include <QStandardPaths>
+
+#include <KisResourceCacheDb.h>
+#include <KisResourceLocator.h>
+#include <KisResourceStorage.h>
+#include <KisFolderStorage.h>
+#include <KisResourceTypes.h>
+
+#include <DummyResource.h>
+#include <ResourceTestHelper.h>
+
+static const int numResources = 5000;
+
+static QString storageLocation()
+{
+    return QDir::cleanPath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/benchmarkstorage") + '/';
+}
+
+void KisResourceSynchronizationBenchmark::initTestCase()
+{
+    ResourceTestHelper::initTestDb();
+    ResourceTestHelper::createDummyLoaderRegistry();
+
+    QVERIFY(KisResourceCacheDb::initialize(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)));
+
+    const QString location = storageLocation();
+    ResourceTestHelper::cleanDstLocation(location);
+    QVERIFY(QDir().mkpath(location + ResourceType::PaintOpPresets));
+
+    KisFolderStorage folderStorage(location);
+    for (int i = 0; i < numResources; i++) {
+        KoResourceSP resource(new DummyResource(QString("benchmark_%1.kpp").arg(i), ResourceType::PaintOpPresets));
+        QVERIFY(folderStorage.addResource(ResourceType::PaintOpPresets, resource));
+    }
+}
+
+void KisResourceSynchronizationBenchmark::cleanupTestCase()
+{
+    ResourceTestHelper::rmTestDb();
+    ResourceTestHelper::cleanDstLocation(storageLocation());
+}
+
+void KisResourceSynchronizationBenchmark::benchmarkAddStorage()
+{
+    const QString location = storageLocation();
+    const QString relativeLocation = KisResourceLocator::instance()->makeStorageLocationRelative(location);
+
+    KisResourceStorageSP storage(new KisResourceStorage(location));
+    QVERIFY(storage->valid());
+
+    QBENCHMARK {
+        QVERIFY(KisResourceCacheDb::addStorage(storage, false));
+        QCOMPARE(KisResourceCacheDb::resourcesForStorage(ResourceType::PaintOpPresets, relativeLocation).size(), numResources);
+        QVERIFY(KisResourceCacheDb::deleteStorage(storage));
+    }
+}
+
+void KisResourceSynchronizationBenchmark::benchmarkSynchronizeStorage()
+{
+    const QString location = storageLocation();
+    const QString relativeLocation = KisResourceLocator::instance()->makeStorageLocationRelative(location);
+
+    KisResourceStorageSP storage(new KisResourceStorage(location));
+    QVERIFY(storage->valid());
+
+    QVERIFY(KisResourceCacheDb::addStorage(storage, false));
+    QCOMPARE(KisResourceCacheDb::resourcesForStorage(ResourceType::PaintOpPresets, relativeLocation).size(), numResources);
+
+    // nothing has changed on disk, so the synchronization should
+    // neither load nor rehash any of the resources
+    QBENCHMARK {
+        QVERIFY(KisResourceCacheDb::synchronizeStorage(storage));
+    }
+
+    QCOMPARE(KisResourceCacheDb::resourcesForStorage(ResourceType::PaintOpPresets, relativeLocation).size(), numResources);
+
+    QVERIFY(KisResourceCacheDb::deleteStorage(storage));
+}
+
+SIMPLE_TEST_MAIN(KisResourceSynchronizationBenchmark)
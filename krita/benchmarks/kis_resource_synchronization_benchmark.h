@@ -0,0 +1,24 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_RESOURCE_SYNCHRONIZATION_BENCHMARK_H
+#define KIS_RESOURCE_SYNCHRONIZATION_BENCHMARK_H
+
+#include <QObject>
+
+class KisResourceSynchronizationBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchmarkAddStorage();
+    void benchmarkSynchronizeStorage();
+};
+
+#endif // KIS_RESOURCE_SYNCHRONIZATION_BENCHMARK_H
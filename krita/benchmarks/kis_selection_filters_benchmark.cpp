@@ -0,0 +1,84 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_selection_filters_benchmark.h"
+
+#include <simpletest.h>
+
+#include "kis_pixel_selection.h"
+#include "kis_selection_filters.h"
+
+namespace {
+
+const QRect imageRect(0, 0, 4096, 4096);
+
+KisPixelSelectionSP createSelection(bool antialiased)
+{
+    KisPixelSelectionSP selection = new KisPixelSelection();
+    selection->select(QRect(512, 512, 3072, 3072));
+    selection->clear(QRect(1024, 1024, 1024, 1024));
+    selection->clear(QRect(2560, 1536, 512, 1536));
+
+    if (antialiased) {
+        // semi-transparent pixels make the filters fall back to the generic path
+        selection->select(QRect(1536, 2560, 256, 256), 128);
+    }
+
+    return selection;
+}
+
+void radiusData()
+{
+    QTest::addColumn<int>("radius");
+    QTest::addColumn<bool>("antialiased");
+
+    for (int radius : {1, 10, 50, 200}) {
+        QTest::addRow("binary-%d", radius) << radius << false;
+        QTest::addRow("antialiased-%d", radius) << radius << true;
+    }
+}
+
+}
+
+void KisSelectionFiltersBenchmark::benchmarkGrow_data()
+{
+    radiusData();
+}
+
+void KisSelectionFiltersBenchmark::benchmarkGrow()
+{
+    QFETCH(int, radius);
+    QFETCH(bool, antialiased);
+
+    KisPixelSelectionSP selection = createSelection(antialiased);
+    KisGrowSelectionFilter filter(radius, radius);
+
+    QBENCHMARK {
+        KisPixelSelectionSP dst = new KisPixelSelection(*selection);
+        filter.process(dst, filter.changeRect(imageRect, dst->defaultBounds()));
+    }
+}
+
+void KisSelectionFiltersBenchmark::benchmarkShrink_data()
+{
+    radiusData();
+}
+
+void KisSelectionFiltersBenchmark::benchmarkShrink()
+{
+    QFETCH(int, radius);
+    QFETCH(bool, antialiased);
+
+    KisPixelSelectionSP selection = createSelection(antialiased);
+    KisShrinkSelectionFilter filter(radius, radius, false);
+
+    QBENCHMARK {
+        KisPixelSelectionSP dst = new KisPixelSelection(*selection);
+        filter.process(dst, filter.changeRect(imageRect, dst->defaultBounds()));
+    }
+}
+
+SIMPLE_TEST_MAIN(KisSelectionFiltersBenchmark)
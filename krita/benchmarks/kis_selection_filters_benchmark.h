@@ -0,0 +1,23 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_SELECTION_FILTERS_BENCHMARK_H
+#define KIS_SELECTION_FILTERS_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisSelectionFiltersBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkGrow_data();
+    void benchmarkGrow();
+
+    void benchmarkShrink_data();
+    void benchmarkShrink();
+};
+
+#endif
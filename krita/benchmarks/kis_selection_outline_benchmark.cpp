@@ -0,0 +1,69 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_selection_outline_benchmark.h"
+
+#include <simpletest.h>
+
+#include "kis_pixel_selection.h"
+
+namespace {
+
+/**
+ * Creates a 4096x4096 selection consisting of a lot of small
+ * islands, similar to what the contiguous selection tool
+ * produces on a noisy image
+ */
+KisPixelSelectionSP createComplexSelection()
+{
+    KisPixelSelectionSP selection = new KisPixelSelection();
+
+    quint32 seed = 1;
+    auto nextRandom = [&seed] (int max) {
+        seed = seed * 1103515245 + 12345;
+        return int((seed >> 16) % max);
+    };
+
+    for (int y = 0; y < 4096; y += 32) {
+        for (int x = 0; x < 4096; x += 32) {
+            selection->select(QRect(x + nextRandom(8), y + nextRandom(8),
+                                    4 + nextRandom(24), 4 + nextRandom(24)));
+        }
+    }
+
+    selection->invalidateOutlineCache();
+    selection->recalculateOutlineCache();
+
+    return selection;
+}
+
+}
+
+void KisSelectionOutlineBenchmark::benchmarkFullOutline()
+{
+    KisPixelSelectionSP selection = createComplexSelection();
+
+    QBENCHMARK {
+        selection->invalidateOutlineCache();
+        selection->recalculateOutlineCache();
+    }
+}
+
+void KisSelectionOutlineBenchmark::benchmarkIncrementalOutline()
+{
+    KisPixelSelectionSP selection = createComplexSelection();
+
+    KisPixelSelectionSP click = new KisPixelSelection();
+    click->select(QRect(2000, 2000, 150, 100));
+    click->invalidateOutlineCache();
+
+    QBENCHMARK {
+        selection->applySelection(click, SELECTION_ADD);
+        selection->recalculateOutlineCache();
+    }
+}
+
+SIMPLE_TEST_MAIN(KisSelectionOutlineBenchmark)
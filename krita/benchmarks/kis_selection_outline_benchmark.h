@@ -0,0 +1,20 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_SELECTION_OUTLINE_BENCHMARK_H
+#define KIS_SELECTION_OUTLINE_BENCHMARK_H
+
+#include <simpletest.h>
+
+class KisSelectionOutlineBenchmark : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void benchmarkFullOutline();
+    void benchmarkIncrementalOutline();
+};
+
+#endif
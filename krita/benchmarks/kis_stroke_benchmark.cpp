@@ -347,6 +347,32 @@ void KisStrokeBenchmark::colorsmudgeRL()
     benchmarkStroke(presetFileName);
 }
 
+void KisStrokeBenchmark::colorsmudge16bit()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb16();
+
+    KisImageSP image = new KisImage(0, m_image->width(), m_image->height(), cs, "stroke sample image 16 bit");
+    KisLayerSP layer = new KisPaintLayer(image, "temporary for stroke sample", OPACITY_OPAQUE_U8, cs);
+    layer->paintDevice()->fill(image->bounds(), KoColor(Qt::white, cs));
+
+    KisPainter painter(layer->paintDevice());
+    painter.setPaintColor(KoColor(Qt::black, cs));
+
+    KisPaintOpPresetSP preset(new KisPaintOpPreset(m_dataPath + "colorsmudge.kpp"));
+    if (!preset->load(KisGlobalResourcesInterface::instance())) {
+        dbgKrita << "The preset was not loaded correctly. Done.";
+        return;
+    }
+
+    painter.setPaintOpPreset(preset, layer, image);
+
+    QBENCHMARK{
+        KisDistanceInformation currentDistance;
+        painter.paintBezierCurve(m_pi1, m_c1, m_c1, m_pi2, &currentDistance);
+        painter.paintBezierCurve(m_pi2, m_c2, m_c2, m_pi3, &currentDistance);
+    }
+}
+
 
 void KisStrokeBenchmark::roundMarker()
 {
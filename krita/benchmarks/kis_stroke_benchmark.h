@@ -114,6 +114,7 @@ private Q_SLOTS:
 
     void colorsmudge();
     void colorsmudgeRL();
+    void colorsmudge16bit();
 
     void roundMarker();
     void roundMarkerRandomLines();
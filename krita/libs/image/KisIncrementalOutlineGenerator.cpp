@@ -0,0 +1,297 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisIncrementalOutlineGenerator.h"
+
+#include <QHash>
+#include <QtConcurrent>
+
+#include <KoColorSpace.h>
+
+#include "kis_algebra_2d.h"
+#include "kis_assert.h"
+#include "kis_paint_device.h"
+
+namespace {
+
+const int tileSize = 64;
+
+struct OutgoingSegments {
+    int first = -1;
+    int second = -1;
+};
+
+inline qint64 pointKey(const QPoint &pt)
+{
+    return (qint64(pt.x()) << 32) | quint32(pt.y());
+}
+
+template <class Segment>
+inline QPoint segmentDirection(const Segment &segment)
+{
+    return QPoint(KisAlgebra2D::signZZ(segment.end.x() - segment.start.x()),
+                  KisAlgebra2D::signZZ(segment.end.y() - segment.start.y()));
+}
+
+}
+
+KisIncrementalOutlineGenerator::KisIncrementalOutlineGenerator(const KoColorSpace *cs, quint8 defaultOpacity)
+    : m_cs(cs),
+      m_defaultOpacity(defaultOpacity),
+      m_allDirty(false)
+{
+}
+
+void KisIncrementalOutlineGenerator::invalidate(const QRect &rc)
+{
+    if (rc.isEmpty() || m_allDirty) return;
+
+    /**
+     * A tile owns the edges on the top and left sides of its pixels,
+     * so the tiles below and to the right of the changed area depend
+     * on it as well.
+     */
+    const QRect affectedRect = rc.adjusted(0, 0, 1, 1);
+
+    const int firstCol = KisAlgebra2D::divideFloor(affectedRect.left(), tileSize);
+    const int lastCol = KisAlgebra2D::divideFloor(affectedRect.right(), tileSize);
+    const int firstRow = KisAlgebra2D::divideFloor(affectedRect.top(), tileSize);
+    const int lastRow = KisAlgebra2D::divideFloor(affectedRect.bottom(), tileSize);
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            m_dirtyTiles.insert(TileIndex(row, col));
+        }
+    }
+}
+
+void KisIncrementalOutlineGenerator::invalidateAll()
+{
+    m_allDirty = true;
+    m_dirtyTiles.clear();
+}
+
+void KisIncrementalOutlineGenerator::reset()
+{
+    m_allDirty = false;
+    m_dirtyTiles.clear();
+    m_fragments.clear();
+}
+
+QVector<QPolygon> KisIncrementalOutlineGenerator::outline(const KisPaintDevice *device, const QRect &rect, const QRect &clipRect)
+{
+    if (clipRect != m_clipRect) {
+        m_clipRect = clipRect;
+        invalidateAll();
+    }
+
+    if (rect.isEmpty()) {
+        reset();
+        return QVector<QPolygon>();
+    }
+
+    // the right and bottom edges of the area belong to the next tiles
+    const QRect coverage = rect.adjusted(0, 0, 1, 1);
+
+    const int firstCol = KisAlgebra2D::divideFloor(coverage.left(), tileSize);
+    const int lastCol = KisAlgebra2D::divideFloor(coverage.right(), tileSize);
+    const int firstRow = KisAlgebra2D::divideFloor(coverage.top(), tileSize);
+    const int lastRow = KisAlgebra2D::divideFloor(coverage.bottom(), tileSize);
+
+    for (auto it = m_fragments.begin(); it != m_fragments.end();) {
+        const TileIndex &index = it.key();
+
+        if (index.first < firstRow || index.first > lastRow ||
+            index.second < firstCol || index.second > lastCol) {
+
+            it = m_fragments.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    struct FragmentJob {
+        TileIndex index;
+        QRect rect;
+        Fragment fragment;
+    };
+
+    QVector<FragmentJob> jobs;
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            const TileIndex index(row, col);
+
+            if (m_allDirty || m_dirtyTiles.contains(index) || !m_fragments.contains(index)) {
+                jobs.append({index, QRect(col * tileSize, row * tileSize, tileSize, tileSize), Fragment()});
+            }
+        }
+    }
+
+    QtConcurrent::blockingMap(jobs, [this, device] (FragmentJob &job) {
+        job.fragment = generateFragment(device, job.rect);
+    });
+
+    Q_FOREACH (const FragmentJob &job, jobs) {
+        m_fragments.insert(job.index, job.fragment);
+    }
+
+    m_dirtyTiles.clear();
+    m_allDirty = false;
+
+    return stitchFragments();
+}
+
+KisIncrementalOutlineGenerator::Fragment
+KisIncrementalOutlineGenerator::generateFragment(const KisPaintDevice *device, const QRect &rect) const
+{
+    // one extra row and column to find the edges on the top and left sides
+    const QRect window = rect.adjusted(-1, -1, 0, 0);
+    const int width = window.width();
+    const int height = window.height();
+
+    QVector<quint8> pixels(width * height * device->pixelSize());
+    device->readBytes(pixels.data(), window);
+
+    QVector<quint8> inside(width * height);
+    m_cs->copyOpacityU8(pixels.data(), inside.data(), width * height);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            quint8 &value = inside[y * width + x];
+            value = value != m_defaultOpacity &&
+                (m_clipRect.isEmpty() || m_clipRect.contains(window.x() + x, window.y() + y));
+        }
+    }
+
+    auto isInside = [&] (int x, int y) {
+        return inside[y * width + x];
+    };
+
+    Fragment fragment;
+
+    // horizontal edges: left-to-right on top of the areas, right-to-left below them
+    for (int y = 1; y < height; y++) {
+        int runStart = 1;
+        int runState = 0;
+
+        for (int x = 1; x <= width; x++) {
+            const int state = x == width ? 0 :
+                isInside(x, y) - isInside(x, y - 1);
+
+            if (state == runState) continue;
+
+            if (runState != 0) {
+                const QPoint left(window.x() + runStart, window.y() + y);
+                const QPoint right(window.x() + x, window.y() + y);
+
+                fragment.append(runState > 0 ? Segment{left, right} : Segment{right, left});
+            }
+
+            runStart = x;
+            runState = state;
+        }
+    }
+
+    // vertical edges: bottom-to-top on the left of the areas, top-to-bottom on the right
+    for (int x = 1; x < width; x++) {
+        int runStart = 1;
+        int runState = 0;
+
+        for (int y = 1; y <= height; y++) {
+            const int state = y == height ? 0 :
+                isInside(x, y) - isInside(x - 1, y);
+
+            if (state == runState) continue;
+
+            if (runState != 0) {
+                const QPoint top(window.x() + x, window.y() + runStart);
+                const QPoint bottom(window.x() + x, window.y() + y);
+
+                fragment.append(runState > 0 ? Segment{bottom, top} : Segment{top, bottom});
+            }
+
+            runStart = y;
+            runState = state;
+        }
+    }
+
+    return fragment;
+}
+
+QVector<QPolygon> KisIncrementalOutlineGenerator::stitchFragments() const
+{
+    QVector<Segment> segments;
+
+    for (auto it = m_fragments.constBegin(); it != m_fragments.constEnd(); ++it) {
+        segments += it.value();
+    }
+
+    QHash<qint64, OutgoingSegments> outgoing;
+    outgoing.reserve(segments.size());
+
+    for (int i = 0; i < segments.size(); i++) {
+        OutgoingSegments &slot = outgoing[pointKey(segments[i].start)];
+
+        if (slot.first < 0) {
+            slot.first = i;
+        } else {
+            slot.second = i;
+        }
+    }
+
+    QVector<QPolygon> polygons;
+    QVector<bool> used(segments.size(), false);
+    QVector<int> loop;
+
+    for (int i = 0; i < segments.size(); i++) {
+        if (used[i]) continue;
+
+        loop.clear();
+        int current = i;
+
+        do {
+            used[current] = true;
+            loop.append(current);
+
+            const Segment &segment = segments[current];
+            const OutgoingSegments next = outgoing.value(pointKey(segment.end));
+
+            /**
+             * Two segments start at the same point only when two pixels
+             * touch diagonally. Turning right keeps them disconnected.
+             */
+            current = next.first;
+            if (next.second >= 0) {
+                const QPoint direction = segmentDirection(segment);
+                const QPoint rightTurn(-direction.y(), direction.x());
+
+                if (segmentDirection(segments[next.second]) == rightTurn) {
+                    current = next.second;
+                }
+            }
+        } while (current >= 0 && !used[current]);
+
+        KIS_SAFE_ASSERT_RECOVER(current == i) { continue; }
+
+        QPolygon polygon;
+        QPoint prevDirection = segmentDirection(segments[loop.last()]);
+
+        Q_FOREACH (int index, loop) {
+            const QPoint direction = segmentDirection(segments[index]);
+
+            // segments split by the tile borders are merged back here
+            if (direction != prevDirection) {
+                polygon << segments[index].start;
+            }
+            prevDirection = direction;
+        }
+
+        polygons.append(polygon);
+    }
+
+    return polygons;
+}
@@ -0,0 +1,98 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISINCREMENTALOUTLINEGENERATOR_H
+#define KISINCREMENTALOUTLINEGENERATOR_H
+
+#include <QMap>
+#include <QPair>
+#include <QPolygon>
+#include <QRect>
+#include <QSet>
+#include <QVector>
+
+#include "kritaimage_export.h"
+
+class KoColorSpace;
+class KisPaintDevice;
+
+
+/**
+ * Generates an outline of a paint device the same way KisOutlineGenerator
+ * does, but keeps the boundary of every tile cached between the calls.
+ *
+ * The boundary of the device is split into per-tile fragments: each tile
+ * owns the edges lying on the top and left sides of its pixels. When the
+ * device changes, the owner of the change should call invalidate() with
+ * the changed rect and only the fragments of the touched tiles will be
+ * regenerated on the next call to outline(). The fragments are then
+ * stitched into closed polygons.
+ *
+ * The polygons are traced clockwise around the non-transparent areas and
+ * counter-clockwise around the holes. Diagonally touching pixels are
+ * considered disconnected.
+ */
+class KRITAIMAGE_EXPORT KisIncrementalOutlineGenerator
+{
+public:
+    /**
+     * @param cs colorspace of the device passed to the generator
+     * @param defaultOpacity opacity of pixels that shouldn't be included in the outline
+     */
+    KisIncrementalOutlineGenerator(const KoColorSpace *cs, quint8 defaultOpacity);
+
+    /**
+     * Marks the fragments depending on the pixels of \p rc as dirty
+     */
+    void invalidate(const QRect &rc);
+
+    /**
+     * Marks all the cached fragments as dirty
+     */
+    void invalidateAll();
+
+    /**
+     * Drops all the cached fragments. Should be used when the device
+     * becomes fully transparent.
+     */
+    void reset();
+
+    /**
+     * Generates the outline, regenerating the dirty fragments only.
+     *
+     * @param device the device to generate the outline for
+     * @param rect the rect that contains all the non-transparent pixels of
+     *             the device. The fragments outside it are dropped.
+     * @param clipRect if not empty, the pixels outside this rect are
+     *                 considered transparent. Changing the clip rect
+     *                 invalidates all the fragments.
+     * @returns list of polygons around every non-transparent area
+     */
+    QVector<QPolygon> outline(const KisPaintDevice *device, const QRect &rect, const QRect &clipRect = QRect());
+
+private:
+    struct Segment {
+        QPoint start;
+        QPoint end;
+    };
+
+    typedef QPair<int, int> TileIndex;
+    typedef QVector<Segment> Fragment;
+
+    Fragment generateFragment(const KisPaintDevice *device, const QRect &rect) const;
+    QVector<QPolygon> stitchFragments() const;
+
+private:
+    const KoColorSpace *m_cs;
+    quint8 m_defaultOpacity;
+
+    QRect m_clipRect;
+    QMap<TileIndex, Fragment> m_fragments;
+    QSet<TileIndex> m_dirtyTiles;
+    bool m_allDirty;
+};
+
+#endif // KISINCREMENTALOUTLINEGENERATOR_H
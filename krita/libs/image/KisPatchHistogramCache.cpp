@@ -0,0 +1,202 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPatchHistogramCache.h"
+
+#include <limits>
+#include <numeric>
+
+#include <QtConcurrentMap>
+
+#include <KoColorSpace.h>
+
+#include "kis_paint_device.h"
+#include "kis_sequential_iterator.h"
+#include "krita_utils.h"
+
+struct KisPatchHistogramCache::Private
+{
+    KisPaintDeviceWSP device;
+    const KoColorSpace *colorSpace = 0;
+    QRect bounds;
+
+    QVector<QRect> patchRects;
+    std::vector<Bins> patchBins;
+    QVector<int> patchRevisions;
+    QVector<int> patchCachedRevisions;
+    int revisionCounter = 0;
+};
+
+KisPatchHistogramCache::KisPatchHistogramCache()
+    : m_d(new Private)
+{
+}
+
+KisPatchHistogramCache::~KisPatchHistogramCache()
+{
+}
+
+bool KisPatchHistogramCache::resetIfIncompatible(KisPaintDeviceSP device, const QRect &bounds)
+{
+    if (m_d->device == device.data() &&
+        m_d->colorSpace == device->colorSpace() &&
+        m_d->bounds == bounds) {
+
+        return false;
+    }
+
+    m_d->device = device;
+    m_d->colorSpace = device->colorSpace();
+    m_d->bounds = bounds;
+
+    m_d->patchRects = KritaUtils::splitRectIntoPatches(bounds, KritaUtils::optimalPatchSize());
+
+    m_d->patchBins.clear();
+    m_d->patchBins.resize(m_d->patchRects.size());
+
+    // a cached revision of -1 means that the patch has never been calculated
+    m_d->patchRevisions.fill(++m_d->revisionCounter, m_d->patchRects.size());
+    m_d->patchCachedRevisions.fill(-1, m_d->patchRects.size());
+
+    return true;
+}
+
+void KisPatchHistogramCache::invalidateRect(const QRect &rect)
+{
+    for (int i = 0; i < m_d->patchRects.size(); i++) {
+        if (m_d->patchRects[i].intersects(rect)) {
+            m_d->patchRevisions[i] = ++m_d->revisionCounter;
+        }
+    }
+}
+
+void KisPatchHistogramCache::invalidateAll()
+{
+    m_d->patchRevisions.fill(++m_d->revisionCounter);
+}
+
+QVector<KisPatchHistogramCache::PatchJob> KisPatchHistogramCache::dirtyPatches() const
+{
+    QVector<PatchJob> jobs;
+
+    for (int i = 0; i < m_d->patchRects.size(); i++) {
+        if (m_d->patchCachedRevisions[i] != m_d->patchRevisions[i]) {
+            jobs << PatchJob{i, m_d->patchRevisions[i], m_d->patchRects[i]};
+        }
+    }
+
+    return jobs;
+}
+
+bool KisPatchHistogramCache::setPatchResult(const PatchJob &job, Bins &&bins)
+{
+    if (job.index < 0 || job.index >= m_d->patchRects.size() ||
+        m_d->patchRevisions[job.index] != job.revision) {
+
+        return false;
+    }
+
+    m_d->patchBins[job.index] = std::move(bins);
+    m_d->patchCachedRevisions[job.index] = job.revision;
+
+    return true;
+}
+
+void KisPatchHistogramCache::update(KisPaintDeviceSP device, const QRect &bounds)
+{
+    resetIfIncompatible(device, bounds);
+
+    const QVector<PatchJob> jobs = dirtyPatches();
+    const int step = sampleStep();
+
+    std::vector<Bins> results(jobs.size());
+    QVector<int> indexes(jobs.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+
+    QtConcurrent::blockingMap(indexes, [&] (int i) {
+        results[i] = calculatePatch(device, jobs[i].rect, step);
+    });
+
+    for (int i = 0; i < jobs.size(); i++) {
+        setPatchResult(jobs[i], std::move(results[i]));
+    }
+}
+
+KisPatchHistogramCache::Bins KisPatchHistogramCache::mergedBins() const
+{
+    Bins bins;
+
+    if (!m_d->colorSpace) return bins;
+
+    const int channelCount = m_d->colorSpace->channelCount();
+    bins.resize(channelCount);
+    for (auto &channelBins : bins) {
+        channelBins.assign(std::numeric_limits<quint8>::max() + 1, 0);
+    }
+
+    for (const Bins &patch : m_d->patchBins) {
+        // the patch may be empty if it has never been calculated
+        if (int(patch.size()) != channelCount) continue;
+
+        for (int chan = 0; chan < channelCount; chan++) {
+            const std::vector<quint32> &src = patch[chan];
+            std::vector<quint32> &dst = bins[chan];
+
+            for (int bi = 0; bi < int(dst.size()); bi++) {
+                dst[bi] += src[bi];
+            }
+        }
+    }
+
+    return bins;
+}
+
+const KoColorSpace* KisPatchHistogramCache::colorSpace() const
+{
+    return m_d->colorSpace;
+}
+
+int KisPatchHistogramCache::sampleStep() const
+{
+    const quint32 size = m_d->bounds.width() * m_d->bounds.height();
+    return 1 + (size >> 20); //for speed use about 1M pixels for computing histograms
+}
+
+KisPatchHistogramCache::Bins KisPatchHistogramCache::calculatePatch(KisPaintDeviceSP device, const QRect &rect, int sampleStep)
+{
+    const KoColorSpace *cs = device->colorSpace();
+    const int channelCount = cs->channelCount();
+    const int pixelSize = cs->pixelSize();
+
+    Bins bins(channelCount);
+    for (auto &channelBins : bins) {
+        channelBins.assign(std::numeric_limits<quint8>::max() + 1, 0);
+    }
+
+    if (rect.isEmpty()) return bins;
+
+    int toSkip = sampleStep;
+
+    KisSequentialConstIterator it(device, rect);
+
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+
+        numConseqPixels = it.nConseqPixels();
+        const quint8* pixel = it.rawDataConst();
+        for (int k = 0; k < numConseqPixels; ++k) {
+            if (--toSkip == 0) {
+                for (int chan = 0; chan < channelCount; ++chan) {
+                    bins[chan][cs->scaleToU8(pixel, chan)]++;
+                }
+                toSkip = sampleStep;
+            }
+            pixel += pixelSize;
+        }
+    }
+
+    return bins;
+}
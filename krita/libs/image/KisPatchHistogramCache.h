@@ -0,0 +1,113 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPATCHHISTOGRAMCACHE_H
+#define KISPATCHHISTOGRAMCACHE_H
+
+#include <vector>
+
+#include <QScopedPointer>
+#include <QRect>
+#include <QVector>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KoColorSpace;
+
+
+/**
+ * Keeps the histogram of a paint device as a set of per-patch partial
+ * histograms. After a small change of the device only the patches
+ * intersecting the changed rects are rescanned, the rest is just merged
+ * again.
+ *
+ * Every channel has 256 bins, the values are scaled with
+ * KoColorSpace::scaleToU8(). On large devices only every n-th pixel is
+ * sampled, see sampleStep().
+ *
+ * Every invalidation assigns a new unique revision to the patch. A result
+ * is accepted only if it was calculated at the current revision of the
+ * patch, so the results of asynchronous calculations that raced with a
+ * change of the device (or with a reset of the cache) are dropped.
+ *
+ * The patches can be calculated on any thread with calculatePatch(), but
+ * the cache itself should be used from one thread only.
+ */
+class KRITAIMAGE_EXPORT KisPatchHistogramCache
+{
+public:
+    /// bins[channel][value]
+    using Bins = std::vector<std::vector<quint32>>;
+
+    struct PatchJob {
+        int index = -1;
+        int revision = -1;
+        QRect rect;
+    };
+
+public:
+    KisPatchHistogramCache();
+    ~KisPatchHistogramCache();
+
+    /**
+     * Drops all the patches if \p device, its color space or \p bounds
+     * differ from the ones the cache was built for.
+     *
+     * @return true if the cache has been reset
+     */
+    bool resetIfIncompatible(KisPaintDeviceSP device, const QRect &bounds);
+
+    /**
+     * Marks the patches intersecting \p rect as outdated
+     */
+    void invalidateRect(const QRect &rect);
+    void invalidateAll();
+
+    /**
+     * @return the patches that should be recalculated and the revisions
+     * they should be calculated at
+     */
+    QVector<PatchJob> dirtyPatches() const;
+
+    /**
+     * Stores the result of a patch calculated with calculatePatch()
+     *
+     * @return false if the patch has been invalidated since \p job was
+     * created, then the result is dropped
+     */
+    bool setPatchResult(const PatchJob &job, Bins &&bins);
+
+    /**
+     * Recalculates all the dirty patches of \p device in parallel and
+     * stores the results
+     */
+    void update(KisPaintDeviceSP device, const QRect &bounds);
+
+    /**
+     * @return the sum of the histograms of all the calculated patches
+     */
+    Bins mergedBins() const;
+
+    /**
+     * The color space the cache was built for
+     */
+    const KoColorSpace* colorSpace() const;
+
+    /**
+     * Every sampleStep()-th pixel is sampled to keep the number of
+     * samples around one million
+     */
+    int sampleStep() const;
+
+    static Bins calculatePatch(KisPaintDeviceSP device, const QRect &rect, int sampleStep);
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISPATCHHISTOGRAMCACHE_H
@@ -9,10 +9,13 @@
 
 #include <kritaimage_export.h>
 
+#include <numeric>
+
 #include <QScopedPointer>
 #include <QVector>
 #include <QPointF>
 #include <QSize>
+#include <QtConcurrent>
 
 #include "kis_bspline.h"
 
@@ -53,6 +56,10 @@ public:
         return newSpline;
     }
 
+    /**
+     * Samples \p op on the grid of the spline. The columns of the grid
+     * are sampled in parallel, so \p op must be reentrant.
+     */
     template <class FunctionOp>
     inline void initializeSpline(const FunctionOp &op) {
 
@@ -60,16 +67,20 @@ public:
         float yStep = (m_yEnd - m_yStart) / (m_numSamplesY - 1);
 
         QVector<float> values(m_numSamplesX * m_numSamplesY);
+        float *samples = values.data();
+
+        QVector<int> columns(m_numSamplesX);
+        std::iota(columns.begin(), columns.end(), 0);
 
-        for (int x = 0; x < m_numSamplesX; x++) {
+        QtConcurrent::blockingMap(columns, [&] (int x) {
             float fx = m_xStart + xStep * x;
 
             for (int y = 0; y < m_numSamplesY; y++) {
                 float fy = m_yStart + yStep * y;
                 float v = op(fx, fy);
-                values[x * m_numSamplesY + y] = v;
+                samples[x * m_numSamplesY + y] = v;
             }
-        }
+        });
 
         initializeSplineImpl(values);
     }
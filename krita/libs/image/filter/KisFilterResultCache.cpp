@@ -0,0 +1,544 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisFilterResultCache.h"
+
+#include <QAtomicInteger>
+#include <QCache>
+#include <QGlobalStatic>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegion>
+#include <QVector>
+
+#include <cstring>
+#include <limits>
+
+#include <KoColorSpace.h>
+
+#include "kis_algebra_2d.h"
+#include "kis_default_bounds_base.h"
+#include "kis_image_config.h"
+#include "kis_paint_device.h"
+#include "filter/kis_filter.h"
+#include "filter/kis_filter_configuration.h"
+
+namespace {
+
+const int cellSize = 128;
+
+const quint64 prime1 = 0x9E3779B185EBCA87ULL;
+const quint64 prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+struct CellKey {
+    int levelOfDetail;
+    int row;
+    int col;
+
+    bool operator==(const CellKey &rhs) const {
+        return levelOfDetail == rhs.levelOfDetail && row == rhs.row && col == rhs.col;
+    }
+};
+
+inline uint qHash(const CellKey &key, uint seed = 0)
+{
+    return ::qHash(key.row, seed) ^ ::qHash(key.col, seed) * 31 ^ ::qHash(key.levelOfDetail, seed) * 961;
+}
+
+inline quint64 rotateLeft(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * A simple 64-bit non-cryptographic hash. qHashBits() returns only 32
+ * bits, which is too little to identify the content of a cell reliably.
+ * Four independent lanes are used to keep the CPU pipeline busy.
+ */
+quint64 hashBytes(const quint8 *data, int size)
+{
+    quint64 lanes[4] = {prime1 + prime2, prime2, 0, quint64(0) - prime1};
+
+    auto mix = [] (quint64 acc, quint64 value) {
+        return rotateLeft(acc + value * prime2, 31) * prime1;
+    };
+
+    const quint8 *ptr = data;
+    const quint8 *const end = data + size;
+
+    for (; end - ptr >= 32; ptr += 32) {
+        quint64 words[4];
+        memcpy(words, ptr, sizeof(words));
+
+        for (int i = 0; i < 4; i++) {
+            lanes[i] = mix(lanes[i], words[i]);
+        }
+    }
+
+    quint64 hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) +
+        rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+    hash += quint64(size);
+
+    for (; ptr < end; ptr++) {
+        hash = rotateLeft(hash ^ (*ptr * prime1), 11) * prime2;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+
+    return hash;
+}
+
+/**
+ * Hashes a \p rows x \p rowBytes block of a larger buffer with
+ * \p stride bytes per row, so that the hashes of all the cells of a band
+ * can be computed from a single read of the source device.
+ */
+quint64 hashRect(const quint8 *data, int stride, int rowBytes, int rows)
+{
+    quint64 hash = prime1;
+
+    for (int y = 0; y < rows; y++) {
+        hash = rotateLeft(hash ^ hashBytes(data + y * stride, rowBytes), 27) * prime2;
+    }
+
+    return hash;
+}
+
+/**
+ * The memory used by the caches of all the filter nodes together. Every
+ * cache has its own limit, but the number of filter nodes in an image
+ * is not bounded, so the sum is limited separately by
+ * KisImageConfig::filterResultCacheTotalLimit().
+ */
+class TotalMemoryBudget
+{
+public:
+    TotalMemoryBudget()
+        : m_limit(qint64(KisImageConfig(true).filterResultCacheTotalLimit()) * 1024 * 1024)
+    {
+    }
+
+    bool tryAcquire(qint64 bytes) {
+        qint64 used = m_used.loadAcquire();
+
+        do {
+            if (used + bytes > m_limit.loadAcquire()) {
+                return false;
+            }
+        } while (!m_used.testAndSetOrdered(used, used + bytes, used));
+
+        return true;
+    }
+
+    void release(qint64 bytes) {
+        m_used.fetchAndAddOrdered(-bytes);
+    }
+
+    qint64 used() const {
+        return m_used.loadAcquire();
+    }
+
+    qint64 limit() const {
+        return m_limit.loadAcquire();
+    }
+
+    void setLimit(qint64 value) {
+        m_limit.storeRelease(value);
+    }
+
+private:
+    QAtomicInteger<qint64> m_used {0};
+    QAtomicInteger<qint64> m_limit;
+};
+
+Q_GLOBAL_STATIC(TotalMemoryBudget, s_totalBudget)
+
+struct CellResult {
+    CellResult(quint64 _inputHash,
+               const KoColorSpace *_srcColorSpace,
+               const KoColorSpace *_dstColorSpace,
+               const QByteArray &_pixels)
+        : inputHash(_inputHash),
+          srcColorSpace(_srcColorSpace),
+          dstColorSpace(_dstColorSpace),
+          pixels(_pixels)
+    {
+    }
+
+    ~CellResult() {
+        // the caches of the nodes may outlive the budget on exit
+        if (!s_totalBudget.isDestroyed()) {
+            s_totalBudget->release(pixels.size());
+        }
+    }
+
+    Q_DISABLE_COPY(CellResult)
+
+    quint64 inputHash;
+    const KoColorSpace *srcColorSpace;
+    const KoColorSpace *dstColorSpace;
+    QByteArray pixels;
+};
+
+/**
+ * KisPropertiesConfiguration::compareTo() only iterates over the
+ * properties of the left-hand side, so compare in both directions.
+ */
+bool sameFilterSettings(const KisFilterConfigurationSP lhs, const KisFilterConfigurationSP rhs)
+{
+    return lhs->name() == rhs->name() &&
+        lhs->version() == rhs->version() &&
+        lhs->compareTo(rhs.constData()) &&
+        rhs->compareTo(lhs.constData());
+}
+
+struct CellInfo {
+    CellKey key;
+    QRect rect;
+    quint64 inputHash = 0;
+    QByteArray cachedPixels;
+};
+
+}
+
+struct KisFilterResultCache::Private
+{
+    QMutex mutex;
+    QCache<CellKey, CellResult> cells;
+
+    /**
+     * The input hashes of the cells that were filtered but not stored
+     * yet. A cell is stored only when it is filtered again with the same
+     * input, so the first render of a node doesn't pay for copying its
+     * result into the cache, and cells that change on every update (e.g.
+     * under the brush) are never stored.
+     */
+    QHash<CellKey, quint64> seenHashes;
+
+    KisFilterConfigurationSP config;
+
+    /**
+     * The image bounds the cells of every level of detail were filtered
+     * for. The bounds of the LoD planes differ, so they are tracked per
+     * level, and switching the level of detail doesn't drop the cells of
+     * the other levels.
+     */
+    QHash<int, QRect> imageBounds;
+    bool memoryLimitInitialized = false;
+
+    qint64 hits = 0;
+    qint64 misses = 0;
+    qint64 uncachedPixels = 0;
+
+    void resetIfIncompatible(const KisFilterConfigurationSP newConfig, int lod, const QRect &newImageBounds);
+    void clearCells();
+    void clearCells(int lod);
+};
+
+void KisFilterResultCache::Private::resetIfIncompatible(const KisFilterConfigurationSP newConfig, int lod, const QRect &newImageBounds)
+{
+    if (newConfig != config &&
+        (!config || !sameFilterSettings(newConfig, config))) {
+
+        clearCells();
+    }
+
+    auto it = imageBounds.find(lod);
+    if (it == imageBounds.end()) {
+        imageBounds.insert(lod, newImageBounds);
+    } else if (*it != newImageBounds) {
+        clearCells(lod);
+        *it = newImageBounds;
+    }
+
+    config = newConfig;
+}
+
+void KisFilterResultCache::Private::clearCells()
+{
+    cells.clear();
+    seenHashes.clear();
+    imageBounds.clear();
+}
+
+void KisFilterResultCache::Private::clearCells(int lod)
+{
+    Q_FOREACH (const CellKey &key, cells.keys()) {
+        if (key.levelOfDetail == lod) {
+            cells.remove(key);
+        }
+    }
+
+    for (auto it = seenHashes.begin(); it != seenHashes.end();) {
+        if (it.key().levelOfDetail == lod) {
+            it = seenHashes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+KisFilterResultCache::KisFilterResultCache()
+    : m_d(new Private)
+{
+}
+
+KisFilterResultCache::~KisFilterResultCache()
+{
+}
+
+void KisFilterResultCache::process(const KisFilter *filter,
+                                   const KisFilterConfigurationSP config,
+                                   KisPaintDeviceSP src,
+                                   KisPaintDeviceSP dst,
+                                   const QRect &rc)
+{
+    const int lod = src->defaultBounds()->currentLevelOfDetail();
+    bool enabled = false;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        /**
+         * Every filter node owns a cache, so we read the config only
+         * when the cache is actually used for the first time.
+         */
+        if (!m_d->memoryLimitInitialized) {
+            KisImageConfig cfg(true);
+            m_d->cells.setMaxCost(cfg.filterResultCacheLimit() * 1024);
+            m_d->memoryLimitInitialized = true;
+        }
+
+        m_d->resetIfIncompatible(config, lod, dst->defaultBounds()->bounds());
+        enabled = m_d->cells.maxCost() > 0 && s_totalBudget->limit() > 0;
+    }
+
+    // only the cells fully covered by the rect are cached
+    const int firstCol = KisAlgebra2D::divideFloor(rc.left() + cellSize - 1, cellSize);
+    const int lastCol = KisAlgebra2D::divideFloor(rc.right() + 1, cellSize) - 1;
+    const int firstRow = KisAlgebra2D::divideFloor(rc.top() + cellSize - 1, cellSize);
+    const int lastRow = KisAlgebra2D::divideFloor(rc.bottom() + 1, cellSize) - 1;
+
+    /**
+     * The rect is filtered in several calls below, which is not possible
+     * in-place: a call would read the pixels already filtered by the
+     * previous one.
+     */
+    if (!enabled || src == dst || firstCol > lastCol || firstRow > lastRow) {
+        filter->process(src, dst, 0, rc, config, 0);
+
+        QMutexLocker l(&m_d->mutex);
+        m_d->uncachedPixels += qint64(rc.width()) * rc.height();
+        return;
+    }
+
+    const QRect cellsRect(firstCol * cellSize, firstRow * cellSize,
+                          (lastCol - firstCol + 1) * cellSize,
+                          (lastRow - firstRow + 1) * cellSize);
+
+    /**
+     * Hash the input of every cell. The source is read once per row of
+     * cells, the need rects of the neighbouring cells overlap only by the
+     * filter's borders.
+     */
+    QVector<CellInfo> cells;
+    cells.reserve((lastRow - firstRow + 1) * (lastCol - firstCol + 1));
+
+    const int pixelSize = src->pixelSize();
+    QByteArray input;
+
+    for (int row = firstRow; row <= lastRow; row++) {
+        QRect bandNeedRect;
+
+        for (int col = firstCol; col <= lastCol; col++) {
+            const QRect cellRect(col * cellSize, row * cellSize, cellSize, cellSize);
+            bandNeedRect |= filter->neededRect(cellRect, config, lod);
+        }
+
+        const int stride = bandNeedRect.width() * pixelSize;
+        input.resize(stride * bandNeedRect.height());
+        src->readBytes(reinterpret_cast<quint8*>(input.data()), bandNeedRect);
+
+        for (int col = firstCol; col <= lastCol; col++) {
+            CellInfo cell;
+            cell.key = CellKey {lod, row, col};
+            cell.rect = QRect(col * cellSize, row * cellSize, cellSize, cellSize);
+
+            const QRect needRect = filter->neededRect(cell.rect, config, lod);
+            const quint8 *needData =
+                reinterpret_cast<const quint8*>(input.constData()) +
+                (needRect.y() - bandNeedRect.y()) * stride +
+                (needRect.x() - bandNeedRect.x()) * pixelSize;
+
+            cell.inputHash = hashRect(needData, stride, needRect.width() * pixelSize, needRect.height());
+            cells.append(cell);
+        }
+    }
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        for (CellInfo &cell : cells) {
+            CellResult *result = m_d->cells.object(cell.key);
+
+            if (result &&
+                result->inputHash == cell.inputHash &&
+                *result->srcColorSpace == *src->colorSpace() &&
+                *result->dstColorSpace == *dst->colorSpace()) {
+
+                cell.cachedPixels = result->pixels;
+            }
+        }
+    }
+
+    /**
+     * The cells that are not served from the cache are filtered in as few
+     * calls as possible: the consecutive missed cells of a row are merged,
+     * and the runs spanning the same columns in consecutive rows are
+     * merged again, so a full miss is still a single call. Filtering them
+     * cell by cell would pay for the filter's need borders of every cell.
+     * The border strips of the rect that are not covered by the cells are
+     * filtered separately, so they never force the cached cells to be
+     * filtered again.
+     */
+    QVector<QRect> missedRects;
+    QVector<int> previousRowRuns;
+
+    for (int i = 0; i < cells.size();) {
+        const int row = cells[i].key.row;
+        QVector<int> currentRowRuns;
+
+        for (; i < cells.size() && cells[i].key.row == row; i++) {
+            if (!cells[i].cachedPixels.isNull()) continue;
+
+            QRect run = cells[i].rect;
+            for (; i + 1 < cells.size() &&
+                 cells[i + 1].key.row == row &&
+                 cells[i + 1].cachedPixels.isNull(); i++) {
+
+                run |= cells[i + 1].rect;
+            }
+
+            bool merged = false;
+            Q_FOREACH (int index, previousRowRuns) {
+                QRect &rect = missedRects[index];
+
+                if (rect.left() == run.left() && rect.right() == run.right()) {
+                    rect.setBottom(run.bottom());
+                    currentRowRuns.append(index);
+                    merged = true;
+                    break;
+                }
+            }
+
+            if (!merged) {
+                missedRects.append(run);
+                currentRowRuns.append(missedRects.size() - 1);
+            }
+        }
+
+        previousRowRuns = currentRowRuns;
+    }
+
+    const QRegion uncoveredRegion = QRegion(rc) - cellsRect;
+
+    for (const QRect &rect : missedRects) {
+        filter->process(src, dst, 0, rect, config, 0);
+    }
+
+    for (const QRect &rect : uncoveredRegion) {
+        filter->process(src, dst, 0, rect, config, 0);
+    }
+
+    qint64 hits = 0;
+    QVector<CellInfo*> storeCandidates;
+
+    {
+        QMutexLocker l(&m_d->mutex);
+
+        for (CellInfo &cell : cells) {
+            // the valid cells are already stored
+            if (!cell.cachedPixels.isNull()) continue;
+
+            auto it = m_d->seenHashes.find(cell.key);
+
+            if (it != m_d->seenHashes.end() && *it == cell.inputHash) {
+                storeCandidates.append(&cell);
+            } else {
+                m_d->seenHashes.insert(cell.key, cell.inputHash);
+            }
+        }
+    }
+
+    for (CellInfo &cell : cells) {
+        if (!cell.cachedPixels.isNull()) {
+            dst->writeBytes(reinterpret_cast<const quint8*>(cell.cachedPixels.constData()), cell.rect);
+            hits++;
+        }
+    }
+
+    for (CellInfo *cell : storeCandidates) {
+        QByteArray pixels(cellSize * cellSize * dst->pixelSize(), Qt::Uninitialized);
+
+        if (!s_totalBudget->tryAcquire(pixels.size())) break;
+
+        dst->readBytes(reinterpret_cast<quint8*>(pixels.data()), cell->rect);
+
+        QMutexLocker l(&m_d->mutex);
+        m_d->seenHashes.remove(cell->key);
+        m_d->cells.insert(cell->key,
+                          new CellResult(cell->inputHash, src->colorSpace(), dst->colorSpace(), pixels),
+                          pixels.size() / 1024);
+    }
+
+    qint64 uncachedPixels = 0;
+    for (const QRect &rect : uncoveredRegion) {
+        uncachedPixels += qint64(rect.width()) * rect.height();
+    }
+
+    QMutexLocker l(&m_d->mutex);
+    m_d->hits += hits;
+    m_d->misses += cells.size() - hits;
+    m_d->uncachedPixels += uncachedPixels;
+}
+
+void KisFilterResultCache::clear()
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->clearCells();
+    m_d->config.clear();
+}
+
+void KisFilterResultCache::setMemoryLimit(qint64 value)
+{
+    QMutexLocker l(&m_d->mutex);
+    m_d->cells.setMaxCost(int(qMin(value / 1024, qint64(std::numeric_limits<int>::max()))));
+    m_d->memoryLimitInitialized = true;
+}
+
+void KisFilterResultCache::setTotalMemoryLimit(qint64 value)
+{
+    s_totalBudget->setLimit(value);
+}
+
+KisFilterResultCache::Stats KisFilterResultCache::stats() const
+{
+    QMutexLocker l(&m_d->mutex);
+
+    Stats stats;
+    stats.hits = m_d->hits;
+    stats.misses = m_d->misses;
+    stats.uncachedPixels = m_d->uncachedPixels;
+    stats.memoryUsage = qint64(m_d->cells.totalCost()) * 1024;
+    stats.memoryLimit = qint64(m_d->cells.maxCost()) * 1024;
+    stats.totalMemoryUsage = s_totalBudget->used();
+    stats.totalMemoryLimit = s_totalBudget->limit();
+
+    return stats;
+}
@@ -0,0 +1,107 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISFILTERRESULTCACHE_H
+#define KISFILTERRESULTCACHE_H
+
+#include <QScopedPointer>
+#include <QRect>
+
+#include "kis_types.h"
+#include "kritaimage_export.h"
+
+class KisFilter;
+
+
+/**
+ * Caches the results of a filter applied by a filter mask or an
+ * adjustment layer.
+ *
+ * The processed area is split into square cells aligned to a grid. For
+ * every cell that lies fully inside the processed rect, a hash of the
+ * source pixels in the filter's need rect of that cell is computed. When
+ * the same cell is requested again and the source pixels have not
+ * changed, the stored result is copied into the destination device
+ * instead of running the filter again. That happens, for example, when a
+ * layer below the mask is changed and then the change is undone, or when
+ * a node above the mask is changed and the merge walker asks to recompose
+ * the whole stack.
+ *
+ * The cache doesn't slow down the first render much: the adjacent cells
+ * that are not found in the cache are filtered together, and a cell
+ * result is stored only when the cell is filtered for the second time
+ * with the same input. Until then only its input hash is remembered. The cost of
+ * a render that doesn't hit the cache is reading and hashing the source.
+ *
+ * Since the cells are keyed by the content of their input, the cache
+ * doesn't need to be invalidated when the source device changes. It is
+ * dropped when the filter configuration changes. The cells of a level of
+ * detail are dropped when the image bounds at that level change.
+ *
+ * In-place processing (\p src == \p dst) is never cached.
+ *
+ * The amount of memory used by the cache is limited by
+ * KisImageConfig::filterResultCacheLimit(). When the limit is reached, the
+ * least recently used cells are evicted. The memory used by the caches of
+ * all the nodes together is limited by
+ * KisImageConfig::filterResultCacheTotalLimit(); when that limit is
+ * reached, new cells are not stored until other caches free some memory.
+ *
+ * The cache is thread-safe, several update jobs can use it concurrently.
+ */
+class KRITAIMAGE_EXPORT KisFilterResultCache
+{
+public:
+    struct Stats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 uncachedPixels = 0;
+        qint64 memoryUsage = 0; // bytes
+        qint64 memoryLimit = 0; // bytes
+        qint64 totalMemoryUsage = 0; // bytes, all the caches
+        qint64 totalMemoryLimit = 0; // bytes, all the caches
+    };
+
+public:
+    KisFilterResultCache();
+    ~KisFilterResultCache();
+
+    /**
+     * Processes \p rc of \p src with \p filter and writes the result
+     * into \p dst, the same way KisFilter::process() does, using the
+     * cached results where possible.
+     */
+    void process(const KisFilter *filter,
+                 const KisFilterConfigurationSP config,
+                 KisPaintDeviceSP src,
+                 KisPaintDeviceSP dst,
+                 const QRect &rc);
+
+    /**
+     * Drops all the cached results
+     */
+    void clear();
+
+    /**
+     * Sets the maximum amount of memory used by the cache in bytes. Zero
+     * limit disables the cache.
+     */
+    void setMemoryLimit(qint64 value);
+
+    /**
+     * Sets the maximum amount of memory used by the caches of all the
+     * filter nodes together in bytes. Zero limit disables all the caches.
+     */
+    static void setTotalMemoryLimit(qint64 value);
+
+    Stats stats() const;
+
+private:
+    struct Private;
+    const QScopedPointer<Private> m_d;
+};
+
+#endif // KISFILTERRESULTCACHE_H
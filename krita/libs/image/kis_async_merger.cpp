@@ -23,6 +23,7 @@
 #include "filter/kis_filter.h"
 #include "filter/kis_filter_configuration.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/KisFilterResultCache.h"
 #include "kis_selection.h"
 #include "kis_clone_layer.h"
 #include "kis_processing_information.h"
@@ -111,7 +112,7 @@ public:
             layer->busyProgressIndicator()->update();
 
             // We do not create a transaction here, as srcDevice != dstDevice
-            filter->process(m_projection, dstDevice, 0, filterRect, filterConfig.data(), 0);
+            layer->filterResultCache()->process(filter.data(), filterConfig, m_projection, dstDevice, filterRect);
         }
 
         if (selection) {
@@ -22,9 +22,7 @@
 #include <resources/KoPattern.h>
 #include "kis_selection.h"
 
-#include <KisSequentialIteratorProgress.h>
 #include "kis_image.h"
-#include "kis_random_accessor_ng.h"
 #include "kis_gradient_shape_strategy.h"
 #include "kis_polygonal_gradient_shape_strategy.h"
 #include "kis_cached_gradient_shape_strategy.h"
@@ -33,6 +31,9 @@
 #include <KisDitherOp.h>
 #include <KoCachedGradient.h>
 
+#include <QMutex>
+#include <QtConcurrent>
+
 namespace
 {
 
@@ -43,6 +44,7 @@ public:
     LinearGradientStrategy(const QPointF& gradientVectorStart, const QPointF& gradientVectorEnd);
 
     double valueAt(double x, double y) const override;
+    void valuesAt(double x, double y, int count, double *values) const override;
 
 protected:
     double m_normalisedVectorX;
@@ -85,6 +87,22 @@ double LinearGradientStrategy::valueAt(double x, double y) const
     return t;
 }
 
+void LinearGradientStrategy::valuesAt(double x, double y, int count, double *values) const
+{
+    if (m_vectorLength < DBL_EPSILON) {
+        std::fill(values, values + count, 0.0);
+        return;
+    }
+
+    const double vy = y - m_gradientVectorStart.y();
+    const double projectedY = vy * m_normalisedVectorY;
+
+    for (int i = 0; i < count; i++) {
+        const double vx = x + i - m_gradientVectorStart.x();
+        values[i] = (vx * m_normalisedVectorX + projectedY) / m_vectorLength;
+    }
+}
+
 
 class BiLinearGradientStrategy : public LinearGradientStrategy
 {
@@ -93,6 +111,7 @@ public:
     BiLinearGradientStrategy(const QPointF& gradientVectorStart, const QPointF& gradientVectorEnd);
 
     double valueAt(double x, double y) const override;
+    void valuesAt(double x, double y, int count, double *values) const override;
 };
 
 BiLinearGradientStrategy::BiLinearGradientStrategy(const QPointF& gradientVectorStart, const QPointF& gradientVectorEnd)
@@ -112,6 +131,17 @@ double BiLinearGradientStrategy::valueAt(double x, double y) const
     return t;
 }
 
+void BiLinearGradientStrategy::valuesAt(double x, double y, int count, double *values) const
+{
+    LinearGradientStrategy::valuesAt(x, y, count, values);
+
+    for (int i = 0; i < count; i++) {
+        if (values[i] < -DBL_EPSILON) {
+            values[i] = -values[i];
+        }
+    }
+}
+
 
 class RadialGradientStrategy : public KisGradientShapeStrategy
 {
@@ -120,6 +150,7 @@ public:
     RadialGradientStrategy(const QPointF& gradientVectorStart, const QPointF& gradientVectorEnd);
 
     double valueAt(double x, double y) const override;
+    void valuesAt(double x, double y, int count, double *values) const override;
 
 protected:
     double m_radius;
@@ -152,6 +183,22 @@ double RadialGradientStrategy::valueAt(double x, double y) const
     return t;
 }
 
+void RadialGradientStrategy::valuesAt(double x, double y, int count, double *values) const
+{
+    if (m_radius < DBL_EPSILON) {
+        std::fill(values, values + count, 0.0);
+        return;
+    }
+
+    const double dy = y - m_gradientVectorStart.y();
+    const double dy2 = dy * dy;
+
+    for (int i = 0; i < count; i++) {
+        const double dx = x + i - m_gradientVectorStart.x();
+        values[i] = sqrt((dx * dx) + dy2) / m_radius;
+    }
+}
+
 
 class SquareGradientStrategy : public KisGradientShapeStrategy
 {
@@ -160,6 +207,7 @@ public:
     SquareGradientStrategy(const QPointF& gradientVectorStart, const QPointF& gradientVectorEnd);
 
     double valueAt(double x, double y) const override;
+    void valuesAt(double x, double y, int count, double *values) const override;
 
 protected:
     double m_normalisedVectorX;
@@ -216,6 +264,25 @@ double SquareGradientStrategy::valueAt(double x, double y) const
     return t;
 }
 
+void SquareGradientStrategy::valuesAt(double x, double y, int count, double *values) const
+{
+    if (m_vectorLength <= DBL_EPSILON) {
+        std::fill(values, values + count, 0.0);
+        return;
+    }
+
+    const double py = y - m_gradientVectorStart.y();
+
+    for (int i = 0; i < count; i++) {
+        const double px = x + i - m_gradientVectorStart.x();
+
+        const double distance1 = fabs(-m_normalisedVectorY * px + m_normalisedVectorX * py);
+        const double distance2 = fabs(-m_normalisedVectorY * -py + m_normalisedVectorX * px);
+
+        values[i] = qMax(distance1, distance2) / m_vectorLength;
+    }
+}
+
 
 class ConicalGradientStrategy : public KisGradientShapeStrategy
 {
@@ -588,20 +655,18 @@ public:
 
     void setup(const QPointF& gradientVectorStart,
                const QPointF& gradientVectorEnd,
-               const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                const GradientRepeatStrategy *repeatStrategy,
                qreal antiAliasThreshold,
                bool reverseGradient,
                const KoCachedGradient * cachedGradient);
 
-    const quint8 *colorAt(qreal x, qreal y) const;
+    const quint8 *colorAt(qreal x, qreal y, qreal shapeValue) const;
 
 private:
     KisGradientPainter::enumGradientShape m_shape;
     qreal m_antiAliasThresholdNormalized {0};
     qreal m_antiAliasThresholdNormalizedRev {0};
     qreal m_antiAliasThresholdNormalizedDbl {0};
-    QSharedPointer<KisGradientShapeStrategy> m_shapeStrategy;
     const GradientRepeatStrategy *m_repeatStrategy {0};
     bool m_reverseGradient {false};
     const KoCachedGradient *m_cachedGradient {0};
@@ -616,7 +681,6 @@ RepeatForwardsPaintPolicy::RepeatForwardsPaintPolicy(KisGradientPainter::enumGra
 
 void RepeatForwardsPaintPolicy::setup(const QPointF& gradientVectorStart,
                                       const QPointF& gradientVectorEnd,
-                                      const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                                       const GradientRepeatStrategy *repeatStrategy,
                                       qreal antiAliasThreshold,
                                       bool reverseGradient,
@@ -631,7 +695,6 @@ void RepeatForwardsPaintPolicy::setup(const QPointF& gradientVectorStart,
     m_antiAliasThresholdNormalizedRev = 1. - m_antiAliasThresholdNormalized;
     m_antiAliasThresholdNormalizedDbl = 2. * m_antiAliasThresholdNormalized;
     
-    m_shapeStrategy = shapeStrategy;
     m_repeatStrategy = repeatStrategy;
 
     m_reverseGradient = reverseGradient;
@@ -645,9 +708,12 @@ void RepeatForwardsPaintPolicy::setup(const QPointF& gradientVectorStart,
     m_resultColor = QVector<quint8>(m_colorSpace->pixelSize());
 }
 
-const quint8 *RepeatForwardsPaintPolicy::colorAt(qreal x, qreal y) const
+const quint8 *RepeatForwardsPaintPolicy::colorAt(qreal x, qreal y, qreal shapeValue) const
 {
-    qreal t = m_shapeStrategy->valueAt(x, y);
+    Q_UNUSED(x);
+    Q_UNUSED(y);
+
+    qreal t = shapeValue;
     // Early return if the pixel is near the center of the gradient if
     // the shape is radial or square.
     // This prevents applying smoothing since there are
@@ -695,17 +761,15 @@ class ConicalGradientPaintPolicy
 public:
     void setup(const QPointF& gradientVectorStart,
                const QPointF& gradientVectorEnd,
-               const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                const GradientRepeatStrategy *repeatStrategy,
                qreal antiAliasThreshold,
                bool reverseGradient,
                const KoCachedGradient * cachedGradient);
 
-    const quint8 *colorAt(qreal x, qreal y) const;
+    const quint8 *colorAt(qreal x, qreal y, qreal shapeValue) const;
 
 private:
     QPointF m_gradientVectorStart;
-    QSharedPointer<KisGradientShapeStrategy> m_shapeStrategy;
     const GradientRepeatStrategy *m_repeatStrategy;
     qreal m_singularityThreshold;
     qreal m_antiAliasThreshold;
@@ -718,7 +782,6 @@ private:
 
 void ConicalGradientPaintPolicy::setup(const QPointF& gradientVectorStart,
                                        const QPointF& gradientVectorEnd,
-                                       const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                                        const GradientRepeatStrategy *repeatStrategy,
                                        qreal antiAliasThreshold,
                                        bool reverseGradient,
@@ -728,7 +791,6 @@ void ConicalGradientPaintPolicy::setup(const QPointF& gradientVectorStart,
 
     m_gradientVectorStart = gradientVectorStart;
     
-    m_shapeStrategy = shapeStrategy;
     m_repeatStrategy = repeatStrategy;
 
     m_singularityThreshold = 8.;
@@ -745,7 +807,7 @@ void ConicalGradientPaintPolicy::setup(const QPointF& gradientVectorStart,
     m_resultColor = QVector<quint8>(m_colorSpace->pixelSize());
 }
 
-const quint8 *ConicalGradientPaintPolicy::colorAt(qreal x, qreal y) const
+const quint8 *ConicalGradientPaintPolicy::colorAt(qreal x, qreal y, qreal shapeValue) const
 {
     // Compute the distance from the center of the gradient to thecurrent pixel
     qreal dx = x - m_gradientVectorStart.x();
@@ -767,7 +829,7 @@ const quint8 *ConicalGradientPaintPolicy::colorAt(qreal x, qreal y) const
     qreal antiAliasThresholdNormalizedRev = 1. - antiAliasThresholdNormalized;
     qreal antiAliasThresholdNormalizedDbl = 2. * antiAliasThresholdNormalized;
 
-    qreal t = m_shapeStrategy->valueAt(x, y); 
+    qreal t = shapeValue;
     t = m_repeatStrategy->valueAt(t);
 
     if (m_reverseGradient) {
@@ -803,20 +865,18 @@ public:
 
     void setup(const QPointF& gradientVectorStart,
                const QPointF& gradientVectorEnd,
-               const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                const GradientRepeatStrategy *repeatStrategy,
                qreal antiAliasThreshold,
                bool reverseGradient,
                const KoCachedGradient * cachedGradient);
 
-    const quint8 *colorAt(qreal x, qreal y) const;
+    const quint8 *colorAt(qreal x, qreal y, qreal shapeValue) const;
 
 private:
     QPointF m_gradientVectorStart;
     qreal m_distanceInPixels {0};
     qreal m_singularityThreshold {0};
     qreal m_angle {0};
-    QSharedPointer<KisGradientShapeStrategy> m_shapeStrategy;
     const GradientRepeatStrategy *m_repeatStrategy {0};
     qreal m_antiAliasThreshold {0};
     bool m_reverseGradient {false};
@@ -834,7 +894,6 @@ SpyralGradientRepeatNonePaintPolicy::SpyralGradientRepeatNonePaintPolicy(bool is
 
 void SpyralGradientRepeatNonePaintPolicy::setup(const QPointF& gradientVectorStart,
                                                 const QPointF& gradientVectorEnd,
-                                                const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                                                 const GradientRepeatStrategy *repeatStrategy,
                                                 qreal antiAliasThreshold,
                                                 bool reverseGradient,
@@ -848,7 +907,6 @@ void SpyralGradientRepeatNonePaintPolicy::setup(const QPointF& gradientVectorSta
     m_singularityThreshold = m_distanceInPixels / 32.;
     m_angle = atan2(dy, dx) + M_PI;
     
-    m_shapeStrategy = shapeStrategy;
     m_repeatStrategy = repeatStrategy;
 
     m_antiAliasThreshold = antiAliasThreshold;
@@ -862,7 +920,7 @@ void SpyralGradientRepeatNonePaintPolicy::setup(const QPointF& gradientVectorSta
     m_resultColor = QVector<quint8>(m_colorSpace->pixelSize());
 }
 
-const quint8 *SpyralGradientRepeatNonePaintPolicy::colorAt(qreal x, qreal y) const
+const quint8 *SpyralGradientRepeatNonePaintPolicy::colorAt(qreal x, qreal y, qreal shapeValue) const
 {
     // Compute the distance from the center of the gradient to thecurrent pixel
     qreal dx = x - m_gradientVectorStart.x();
@@ -884,7 +942,7 @@ const quint8 *SpyralGradientRepeatNonePaintPolicy::colorAt(qreal x, qreal y) con
     qreal antiAliasThresholdNormalizedRev = 1. - antiAliasThresholdNormalized;
     qreal antiAliasThresholdNormalizedDbl = 2. * antiAliasThresholdNormalized;
 
-    qreal t = m_shapeStrategy->valueAt(x, y); 
+    qreal t = shapeValue;
     t = m_repeatStrategy->valueAt(t);
 
     if (m_reverseGradient) {
@@ -943,16 +1001,14 @@ class NoAntialiasPaintPolicy
 public:
     void setup(const QPointF& gradientVectorStart,
                const QPointF& gradientVectorEnd,
-               const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                const GradientRepeatStrategy *repeatStrategy,
                qreal antiAliasThreshold,
                bool reverseGradient,
                const KoCachedGradient * cachedGradient);
 
-    const quint8 *colorAt(qreal x, qreal y) const;
+    const quint8 *colorAt(qreal x, qreal y, qreal shapeValue) const;
 
 private:
-    QSharedPointer<KisGradientShapeStrategy> m_shapeStrategy;
     const GradientRepeatStrategy *m_repeatStrategy {0};
     bool m_reverseGradient {false};
     const KoCachedGradient *m_cachedGradient {0};
@@ -960,7 +1016,6 @@ private:
 
 void NoAntialiasPaintPolicy::setup(const QPointF& gradientVectorStart,
                                    const QPointF& gradientVectorEnd,
-                                   const QSharedPointer<KisGradientShapeStrategy> &shapeStrategy,
                                    const GradientRepeatStrategy *repeatStrategy,
                                    qreal antiAliasThreshold,
                                    bool reverseGradient,
@@ -969,15 +1024,17 @@ void NoAntialiasPaintPolicy::setup(const QPointF& gradientVectorStart,
     Q_UNUSED(gradientVectorStart);
     Q_UNUSED(gradientVectorEnd);
     Q_UNUSED(antiAliasThreshold);
-    m_shapeStrategy = shapeStrategy;
     m_repeatStrategy = repeatStrategy;
     m_reverseGradient = reverseGradient;
     m_cachedGradient = cachedGradient;
 }
 
-const quint8 *NoAntialiasPaintPolicy::colorAt(qreal x, qreal y) const
+const quint8 *NoAntialiasPaintPolicy::colorAt(qreal x, qreal y, qreal shapeValue) const
 {
-    qreal t = m_shapeStrategy->valueAt(x, y);
+    Q_UNUSED(x);
+    Q_UNUSED(y);
+
+    qreal t = shapeValue;
     t = m_repeatStrategy->valueAt(t);
 
     if (m_reverseGradient) {
@@ -1286,9 +1343,7 @@ bool KisGradientPainter::paintGradient(const QPointF& gradientVectorStart,
     const KoColorSpace *mixCs = KoColorSpaceRegistry::instance()->colorSpace(destCs->colorModelId().id(), depthId.id(), destCs->profile());
     const quint32 mixPixelSize = mixCs->pixelSize();
 
-    KisPaintDeviceSP tmp(new KisPaintDevice(mixCs));
-    tmp->setDefaultBounds(dev->defaultBounds());
-    tmp->clear();
+    const quint32 dstPixelSize = destCs->pixelSize();
 
     const KisDitherOp* op = mixCs->ditherOp(destCs->colorDepthId().id(), useDithering ? DITHER_BEST : DITHER_NONE);
 
@@ -1298,44 +1353,61 @@ bool KisGradientPainter::paintGradient(const QPointF& gradientVectorStart,
 
         KoCachedGradient cachedGradient(gradient(), qMax(processRect.width(), processRect.height()), mixCs);
 
-        KisSequentialIteratorProgress it(tmp, processRect, progressUpdater());
-
         paintPolicy.setup(gradientVectorStart,
                           gradientVectorEnd,
-                          shapeStrategy,
                           repeatStrategy,
                           antiAliasThreshold,
                           reverseGradient,
                           &cachedGradient);
 
-        while (it.nextPixel()) {
-            const quint8 *const pixel {paintPolicy.colorAt(it.x(), it.y())};
-            memcpy(it.rawData(), pixel, mixPixelSize);
+        /**
+         * The region is painted in tile-aligned patches in parallel. Every
+         * patch evaluates the shape a row at a time, looks the colors up
+         * in the cached gradient, dithers the result into the depth of
+         * the destination and writes it into the device. The paint
+         * policies keep intermediate colors, so every patch uses its own
+         * copy of the policy.
+         */
+        QVector<QRect> patches = KritaUtils::splitRectIntoPatches(processRect, KritaUtils::optimalPatchSize());
+
+        KoUpdater *updater = progressUpdater();
+        QMutex progressMutex;
+        int patchesDone = 0;
+
+        if (updater) {
+            updater->setRange(0, patches.size());
+            updater->setValue(0);
         }
 
-        KisRandomAccessorSP dstIt = dev->createRandomAccessorNG();
-        KisRandomConstAccessorSP srcIt = tmp->createRandomConstAccessorNG();
+        QtConcurrent::blockingMap(patches, [&] (const QRect &patch) {
+            const T policy = paintPolicy;
+
+            QVector<double> shapeValues(patch.width());
+            QVector<quint8> mixPixels(patch.width() * patch.height() * mixPixelSize);
+            QVector<quint8> dstPixels(patch.width() * patch.height() * dstPixelSize);
 
-        int rows = 1;
-        int columns = 1;
+            quint8 *mixPtr = mixPixels.data();
 
-        for (int y = processRect.y(); y <= processRect.bottom(); y += rows) {
-            rows = qMin(srcIt->numContiguousRows(y), qMin(dstIt->numContiguousRows(y), processRect.bottom() - y + 1));
+            for (int y = patch.y(); y <= patch.bottom(); y++) {
+                shapeStrategy->valuesAt(patch.x(), y, patch.width(), shapeValues.data());
 
-            for (int x = processRect.x(); x <= processRect.right(); x += columns) {
-                columns = qMin(srcIt->numContiguousColumns(x), qMin(dstIt->numContiguousColumns(x), processRect.right() - x + 1));
+                for (int i = 0; i < patch.width(); i++) {
+                    memcpy(mixPtr, policy.colorAt(patch.x() + i, y, shapeValues[i]), mixPixelSize);
+                    mixPtr += mixPixelSize;
+                }
+            }
 
-                srcIt->moveTo(x, y);
-                dstIt->moveTo(x, y);
+            op->dither(mixPixels.constData(), patch.width() * mixPixelSize,
+                       dstPixels.data(), patch.width() * dstPixelSize,
+                       patch.x(), patch.y(), patch.width(), patch.height());
 
-                const qint32 srcRowStride = srcIt->rowStride(x, y);
-                const qint32 dstRowStride = dstIt->rowStride(x, y);
-                const quint8 *srcPtr = srcIt->rawDataConst();
-                quint8 *dstPtr = dstIt->rawData();
+            dev->writeBytes(dstPixels.constData(), patch);
 
-                op->dither(srcPtr, srcRowStride, dstPtr, dstRowStride, x, y, columns, rows);
+            if (updater) {
+                QMutexLocker l(&progressMutex);
+                updater->setValue(++patchesDone);
             }
-        }
+        });
     }
 
     bitBlt(requestedRect.topLeft(), dev, requestedRect);
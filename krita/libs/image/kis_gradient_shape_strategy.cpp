@@ -20,3 +20,10 @@ KisGradientShapeStrategy::KisGradientShapeStrategy(const QPointF& gradientVector
 KisGradientShapeStrategy::~KisGradientShapeStrategy()
 {
 }
+
+void KisGradientShapeStrategy::valuesAt(double x, double y, int count, double *values) const
+{
+    for (int i = 0; i < count; i++) {
+        values[i] = valueAt(x + i, y);
+    }
+}
@@ -20,6 +20,14 @@ public:
 
     virtual double valueAt(double x, double y) const = 0;
 
+    /**
+     * Fills \p values with the values of \p count consecutive pixels of
+     * a row, starting at (\p x, \p y). The default implementation calls
+     * valueAt() for every pixel, the strategies that are cheap to evaluate
+     * override it with a tight loop the compiler can vectorize.
+     */
+    virtual void valuesAt(double x, double y, int count, double *values) const;
+
 protected:
     QPointF m_gradientVectorStart;
     QPointF m_gradientVectorEnd;
@@ -190,6 +190,28 @@ int KisImageConfig::poolLimit() const
     return totalRAM() * hp * pp;
 }
 
+int KisImageConfig::filterResultCacheLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("filterResultCacheLimit", 32) : 32;
+}
+
+void KisImageConfig::setFilterResultCacheLimit(int value)
+{
+    m_config.writeEntry("filterResultCacheLimit", value);
+}
+
+int KisImageConfig::filterResultCacheTotalLimit(bool requestDefault) const
+{
+    return !requestDefault ?
+        m_config.readEntry("filterResultCacheTotalLimit", 256) : 256;
+}
+
+void KisImageConfig::setFilterResultCacheTotalLimit(int value)
+{
+    m_config.writeEntry("filterResultCacheTotalLimit", value);
+}
+
 qreal KisImageConfig::memoryHardLimitPercent(bool requestDefault) const
 {
     return !requestDefault ?
@@ -50,6 +50,11 @@ public:
     int tilesSoftLimit() const; // MiB
     int poolLimit() const; // MiB
 
+    int filterResultCacheLimit(bool requestDefault = false) const; // MiB, per filter node
+    int filterResultCacheTotalLimit(bool requestDefault = false) const; // MiB, all filter nodes
+    void setFilterResultCacheLimit(int value);
+    void setFilterResultCacheTotalLimit(int value);
+
     qreal memoryHardLimitPercent(bool requestDefault = false) const; // % of total RAM
     qreal memorySoftLimitPercent(bool requestDefault = false) const; // % of memoryHardLimitPercent() * (1 - 0.01 * memoryPoolLimitPercent())
     qreal memoryPoolLimitPercent(bool requestDefault = false) const; // % of memoryHardLimitPercent()
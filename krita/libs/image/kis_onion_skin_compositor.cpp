@@ -6,7 +6,12 @@
 
 #include "kis_onion_skin_compositor.h"
 
+#include <QHash>
+#include <QSet>
+#include <QtConcurrent>
+
 #include "kis_paint_device.h"
+#include "kis_paint_device_frames_interface.h"
 #include "kis_painter.h"
 #include "KoColor.h"
 #include "KoColorSpace.h"
@@ -14,9 +19,52 @@
 #include "KoColorSpaceConstants.h"
 #include "kis_image_config.h"
 #include "kis_raster_keyframe_channel.h"
+#include "krita_utils.h"
 
 Q_GLOBAL_STATIC(KisOnionSkinCompositor, s_instance)
 
+namespace {
+
+/**
+ * The same physical frame may be shown both as a backward and a forward
+ * skin (cloned frames share it), so the direction is a part of the key.
+ */
+typedef QPair<int, bool> FrameKey;
+
+struct TintedFrame {
+    int sequenceNumber = 0;
+    QColor tintColor;
+    int tintFactor = 0;
+    const KoColorSpace *colorSpace = nullptr;
+    bool cacheable = false;
+
+    KisPaintDeviceSP device;
+    QRect area; // the area where the device may have non-transparent pixels
+};
+
+}
+
+struct KisOnionSkinCompositor::TintedFramesCache::Private
+{
+    const KisPaintDevice *sourceDevice = nullptr;
+    QHash<FrameKey, TintedFrame> frames;
+};
+
+KisOnionSkinCompositor::TintedFramesCache::TintedFramesCache()
+    : m_d(new Private)
+{
+}
+
+KisOnionSkinCompositor::TintedFramesCache::~TintedFramesCache()
+{
+}
+
+void KisOnionSkinCompositor::TintedFramesCache::clear()
+{
+    m_d->sourceDevice = nullptr;
+    m_d->frames.clear();
+}
+
 struct KisOnionSkinCompositor::Private
 {
     int numberOfSkins = 0;
@@ -60,16 +108,28 @@ struct KisOnionSkinCompositor::Private
         return channel->keyframeAt<KisRasterKeyframe>(outFrame);
     }
 
-    void tryCompositeFrame(KisRasterKeyframeSP keyframe, KisPainter &gcFrame, KisPainter &gcDest, KisPaintDeviceSP tintSource, int opacity, const QRect &rect)
+    void createTintedFrame(KisRasterKeyframeSP keyframe, const QColor &tintColor, const QRect &rect, TintedFrame *frame)
     {
-        if (keyframe.isNull() || opacity == OPACITY_TRANSPARENT_U8) return;
-
-        keyframe->writeFrameToDevice(gcFrame.device());
-
-        gcFrame.bitBlt(rect.topLeft(), tintSource, rect);
-
-        gcDest.setOpacity(opacity);
-        gcDest.bitBlt(rect.topLeft(), gcFrame.device(), rect);
+        frame->device = new KisPaintDevice(frame->colorSpace);
+        keyframe->writeFrameToDevice(frame->device);
+
+        /**
+         * Tinting only touches the color channels, so the transparent
+         * pixels stay transparent. If the frame has a non-transparent
+         * default pixel, the tinted area depends on the requested rect
+         * and such frame cannot be reused.
+         */
+        frame->cacheable = frame->device->defaultPixel().opacityU8() == OPACITY_TRANSPARENT_U8;
+        frame->area = frame->cacheable ? frame->device->extent() : rect;
+
+        if (frame->area.isEmpty()) return;
+
+        KisPainter gcFrame(frame->device);
+        gcFrame.setChannelFlags(frame->colorSpace->channelFlags(true, false));
+        gcFrame.setOpacity(frame->tintFactor);
+
+        KisPaintDeviceSP tintSource = setUpTintDevice(tintColor, frame->colorSpace);
+        gcFrame.bitBlt(frame->area.topLeft(), tintSource, frame->area);
     }
 
     void refreshConfig()
@@ -128,46 +188,180 @@ QSet<int> KisOnionSkinCompositor::colorLabelFilter()
     return m_d->colorLabelFilter;
 }
 
-void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect& rect)
+void KisOnionSkinCompositor::composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect& rect,
+                                       TintedFramesCache *cache)
 {
     KisRasterKeyframeChannel *keyframes = sourceDevice->keyframeChannel();
 
-    KisPaintDeviceSP frameDevice = new KisPaintDevice(sourceDevice->colorSpace());
-    KisPainter gcFrame(frameDevice);
-    QBitArray channelFlags = targetDevice->colorSpace()->channelFlags(true, false);
-    gcFrame.setChannelFlags(channelFlags);
-    gcFrame.setOpacity(m_d->tintFactor);
+    if (!keyframes) { // it happens when you try to show onion skins on non-animated layer with opacity keyframes
+        return;
+    }
+
+    TintedFramesCache localCache;
+    TintedFramesCache::Private *framesCache = cache ? cache->m_d.data() : localCache.m_d.data();
+
+    if (framesCache->sourceDevice != sourceDevice.data()) {
+        framesCache->frames.clear();
+        framesCache->sourceDevice = sourceDevice.data();
+    }
 
-    KisPaintDeviceSP backwardTintDevice = m_d->setUpTintDevice(m_d->backwardTintColor, sourceDevice->colorSpace());
-    KisPaintDeviceSP forwardTintDevice = m_d->setUpTintDevice(m_d->forwardTintColor, sourceDevice->colorSpace());
+    struct Skin {
+        FrameKey key;
+        KisRasterKeyframeSP keyframe;
+        QColor tintColor;
+        quint8 opacity;
+    };
 
-    KisPainter gcDest(targetDevice);
-    gcDest.setCompositeOpId(sourceDevice->colorSpace()->compositeOp(COMPOSITE_BEHIND));
+    QVector<Skin> skins;
 
     int keyframeTimeBck;
     int keyframeTimeFwd;
 
     int time = sourceDevice->defaultBounds()->currentTime();
 
-    if (!keyframes) { // it happens when you try to show onion skins on non-animated layer with opacity keyframes
-        return;
-    }
-
     keyframeTimeBck = keyframeTimeFwd = keyframes->activeKeyframeTime(time);
 
     for (int offset = 1; offset <= m_d->numberOfSkins; offset++) {
         KisRasterKeyframeSP backKeyframe = m_d->getNextFrameToComposite(keyframes, keyframeTimeBck, true);
         KisRasterKeyframeSP forwardKeyframe = m_d->getNextFrameToComposite(keyframes, keyframeTimeFwd, false);
 
-        if (!backKeyframe.isNull()) {
-            m_d->tryCompositeFrame(backKeyframe, gcFrame, gcDest, backwardTintDevice, m_d->skinOpacity(-offset), rect);
+        const quint8 backOpacity = m_d->skinOpacity(-offset);
+        const quint8 forwardOpacity = m_d->skinOpacity(offset);
+
+        if (!backKeyframe.isNull() && backOpacity != OPACITY_TRANSPARENT_U8) {
+            skins.append({FrameKey(backKeyframe->frameID(), false), backKeyframe, m_d->backwardTintColor, backOpacity});
+        }
+
+        if (!forwardKeyframe.isNull() && forwardOpacity != OPACITY_TRANSPARENT_U8) {
+            skins.append({FrameKey(forwardKeyframe->frameID(), true), forwardKeyframe, m_d->forwardTintColor, forwardOpacity});
         }
+    }
+
+    const KoColorSpace *srcColorSpace = sourceDevice->colorSpace();
+    KisPaintDeviceFramesInterface *framesInterface = sourceDevice->framesInterface();
+
+    QHash<FrameKey, TintedFrame> usedFrames;
+    QVector<QPair<Skin, TintedFrame>> tintJobs;
+    QSet<FrameKey> scheduledFrames;
+
+    Q_FOREACH (const Skin &skin, skins) {
+        if (usedFrames.contains(skin.key) || scheduledFrames.contains(skin.key)) continue;
+
+        TintedFrame frame;
+        frame.sequenceNumber = framesInterface->frameSequenceNumber(skin.keyframe->frameID());
+        frame.tintColor = skin.tintColor;
+        frame.tintFactor = m_d->tintFactor;
+        frame.colorSpace = srcColorSpace;
+
+        auto it = framesCache->frames.constFind(skin.key);
 
-        if (!forwardKeyframe.isNull()) {
-            m_d->tryCompositeFrame(forwardKeyframe, gcFrame, gcDest, forwardTintDevice, m_d->skinOpacity(offset), rect);
+        if (it != framesCache->frames.constEnd() &&
+            it->sequenceNumber == frame.sequenceNumber &&
+            it->tintColor == frame.tintColor &&
+            it->tintFactor == frame.tintFactor &&
+            *it->colorSpace == *frame.colorSpace) {
+
+            usedFrames.insert(skin.key, *it);
+        } else {
+            tintJobs.append(qMakePair(skin, frame));
+            scheduledFrames.insert(skin.key);
         }
     }
 
+    QtConcurrent::blockingMap(tintJobs, [this, rect] (QPair<Skin, TintedFrame> &job) {
+        m_d->createTintedFrame(job.first.keyframe, job.first.tintColor, rect, &job.second);
+    });
+
+    for (auto it = tintJobs.constBegin(); it != tintJobs.constEnd(); ++it) {
+        usedFrames.insert(it->first.key, it->second);
+    }
+
+    /**
+     * Every cached frame is a tinted copy of a whole layer frame, so the
+     * amount of memory kept per layer is limited. The skins are ordered
+     * from the nearest to the farthest, so the nearest ones are kept.
+     */
+    const qint64 maxCachedBytes = 128 * 1024 * 1024;
+    qint64 cachedBytes = 0;
+
+    framesCache->frames.clear();
+    Q_FOREACH (const Skin &skin, skins) {
+        const TintedFrame &frame = usedFrames[skin.key];
+        if (!frame.cacheable || framesCache->frames.contains(skin.key)) continue;
+
+        const qint64 frameBytes = qint64(frame.area.width()) * frame.area.height() * frame.colorSpace->pixelSize();
+        if (cachedBytes + frameBytes > maxCachedBytes) continue;
+
+        framesCache->frames.insert(skin.key, frame);
+        cachedBytes += frameBytes;
+    }
+
+    struct Source {
+        KisPaintDeviceSP device;
+        QRect rect;
+        quint8 opacity;
+    };
+
+    QVector<Source> sources;
+    QRect compositeRect;
+
+    Q_FOREACH (const Skin &skin, skins) {
+        const TintedFrame &frame = usedFrames[skin.key];
+        const QRect sourceRect = frame.area & rect;
+        if (sourceRect.isEmpty()) continue;
+
+        sources.append({frame.device, sourceRect, skin.opacity});
+        compositeRect |= sourceRect;
+    }
+
+    if (sources.isEmpty()) return;
+
+    /**
+     * All the skins are composited in a single pass: every patch of the
+     * target is read once, all the skins are painted behind it in the
+     * same order as they would be painted one-by-one, and then the patch
+     * is written back. The patches are aligned to the tile grid and
+     * processed in parallel.
+     */
+    const KoColorSpace *dstColorSpace = targetDevice->colorSpace();
+    const KoCompositeOp *compositeOp = dstColorSpace->compositeOp(COMPOSITE_BEHIND);
+    const int dstPixelSize = dstColorSpace->pixelSize();
+
+    QVector<QRect> patches = KritaUtils::splitRectIntoPatches(compositeRect, KritaUtils::optimalPatchSize());
+
+    QtConcurrent::blockingMap(patches, [&] (const QRect &patch) {
+        QVector<quint8> dstPixels(patch.width() * patch.height() * dstPixelSize);
+        QVector<quint8> srcPixels;
+
+        targetDevice->readBytes(dstPixels.data(), patch);
+
+        KoCompositeOp::ParameterInfo params;
+        params.dstRowStride = patch.width() * dstPixelSize;
+
+        Q_FOREACH (const Source &source, sources) {
+            const QRect rc = source.rect & patch;
+            if (rc.isEmpty()) continue;
+
+            const int srcPixelSize = source.device->pixelSize();
+
+            srcPixels.resize(rc.width() * rc.height() * srcPixelSize);
+            source.device->readBytes(srcPixels.data(), rc);
+
+            params.dstRowStart = dstPixels.data() +
+                ((rc.y() - patch.y()) * patch.width() + rc.x() - patch.x()) * dstPixelSize;
+            params.srcRowStart = srcPixels.constData();
+            params.srcRowStride = rc.width() * srcPixelSize;
+            params.rows = rc.height();
+            params.cols = rc.width();
+            params.opacity = float(source.opacity) / 255.0f;
+
+            dstColorSpace->bitBlt(source.device->colorSpace(), params, compositeOp,
+                                  KoColorConversionTransformation::internalRenderingIntent(),
+                                  KoColorConversionTransformation::internalConversionFlags());
+        }
+
+        targetDevice->writeBytes(dstPixels.constData(), patch);
+    });
 }
 
 QRect KisOnionSkinCompositor::calculateFullExtent(const KisPaintDeviceSP device)
@@ -7,6 +7,8 @@
 #ifndef KIS_ONION_SKIN_COMPOSITOR_H
 #define KIS_ONION_SKIN_COMPOSITOR_H
 
+#include <QScopedPointer>
+
 #include "kis_types.h"
 #include "kritaimage_export.h"
 
@@ -14,12 +16,45 @@ class KRITAIMAGE_EXPORT KisOnionSkinCompositor : public QObject
 {
     Q_OBJECT
 
+public:
+    /**
+     * Keeps the tinted onion skin frames of a paint device between the
+     * calls to composite(). A tinted frame is regenerated only when the
+     * content of its source frame or the tint settings change, switching
+     * the current time just picks up the frames that are already tinted.
+     *
+     * The frames that were not used by the last call to composite() are
+     * dropped. The cache keeps at most 128 MiB of tinted frames, the
+     * farthest skins are not cached when they don't fit.
+     */
+    class KRITAIMAGE_EXPORT TintedFramesCache
+    {
+    public:
+        TintedFramesCache();
+        ~TintedFramesCache();
+
+        void clear();
+
+    private:
+        friend class KisOnionSkinCompositor;
+        struct Private;
+        const QScopedPointer<Private> m_d;
+    };
+
 public:
     KisOnionSkinCompositor();
     ~KisOnionSkinCompositor() override;
     static KisOnionSkinCompositor *instance();
 
-    void composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect &rect);
+    /**
+     * Composites the onion skins of \p sourceDevice behind the content
+     * of \p targetDevice in \p rect.
+     *
+     * @param cache if not null, the tinted frames are taken from the
+     *              cache and the missing ones are stored into it
+     */
+    void composite(const KisPaintDeviceSP sourceDevice, KisPaintDeviceSP targetDevice, const QRect &rect,
+                   TintedFramesCache *cache = nullptr);
 
     QRect calculateFullExtent(const KisPaintDeviceSP device);
     QRect calculateExtent(const KisPaintDeviceSP device);
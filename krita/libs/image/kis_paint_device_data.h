@@ -8,10 +8,16 @@
 #ifndef __KIS_PAINT_DEVICE_DATA_H
 #define __KIS_PAINT_DEVICE_DATA_H
 
+#include <QMutex>
+#include <QtConcurrent>
+
+#include <KoUpdater.h>
+
 #include "KisInterstrokeData.h"
 #include "KisSequentialIteratorProgress.h"
 #include "KoAlwaysInline.h"
 #include "kis_command_utils.h"
+#include "krita_utils.h"
 #include "kundo2command.h"
 
 struct DirectDataAccessPolicy {
@@ -165,9 +171,9 @@ public:
                                KoUpdater *updater = nullptr)
     {
         using InternalSequentialConstIterator =
-            KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy, ProxyBasedProgressPolicy>;
+            KisSequentialIteratorBase<ReadOnlyIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy>;
         using InternalSequentialIterator =
-            KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy, ProxyBasedProgressPolicy>;
+            KisSequentialIteratorBase<WritableIteratorPolicy<DirectDataAccessPolicy>, DirectDataAccessPolicy>;
 
         if (m_colorSpace == dstColorSpace || *m_colorSpace == *dstColorSpace) {
             return;
@@ -184,27 +190,49 @@ public:
 
 
         if (!rc.isEmpty()) {
-            InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), rc, updater);
-            InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager.data(), cacheInvalidator()), rc, updater);
+            /**
+             * The patches are converted in parallel. The rect of the data
+             * manager is always aligned to the tiles, so are the patches,
+             * therefore the threads never access the same tile.
+             */
+            QVector<QRect> patches = KritaUtils::splitRectIntoPatches(rc, QSize(256, 256));
+
+            QMutex progressMutex;
+            int patchesDone = 0;
+
+            if (updater) {
+                updater->setRange(0, patches.size());
+                updater->setValue(0);
+            }
 
-            int nConseqPixels = srcIt.nConseqPixels();
+            QtConcurrent::blockingMap(patches, [&] (const QRect &patch) {
+                InternalSequentialConstIterator srcIt(DirectDataAccessPolicy(m_dataManager.data(), cacheInvalidator()), patch);
+                InternalSequentialIterator dstIt(DirectDataAccessPolicy(dstDataManager.data(), cacheInvalidator()), patch);
 
-            // since we are accessing data managers directly, the columns are always aligned
-            KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
+                int nConseqPixels = srcIt.nConseqPixels();
 
-            while(srcIt.nextPixels(nConseqPixels) &&
-                  dstIt.nextPixels(nConseqPixels)) {
+                // since we are accessing data managers directly, the columns are always aligned
+                KIS_SAFE_ASSERT_RECOVER_NOOP(srcIt.nConseqPixels() == dstIt.nConseqPixels());
 
-                nConseqPixels = srcIt.nConseqPixels();
+                while(srcIt.nextPixels(nConseqPixels) &&
+                      dstIt.nextPixels(nConseqPixels)) {
 
-                const quint8 *srcData = srcIt.rawDataConst();
-                quint8 *dstData = dstIt.rawData();
+                    nConseqPixels = srcIt.nConseqPixels();
 
-                m_colorSpace->convertPixelsTo(srcData, dstData,
-                                              dstColorSpace,
-                                              nConseqPixels,
-                                              renderingIntent, conversionFlags);
-            }
+                    const quint8 *srcData = srcIt.rawDataConst();
+                    quint8 *dstData = dstIt.rawData();
+
+                    m_colorSpace->convertPixelsTo(srcData, dstData,
+                                                  dstColorSpace,
+                                                  nConseqPixels,
+                                                  renderingIntent, conversionFlags);
+                }
+
+                if (updater) {
+                    QMutexLocker l(&progressMutex);
+                    updater->setValue(++patchesDone);
+                }
+            });
         }
 
         // becomes owned by the parent
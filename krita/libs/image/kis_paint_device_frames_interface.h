@@ -117,6 +117,14 @@ public:
      */
     void invalidateFrameCache(int frameId);
 
+    /**
+     * @return the sequence number of \p frameId. The number changes
+     *         every time the content of the frame is changed, so it can
+     *         be used to validate the data derived from the frame.
+     *         Returns -1 if there is no such frame.
+     */
+    int frameSequenceNumber(int frameId) const;
+
     /**
      * Sets the offset for \p frameId.
      * Should be used by Undo framework only!
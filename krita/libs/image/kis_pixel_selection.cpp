@@ -26,6 +26,7 @@
 #include "kis_image.h"
 #include "kis_fill_painter.h"
 #include "kis_outline_generator.h"
+#include "KisIncrementalOutlineGenerator.h"
 #include <kis_iterator_ng.h>
 #include "kis_lod_transform.h"
 #include "kundo2command.h"
@@ -38,6 +39,8 @@ struct Q_DECL_HIDDEN KisPixelSelection::Private {
     bool outlineCacheValid;
     QMutex outlineCacheMutex;
 
+    KisIncrementalOutlineGenerator outlineGenerator {KoColorSpaceRegistry::instance()->alpha8(), MIN_SELECTED};
+
     bool thumbnailImageValid;
     QImage thumbnailImage;
     QTransform thumbnailImageTransform;
@@ -49,6 +52,16 @@ struct Q_DECL_HIDDEN KisPixelSelection::Private {
         thumbnailImage = QImage();
         thumbnailImageTransform = QTransform();
     }
+
+    void invalidateOutlineFragments(const QRect &rc) {
+        QMutexLocker locker(&outlineCacheMutex);
+        outlineGenerator.invalidate(rc);
+    }
+
+    void invalidateAllOutlineFragments() {
+        QMutexLocker locker(&outlineCacheMutex);
+        outlineGenerator.invalidateAll();
+    }
 };
 
 KisPixelSelection::KisPixelSelection(KisDefaultBoundsBaseSP defaultBounds, KisSelectionWSP parentSelection)
@@ -69,6 +82,7 @@ KisPixelSelection::KisPixelSelection(const KisPixelSelection& rhs, KritaUtils::D
     // parent selection is not supposed to be shared
     m_d->outlineCache = rhs.m_d->outlineCache;
     m_d->outlineCacheValid = rhs.m_d->outlineCacheValid;
+    m_d->outlineGenerator = rhs.m_d->outlineGenerator;
 
     m_d->thumbnailImageValid = rhs.m_d->thumbnailImageValid;
     m_d->thumbnailImage = rhs.m_d->thumbnailImage;
@@ -86,6 +100,7 @@ KisPixelSelection::KisPixelSelection(const KisPaintDeviceSP copySource, KritaUti
 
     m_d->parentSelection = parentSelection;
     m_d->outlineCacheValid = false;
+    m_d->outlineGenerator.invalidateAll();
     m_d->invalidateThumbnailImage();
 }
 
@@ -111,6 +126,7 @@ bool KisPixelSelection::read(QIODevice *stream)
 {
     bool retval = KisPaintDevice::read(stream);
     m_d->outlineCacheValid = false;
+    m_d->invalidateAllOutlineFragments();
     m_d->invalidateThumbnailImage();
     return retval;
 }
@@ -124,6 +140,8 @@ void KisPixelSelection::select(const QRect & rc, quint8 selectedness)
     const KoColorSpace * cs = KoColorSpaceRegistry::instance()->rgb8();
     painter.fillRect(r, KoColor(Qt::white, cs), selectedness);
 
+    m_d->invalidateOutlineFragments(r);
+
     if (m_d->outlineCacheValid) {
         QPainterPath path;
         path.addRect(r);
@@ -137,6 +155,15 @@ void KisPixelSelection::select(const QRect & rc, quint8 selectedness)
     m_d->invalidateThumbnailImage();
 }
 
+void KisPixelSelection::invalidateOutlineFragments(const QRect &rc, quint8 newDefaultPixel)
+{
+    if (newDefaultPixel != *defaultPixel().data()) {
+        m_d->invalidateAllOutlineFragments();
+    } else {
+        m_d->invalidateOutlineFragments(rc);
+    }
+}
+
 void KisPixelSelection::applySelection(KisPixelSelectionSP selection, SelectionAction action)
 {
     switch (action) {
@@ -177,6 +204,7 @@ void KisPixelSelection::copyAlphaFrom(KisPaintDeviceSP src, const QRect &process
 
     m_d->outlineCacheValid = false;
     m_d->outlineCache = QPainterPath();
+    m_d->invalidateOutlineFragments(processRect);
     m_d->invalidateThumbnailImage();
 }
 
@@ -200,6 +228,7 @@ void KisPixelSelection::addSelection(KisPixelSelectionSP selection)
     }
 
     const quint8 defPixel = qMax(*defaultPixel().data(), *selection->defaultPixel().data());
+    invalidateOutlineFragments(r, defPixel);
     setDefaultPixel(KoColor(&defPixel, colorSpace()));
 
     m_d->outlineCacheValid &= selection->outlineCacheValid();
@@ -234,6 +263,7 @@ void KisPixelSelection::subtractSelection(KisPixelSelectionSP selection)
     const quint8 defPixel = *selection->defaultPixel().data() > *defaultPixel().data()
                             ? MIN_SELECTED
                             : *defaultPixel().data() - *selection->defaultPixel().data();
+    invalidateOutlineFragments(r, defPixel);
     setDefaultPixel(KoColor(&defPixel, colorSpace()));
 
     m_d->outlineCacheValid &= selection->outlineCacheValid();
@@ -264,6 +294,7 @@ void KisPixelSelection::intersectSelection(KisPixelSelectionSP selection)
     }
 
     const quint8 defPixel = qMin(*defaultPixel().data(), *selection->defaultPixel().data());
+    invalidateOutlineFragments(r, defPixel);
     setDefaultPixel(KoColor(&defPixel, colorSpace()));
 
     crop(r);
@@ -296,6 +327,7 @@ void KisPixelSelection::symmetricdifferenceSelection(KisPixelSelectionSP selecti
     }
 
     const quint8 defPixel = abs(*defaultPixel().data() - *selection->defaultPixel().data());
+    invalidateOutlineFragments(r, defPixel);
     setDefaultPixel(KoColor(&defPixel, colorSpace()));
     
     m_d->outlineCacheValid &= selection->outlineCacheValid();
@@ -317,6 +349,8 @@ void KisPixelSelection::clear(const QRect & r)
         KisPaintDevice::clear(r);
     }
 
+    m_d->invalidateOutlineFragments(r);
+
     if (m_d->outlineCacheValid) {
         QPainterPath path;
         path.addRect(r);
@@ -335,6 +369,11 @@ void KisPixelSelection::clear()
     m_d->outlineCacheValid = true;
     m_d->outlineCache = QPainterPath();
 
+    {
+        QMutexLocker locker(&m_d->outlineCacheMutex);
+        m_d->outlineGenerator.reset();
+    }
+
     // Empty the thumbnail image. It is a valid state.
     m_d->invalidateThumbnailImage();
     m_d->thumbnailImageValid = true;
@@ -355,6 +394,8 @@ void KisPixelSelection::invert()
     quint8 defPixel = MAX_SELECTED - *defaultPixel().data();
     setDefaultPixel(KoColor(&defPixel, colorSpace()));
 
+    m_d->invalidateAllOutlineFragments();
+
     if (m_d->outlineCacheValid) {
         QPainterPath path;
         path.addRect(defaultBounds()->bounds());
@@ -373,6 +414,10 @@ void KisPixelSelection::moveTo(const QPoint &pt)
 
     const QPoint offset = lod0Point - m_d->lod0CachesOffset;
 
+    if (!offset.isNull()) {
+        m_d->invalidateAllOutlineFragments();
+    }
+
     if (m_d->outlineCacheValid) {
         m_d->outlineCache.translate(offset);
     }
@@ -460,6 +505,16 @@ void KisPixelSelection::setOutlineCache(const QPainterPath &cache)
     QMutexLocker locker(&m_d->outlineCacheMutex);
     m_d->outlineCache = cache;
     m_d->outlineCacheValid = true;
+    m_d->outlineGenerator.invalidateAll();
+    m_d->thumbnailImageValid = false;
+}
+
+void KisPixelSelection::setOutlineCache(const QPainterPath &cache, const QRect &changedRect)
+{
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+    m_d->outlineCache = cache;
+    m_d->outlineCacheValid = true;
+    m_d->outlineGenerator.invalidate(changedRect);
     m_d->thumbnailImageValid = false;
 }
 
@@ -473,6 +528,15 @@ void KisPixelSelection::invalidateOutlineCache()
 {
     QMutexLocker locker(&m_d->outlineCacheMutex);
     m_d->outlineCacheValid = false;
+    m_d->outlineGenerator.invalidateAll();
+    m_d->thumbnailImageValid = false;
+}
+
+void KisPixelSelection::invalidateOutlineCache(const QRect &changedRect)
+{
+    QMutexLocker locker(&m_d->outlineCacheMutex);
+    m_d->outlineCacheValid = false;
+    m_d->outlineGenerator.invalidate(changedRect);
     m_d->thumbnailImageValid = false;
 }
 
@@ -482,15 +546,24 @@ void KisPixelSelection::recalculateOutlineCache()
 
     m_d->outlineCache = QPainterPath();
 
-    Q_FOREACH (const QPolygon &polygon, outline()) {
+    QRect selectionExtent = selectedExactRect();
+    QRect clipRect;
+
+    /**
+     * Pixels outside the image bounds are not included into the outline
+     * when the default pixel is selected, see outline()
+     */
+    if (*defaultPixel().data() != MIN_SELECTED) {
+        selectionExtent &= defaultBounds()->bounds();
+        clipRect = selectionExtent;
+    }
+
+    Q_FOREACH (const QPolygon &polygon, m_d->outlineGenerator.outline(this, selectionExtent, clipRect)) {
         m_d->outlineCache.addPolygon(polygon);
 
         /**
-         * The outline generation algorithm has a small bug, which
-         * results in the starting point be repeated twice in the
-         * beginning of the path, instead of being put to the
-         * end. Here we just explicitly close the path to workaround
-         * it.
+         * The generated polygons don't repeat their starting point
+         * in the end, so we should close the path explicitly.
          *
          * \see KisSelectionTest::testOutlineGeneration()
          */
@@ -118,6 +118,19 @@ public:
     void setOutlineCache(const QPainterPath &cache);
     void invalidateOutlineCache();
 
+    /**
+     * Same as setOutlineCache(const QPainterPath &cache), but lets the
+     * selection know that only pixels in \p changedRect have changed,
+     * so the next recalculation of the outline can be done incrementally
+     */
+    void setOutlineCache(const QPainterPath &cache, const QRect &changedRect);
+
+    /**
+     * Invalidates the outline cache, stating that only pixels in
+     * \p changedRect have changed since the last recalculation
+     */
+    void invalidateOutlineCache(const QRect &changedRect);
+
     bool thumbnailImageValid() const;
     QImage thumbnailImage() const;
     QTransform thumbnailImageTransform() const;
@@ -151,6 +164,12 @@ private:
      */
     void symmetricdifferenceSelection(KisPixelSelectionSP selection);
 
+    /**
+     * Invalidates the outline fragments of \p rc, or all of them
+     * if the default pixel is going to change to \p newDefaultPixel
+     */
+    void invalidateOutlineFragments(const QRect &rc, quint8 newDefaultPixel);
+
 private:
     // We don't want these methods to be used on selections:
     using KisPaintDevice::extent;
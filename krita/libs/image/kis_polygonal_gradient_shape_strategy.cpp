@@ -360,6 +360,14 @@ KisPolygonalGradientShapeStrategy::KisPolygonalGradientShapeStrategy(const QPain
 {
     m_selectionPath = simplifyPath(selectionPath, 0.01, 3.0, 100);
 
+    /**
+     * QPainterPath calculates its bounds lazily on the first call to
+     * contains(). Do it here, so that valueAt() could be called from
+     * several threads.
+     */
+    m_selectionPath.controlPointRect();
+    m_selectionPath.boundingRect();
+
     m_maxWeight = Private::calculateMaxWeight(m_selectionPath, m_exponent, true);
     m_minWeight = Private::calculateMaxWeight(m_selectionPath, m_exponent, false);
 
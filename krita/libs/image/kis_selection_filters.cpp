@@ -8,6 +8,9 @@
 #include "kis_selection_filters.h"
 
 #include <algorithm>
+#include <limits>
+
+#include <QtConcurrent>
 
 #include <klocalizedstring.h>
 
@@ -15,11 +18,206 @@
 #include "kis_convolution_painter.h"
 #include "kis_convolution_kernel.h"
 #include "kis_pixel_selection.h"
+#include "kis_sequential_iterator.h"
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define RINT(x) floor ((x) + 0.5)
 
+namespace {
+
+/**
+ * Returns true if all the pixels of \p rect are either fully selected
+ * or fully deselected. Grow and shrink of such selections can be done
+ * with a distance transform instead of the generic min/max filter.
+ */
+bool isBinarySelection(KisPaintDeviceSP device, const QRect &rect)
+{
+    KisSequentialConstIterator it(device, rect);
+
+    int numConseqPixels = it.nConseqPixels();
+    while (it.nextPixels(numConseqPixels)) {
+        numConseqPixels = it.nConseqPixels();
+        const quint8 *ptr = it.rawDataConst();
+
+        for (int i = 0; i < numConseqPixels; i++) {
+            if (ptr[i] != MIN_SELECTED && ptr[i] != MAX_SELECTED) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Grows (or, when \p invert is true, shrinks) a binary selection by the
+ * elliptic structuring element described by \p circ (see
+ * KisSelectionFilter::computeBorder()). The result is pixel-exact with
+ * the generic grow/shrink code, but the cost doesn't depend on the radius:
+ *
+ * 1) for every pixel we find the vertical distance \c g to the closest
+ *    "set" pixel in the same column (selected pixels for grow, deselected
+ *    ones for shrink);
+ *
+ * 2) since \c circ is non-increasing with the distance from the center,
+ *    the test "g <= circ[dx]" can be rewritten as "dx^2 + F(g) <= xRadius^2"
+ *    for a tabulated function F, so every row becomes a 1D distance
+ *    transform (lower envelope of parabolas, Felzenszwalb & Huttenlocher).
+ *
+ * The rect is split into horizontal bands that are processed concurrently.
+ * Each band reads from a copy of the device, so the bands never see each
+ * other's results.
+ */
+void processBinaryMorphology(KisPixelSelectionSP pixelSelection, const QRect &rect,
+                             qint32 xRadius, qint32 yRadius, const qint32 *circ,
+                             bool invert, bool frameIsSet)
+{
+    const quint8 setValue = invert ? MIN_SELECTED : MAX_SELECTED;
+    const quint8 unsetValue = invert ? MAX_SELECTED : MIN_SELECTED;
+
+    const qint64 threshold = qint64(xRadius) * xRadius;
+    const qint64 infinity = std::numeric_limits<qint64>::max() / 4;
+
+    // F(g) = xRadius^2 - max{i^2 : circ[i] >= g}, g > yRadius can never match
+    QVector<qint64> envelopeOffset(yRadius + 2, infinity);
+    for (qint32 g = 0; g <= yRadius; g++) {
+        qint32 i = xRadius;
+        while (i > 0 && circ[xRadius + i] < g) i--;
+        envelopeOffset[g] = threshold - qint64(i) * i;
+    }
+    const qint32 distanceCap = yRadius + 1;
+
+    KisPaintDeviceSP srcDevice = new KisPaintDevice(*pixelSelection);
+
+    const int bandHeight = qMax(64, (2 * yRadius + 63) & ~63);
+
+    QVector<QRect> bands;
+    for (int y = rect.y() - (rect.y() % bandHeight + bandHeight) % bandHeight;
+         y <= rect.bottom(); y += bandHeight) {
+
+        const QRect band = rect & QRect(rect.x(), y, rect.width(), bandHeight);
+        if (!band.isEmpty()) {
+            bands.append(band);
+        }
+    }
+
+    auto processBand = [&] (const QRect &band) {
+        const int width = rect.width();
+
+        const int windowTop = qMax(rect.top(), band.top() - yRadius);
+        const int windowBottom = qMin(rect.bottom(), band.bottom() + yRadius);
+        const int windowHeight = windowBottom - windowTop + 1;
+
+        QVector<quint8> window(width * windowHeight);
+        srcDevice->readBytes(window.data(), rect.x(), windowTop, width, windowHeight);
+
+        // vertical distance to the closest set pixel, capped by distanceCap
+        QVector<qint32> distance(width * band.height(), distanceCap);
+        QVector<qint32> running(width, distanceCap);
+
+        for (int y = windowTop; y <= windowBottom; y++) {
+            const quint8 *srcRow = window.constData() + (y - windowTop) * width;
+            const bool isBandRow = y >= band.top();
+            qint32 *dstRow = isBandRow ? distance.data() + (y - band.top()) * width : nullptr;
+
+            for (int x = 0; x < width; x++) {
+                running[x] = srcRow[x] == setValue ? 0 : qMin(running[x] + 1, distanceCap);
+                if (isBandRow) {
+                    dstRow[x] = running[x];
+                }
+            }
+
+            if (y >= band.bottom()) break;
+        }
+
+        running.fill(distanceCap);
+
+        for (int y = windowBottom; y >= band.top(); y--) {
+            const quint8 *srcRow = window.constData() + (y - windowTop) * width;
+            const bool isBandRow = y <= band.bottom();
+            qint32 *dstRow = isBandRow ? distance.data() + (y - band.top()) * width : nullptr;
+
+            for (int x = 0; x < width; x++) {
+                running[x] = srcRow[x] == setValue ? 0 : qMin(running[x] + 1, distanceCap);
+                if (isBandRow) {
+                    dstRow[x] = qMin(dstRow[x], running[x]);
+                }
+            }
+        }
+
+        if (frameIsSet) {
+            for (int y = band.top(); y <= band.bottom(); y++) {
+                const qint32 frameDistance =
+                    qMin(distanceCap, qMin(y - rect.top() + 1, rect.bottom() - y + 1));
+
+                qint32 *dstRow = distance.data() + (y - band.top()) * width;
+                for (int x = 0; x < width; x++) {
+                    dstRow[x] = qMin(dstRow[x], frameDistance);
+                }
+            }
+        }
+
+        // parabolas are indexed in [-1, width] to account for the frame columns
+        QVector<qint64> offsets(width + 2);
+        QVector<int> vertices(width + 2);
+        QVector<double> boundaries(width + 3);
+
+        QVector<quint8> out(width * band.height());
+
+        for (int y = band.top(); y <= band.bottom(); y++) {
+            const qint32 *distanceRow = distance.constData() + (y - band.top()) * width;
+            quint8 *outRow = out.data() + (y - band.top()) * width;
+
+            for (int x = -1; x <= width; x++) {
+                offsets[x + 1] =
+                    x < 0 || x >= width ?
+                        (frameIsSet ? envelopeOffset[0] : infinity) :
+                        envelopeOffset[distanceRow[x]];
+            }
+
+            auto intersection = [&] (int q, int v) {
+                return (double(offsets[q + 1] + qint64(q) * q) -
+                        double(offsets[v + 1] + qint64(v) * v)) / (2.0 * (q - v));
+            };
+
+            int k = -1;
+            for (int q = -1; q <= width; q++) {
+                if (offsets[q + 1] >= infinity) continue;
+
+                double s = 0.0;
+                while (k >= 0 && (s = intersection(q, vertices[k])) <= boundaries[k]) {
+                    k--;
+                }
+
+                k++;
+                vertices[k] = q;
+                boundaries[k] = k > 0 ? s : -std::numeric_limits<double>::infinity();
+                boundaries[k + 1] = std::numeric_limits<double>::infinity();
+            }
+
+            if (k < 0) {
+                memset(outRow, unsetValue, width);
+                continue;
+            }
+
+            int j = 0;
+            for (int x = 0; x < width; x++) {
+                while (boundaries[j + 1] < x) j++;
+
+                const qint64 dx = x - vertices[j];
+                outRow[x] = dx * dx + offsets[vertices[j] + 1] <= threshold ? setValue : unsetValue;
+            }
+        }
+
+        pixelSelection->writeBytes(out.constData(), band);
+    };
+
+    QtConcurrent::blockingMap(bands, processBand);
+}
+
+}
+
 KisSelectionFilter::~KisSelectionFilter()
 {
 }
@@ -560,6 +758,14 @@ void KisGrowSelectionFilter::process(KisPixelSelectionSP pixelSelection, const Q
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
+    if (isBinarySelection(pixelSelection, rect)) {
+        QVector<qint32> circ(2 * m_xRadius + 1);
+        computeBorder(circ.data(), m_xRadius, m_yRadius);
+
+        processBinaryMorphology(pixelSelection, rect, m_xRadius, m_yRadius, circ.constData(), false, false);
+        return;
+    }
+
     /**
         * Much code resembles Shrink filter, so please fix bugs
         * in both filters
@@ -687,6 +893,16 @@ void KisShrinkSelectionFilter::process(KisPixelSelectionSP pixelSelection, const
 {
     if (m_xRadius <= 0 || m_yRadius <= 0) return;
 
+    if (isBinarySelection(pixelSelection, rect)) {
+        QVector<qint32> circ(2 * m_xRadius + 1);
+        computeBorder(circ.data(), m_xRadius, m_yRadius);
+
+        // shrinking is growing of the deselected area, pixels outside
+        // the rect are deselected unless the edge is locked
+        processBinaryMorphology(pixelSelection, rect, m_xRadius, m_yRadius, circ.constData(), true, !m_edgeLock);
+        return;
+    }
+
     /*
         pretty much the same as fatten_region only different
         blame all bugs in this function on jaycox@gimp.org
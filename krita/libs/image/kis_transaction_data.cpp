@@ -345,7 +345,25 @@ void KisTransactionData::restoreSelectionOutlineCache(bool undo)
             savedOutlineCache = pixelSelection->outlineCache();
         }
 
-        if (m_d->savedOutlineCacheValid) {
+        /**
+         * When the device hasn't been moved, only the area of the memento
+         * has changed, so the outline can be regenerated incrementally
+         */
+        const bool changesAreLocal =
+            m_d->newOffset == m_d->oldOffset &&
+            !m_d->defaultPixelChanged &&
+            m_d->transactionFrameId == -1;
+
+        if (changesAreLocal) {
+            const QRect changedRect =
+                m_d->memento->extent().translated(m_d->device->x(), m_d->device->y());
+
+            if (m_d->savedOutlineCacheValid) {
+                pixelSelection->setOutlineCache(m_d->savedOutlineCache, changedRect);
+            } else {
+                pixelSelection->invalidateOutlineCache(changedRect);
+            }
+        } else if (m_d->savedOutlineCacheValid) {
             pixelSelection->setOutlineCache(m_d->savedOutlineCache);
         } else {
             pixelSelection->invalidateOutlineCache();
@@ -14,6 +14,8 @@
 #include <klocalizedstring.h>
 
 #include <QTransform>
+#include <QMutex>
+#include <QtConcurrent>
 
 #include <KoColorSpace.h>
 #include <KoCompositeOpRegistry.h>
@@ -30,6 +32,7 @@
 #include "kis_progress_update_helper.h"
 #include "kis_pixel_selection.h"
 #include "kis_image.h"
+#include "kis_algebra_2d.h"
 
 
 KisTransformWorker::KisTransformWorker(KisPaintDeviceSP dev,
@@ -183,6 +186,21 @@ void updateBounds<KisVLineIteratorSP>(QRect &boundRect, const KisFilterWeightsAp
     boundRect.setHeight(newBounds.size());
 }
 
+template <class iter>
+int tileGridOffset(const KisPaintDevice *dev);
+
+template <>
+int tileGridOffset<KisHLineIteratorSP>(const KisPaintDevice *dev)
+{
+    return dev->y();
+}
+
+template <>
+int tileGridOffset<KisVLineIteratorSP>(const KisPaintDevice *dev)
+{
+    return dev->x();
+}
+
 template <class T>
 void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
                                        double floatscale, double shear, double dx,
@@ -197,17 +215,45 @@ void KisTransformWorker::transformPass(KisPaintDevice *src, KisPaintDevice *dst,
     KisProgressUpdateHelper progressHelper(m_progressUpdater, portion, numLines);
     KisFilterWeightsBuffer buf(filterStrategy, qAbs(floatscale));
     KisFilterWeightsApplicator applicator(src, dst, floatscale, shear, dx, clampToEdge);
+    const qreal filterSupport = filterStrategy->support(buf.weightsPositionScale().toFloat());
 
-    KisFilterWeightsApplicator::LinePos dstBounds;
+    /**
+     * Every line is read and written independently from the others, so
+     * we can process the lines in parallel. The lines are grouped into
+     * bands aligned to the tiles of the device, so that the threads
+     * never write into the same tile.
+     */
+    const int bandSize = 64;
+    const int gridOffset = tileGridOffset<T>(dst);
 
-    for (int i = firstLine; i < firstLine + numLines; i++) {
-        KisFilterWeightsApplicator::LinePos dstPos;
-        KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+    QVector<QPair<int, int>> bands;
+    for (int start = firstLine; start < firstLine + numLines;) {
+        const int bandEnd =
+            (KisAlgebra2D::divideFloor(start - gridOffset, bandSize) + 1) * bandSize + gridOffset;
+        const int end = qMin(firstLine + numLines, bandEnd);
 
-        dstPos = applicator.processLine<T>(srcPos, i, &buf, filterStrategy->support(buf.weightsPositionScale().toFloat()));
-        dstBounds.unite(dstPos);
+        bands.append(qMakePair(start, end));
+        start = end;
+    }
 
-        progressHelper.step();
+    QVector<KisFilterWeightsApplicator::LinePos> lineBounds(numLines);
+    QMutex progressMutex;
+
+    QtConcurrent::blockingMap(bands, [&] (const QPair<int, int> &band) {
+        for (int i = band.first; i < band.second; i++) {
+            KisFilterWeightsApplicator::LinePos srcPos(srcStart, srcLen);
+
+            lineBounds[i - firstLine] = applicator.processLine<T>(srcPos, i, &buf, filterSupport);
+
+            QMutexLocker l(&progressMutex);
+            progressHelper.step();
+        }
+    });
+
+    // unite in the original order to get exactly the same bounds
+    KisFilterWeightsApplicator::LinePos dstBounds;
+    Q_FOREACH (const KisFilterWeightsApplicator::LinePos &pos, lineBounds) {
+        dstBounds.unite(pos);
     }
 
     updateBounds<T>(m_boundRect, dstBounds);
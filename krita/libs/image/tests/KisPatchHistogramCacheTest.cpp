@@ -0,0 +1,53 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "KisPatchHistogramCacheTest.h"
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include <kis_paint_device.h>
+#include <kis_sequential_iterator.h>
+#include <KisPatchHistogramCache.h>
+
+void KisPatchHistogramCacheTest::testIncrementalMatchesFullScan()
+{
+    const KoColorSpace *cs = KoColorSpaceRegistry::instance()->rgb8();
+    KisPaintDeviceSP device = new KisPaintDevice(cs);
+    const QRect bounds(0, 0, 1024, 1024);
+
+    srand(31524744);
+
+    KisSequentialIterator it(device, bounds);
+    while (it.nextPixel()) {
+        quint8 *pixel = it.rawData();
+        pixel[0] = rand() % 256;
+        pixel[1] = rand() % 256;
+        pixel[2] = rand() % 256;
+        pixel[3] = 255;
+    }
+
+    KisPatchHistogramCache cache;
+    cache.resetIfIncompatible(device, bounds);
+    const int totalPatches = cache.dirtyPatches().size();
+    cache.update(device, bounds);
+    QVERIFY(cache.dirtyPatches().isEmpty());
+
+    // only the patches under the dab are rescanned
+    const QRect dabRect(500, 500, 100, 100);
+    device->fill(dabRect, KoColor(Qt::red, cs));
+    cache.invalidateRect(dabRect);
+    QVERIFY(!cache.dirtyPatches().isEmpty());
+    QVERIFY(cache.dirtyPatches().size() < totalPatches);
+    cache.update(device, bounds);
+
+    KisPatchHistogramCache reference;
+    reference.update(device, bounds);
+
+    QVERIFY(cache.mergedBins() == reference.mergedBins());
+}
+
+SIMPLE_TEST_MAIN(KisPatchHistogramCacheTest)
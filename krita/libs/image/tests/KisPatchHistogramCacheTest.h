@@ -0,0 +1,19 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KISPATCHHISTOGRAMCACHETEST_H
+#define KISPATCHHISTOGRAMCACHETEST_H
+
+#include <simpletest.h>
+
+class KisPatchHistogramCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testIncrementalMatchesFullScan();
+};
+
+#endif // KISPATCHHISTOGRAMCACHETEST_H
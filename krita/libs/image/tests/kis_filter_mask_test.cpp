@@ -7,6 +7,7 @@
 #include "kis_filter_mask_test.h"
 #include <simpletest.h>
 
+#include <KoColor.h>
 #include <KoColorSpaceRegistry.h>
 
 #include "kis_selection.h"
@@ -14,6 +15,7 @@
 #include "filter/kis_filter_configuration.h"
 #include "kis_filter_mask.h"
 #include "filter/kis_filter_registry.h"
+#include "filter/KisFilterResultCache.h"
 #include "kis_group_layer.h"
 #include "kis_paint_device.h"
 #include "kis_paint_layer.h"
@@ -98,4 +100,130 @@ void KisFilterMaskTest::testProjectionSelected()
 
 }
 
+void KisFilterMaskTest::testResultCache()
+{
+    TestUtil::MaskParent p(QRect(0, 0, IMAGE_WIDTH, IMAGE_HEIGHT));
+    KisImageSP image = p.image;
+    KisPaintLayerSP layer = p.layer;
+
+    QImage qimage(QString(FILES_DATA_DIR) + '/' + "hakonepa.png");
+    layer->paintDevice()->convertFromQImage(qimage, 0, 0, 0);
+
+    KisFilterSP f = KisFilterRegistry::instance()->value("blur");
+    Q_ASSERT(f);
+    KisFilterConfigurationSP kfc = f->defaultConfiguration(KisGlobalResourcesInterface::instance());
+    Q_ASSERT(kfc);
+
+    KisFilterMaskSP mask = new KisFilterMask(image, "mask");
+    image->addNode(mask, layer);
+
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    mask->createNodeProgressProxy();
+    mask->initSelection(layer);
+    mask->select(qimage.rect(), MAX_SELECTED);
+
+    // let the updates caused by adding the mask finish
+    image->waitForDone();
+
+    const QRect rc = qimage.rect();
+
+    auto applyMask = [&] () {
+        KisPaintDeviceSP projection = new KisPaintDevice(*layer->paintDevice());
+        mask->apply(projection, rc, rc, KisNode::N_FILTHY);
+        return projection;
+    };
+
+    auto applyFilterDirectly = [&] () {
+        KisPaintDeviceSP projection = new KisPaintDevice(*layer->paintDevice());
+        f->process(projection, rc, mask->filter());
+        return projection;
+    };
+
+    KisFilterResultCache *cache = mask->filterResultCache();
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+
+    const KisFilterResultCache::Stats initialStats = cache->stats();
+    QCOMPARE(initialStats.memoryUsage, 0);
+
+    // the first render only remembers the input of the cells
+    KisPaintDeviceSP result = applyMask();
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectly()));
+
+    const qint64 misses = cache->stats().misses - initialStats.misses;
+    QVERIFY(misses > 0);
+    QCOMPARE(cache->stats().hits, initialStats.hits);
+    QCOMPARE(cache->stats().memoryUsage, 0);
+
+    // the same input is filtered for the second time, now it is stored
+    result = applyMask();
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectly()));
+    QCOMPARE(cache->stats().hits, initialStats.hits);
+    QCOMPARE(cache->stats().misses - initialStats.misses, 2 * misses);
+    QVERIFY(cache->stats().memoryUsage > 0);
+    QCOMPARE(cache->stats().totalMemoryUsage, cache->stats().memoryUsage);
+
+    // the same input should be fetched from the cache
+    result = applyMask();
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectly()));
+    QCOMPARE(cache->stats().hits - initialStats.hits, misses);
+    QCOMPARE(cache->stats().misses - initialStats.misses, 2 * misses);
+
+    // changed input should be refiltered, the rest is still cached
+    layer->paintDevice()->fill(QRect(300, 300, 50, 50), KoColor(Qt::red, layer->colorSpace()));
+    result = applyMask();
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectly()));
+    QVERIFY(cache->stats().misses - initialStats.misses > 2 * misses);
+    QVERIFY(cache->stats().hits - initialStats.hits > misses);
+
+    // a missed cell of a rect that is not aligned to the cells doesn't
+    // force the cached cells to be filtered again
+    const QRect unalignedRect = rc.adjusted(10, 10, -10, -10);
+
+    auto applyMaskUnaligned = [&] () {
+        KisPaintDeviceSP projection = new KisPaintDevice(*layer->paintDevice());
+        mask->apply(projection, unalignedRect, unalignedRect, KisNode::N_FILTHY);
+        return projection;
+    };
+
+    auto applyFilterDirectlyUnaligned = [&] () {
+        KisPaintDeviceSP projection = new KisPaintDevice(*layer->paintDevice());
+        f->process(projection, unalignedRect, mask->filter());
+        return projection;
+    };
+
+    layer->paintDevice()->fill(QRect(300, 300, 50, 50), KoColor(Qt::blue, layer->colorSpace()));
+    const qint64 hitsBeforeUnaligned = cache->stats().hits;
+    result = applyMaskUnaligned();
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectlyUnaligned()));
+    QVERIFY(cache->stats().hits > hitsBeforeUnaligned);
+
+    // changing the filter drops the cache
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    QCOMPARE(cache->stats().memoryUsage, 0);
+    QCOMPARE(cache->stats().totalMemoryUsage, 0);
+
+    // zero total limit disables caching in all the nodes
+    const qint64 totalLimit = cache->stats().totalMemoryLimit;
+    KisFilterResultCache::setTotalMemoryLimit(0);
+    qint64 hits = cache->stats().hits;
+    for (int i = 0; i < 3; i++) {
+        result = applyMask();
+    }
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectly()));
+    QCOMPARE(cache->stats().hits, hits);
+    QCOMPARE(cache->stats().memoryUsage, 0);
+    KisFilterResultCache::setTotalMemoryLimit(totalLimit);
+
+    // zero limit disables caching
+    mask->setFilter(kfc->cloneWithResourcesSnapshot());
+    cache->setMemoryLimit(0);
+    hits = cache->stats().hits;
+    for (int i = 0; i < 3; i++) {
+        result = applyMask();
+    }
+    QVERIFY(TestUtil::comparePaintDevicesClever<quint8>(result, applyFilterDirectly()));
+    QCOMPARE(cache->stats().hits, hits);
+    QCOMPARE(cache->stats().memoryUsage, 0);
+}
+
 SIMPLE_TEST_MAIN(KisFilterMaskTest)
@@ -146,4 +146,72 @@ void KisOnionSkinCompositorTest::testSettings()
     QVERIFY(chk.checkDevice(compositeDevice, p.image, "02_single_skin_tinted"));
 }
 
+void KisOnionSkinCompositorTest::testTintedFramesCache()
+{
+    KisOnionSkinCompositor *compositor = KisOnionSkinCompositor::instance();
+
+    TestUtil::MaskParent p;
+    KisImageAnimationInterface *i = p.image->animationInterface();
+    KisPaintDeviceSP paintDevice = p.layer->paintDevice();
+    paintDevice->createKeyframeChannel(KoID());
+    KisKeyframeChannel *keyframes = paintDevice->keyframeChannel();
+
+    keyframes->addKeyframe(0);
+    keyframes->addKeyframe(1);
+    keyframes->addKeyframe(2);
+
+    paintDevice->fill(QRect(0,0,256,512), KoColor(Qt::red, paintDevice->colorSpace()));
+
+    i->switchCurrentTimeAsync(2);
+    p.image->waitForDone();
+
+    paintDevice->fill(QRect(0,256,512,256), KoColor(Qt::blue, paintDevice->colorSpace()));
+
+    i->switchCurrentTimeAsync(1);
+    p.image->waitForDone();
+
+    KisImageConfig config(false);
+    config.setNumberOfOnionSkins(1);
+    config.setOnionSkinTintFactor(64);
+    config.setOnionSkinOpacity(-1, 128);
+    config.setOnionSkinOpacity(1, 192);
+    compositor->configChanged();
+
+    KisOnionSkinCompositor::TintedFramesCache cache;
+    KisPaintDeviceSP cachedDevice = new KisPaintDevice(p.image->colorSpace());
+    KisPaintDeviceSP referenceDevice = new KisPaintDevice(p.image->colorSpace());
+    QPoint errorPoint;
+
+    auto compositeAndCompare = [&] () {
+        cachedDevice->clear();
+        referenceDevice->clear();
+
+        compositor->composite(paintDevice, cachedDevice, QRect(0,0,512,512), &cache);
+        compositor->composite(paintDevice, referenceDevice, QRect(0,0,512,512));
+
+        return TestUtil::comparePaintDevices(errorPoint, cachedDevice, referenceDevice);
+    };
+
+    // the first pass fills the cache, the second one reuses it
+    QVERIFY(compositeAndCompare());
+    QVERIFY(compositeAndCompare());
+
+    // changing the content of a skin frame should regenerate it
+    i->switchCurrentTimeAsync(2);
+    p.image->waitForDone();
+
+    paintDevice->fill(QRect(128,0,256,256), KoColor(Qt::green, paintDevice->colorSpace()));
+
+    i->switchCurrentTimeAsync(1);
+    p.image->waitForDone();
+
+    QVERIFY(compositeAndCompare());
+
+    // as well as changing the tint
+    config.setOnionSkinTintColorForward(Qt::yellow);
+    compositor->configChanged();
+
+    QVERIFY(compositeAndCompare());
+}
+
 SIMPLE_TEST_MAIN(KisOnionSkinCompositorTest)
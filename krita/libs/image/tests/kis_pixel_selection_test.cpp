@@ -10,6 +10,8 @@
 
 #include <kis_debug.h>
 #include <QRect>
+#include <QPainter>
+#include <QPainterPath>
 
 #include <KoColorSpace.h>
 #include <KoColorSpaceRegistry.h>
@@ -25,6 +27,7 @@
 #include "kis_transaction.h"
 #include "kis_surrogate_undo_adapter.h"
 #include "commands/kis_selection_commands.h"
+#include "KisIncrementalOutlineGenerator.h"
 
 
 void KisPixelSelectionTest::testCreation()
@@ -367,6 +370,134 @@ void KisPixelSelectionTest::testOutlineCacheTransactions()
     }
 }
 
+void KisPixelSelectionTest::testIncrementalOutlineCache()
+{
+    KisPixelSelectionSP psel = new KisPixelSelection();
+
+    for (int i = 0; i < 20; i++) {
+        psel->select(QRect(i * 17, (i * 29) % 200, 40, 30));
+    }
+
+    psel->invalidateOutlineCache();
+    psel->recalculateOutlineCache();
+    QVERIFY(psel->outlineCacheValid());
+
+    KisPixelSelectionSP psel2 = new KisPixelSelection();
+    psel2->select(QRect(150, 60, 70, 90));
+    psel2->clear(QRect(170, 80, 20, 20));
+    psel2->invalidateOutlineCache();
+
+    // only the tiles touched by psel2 are regenerated
+    psel->applySelection(psel2, SELECTION_SUBTRACT);
+    QVERIFY(!psel->outlineCacheValid());
+
+    psel->recalculateOutlineCache();
+    const QPainterPath incrementalOutline = psel->outlineCache();
+
+    psel->invalidateOutlineCache();
+    psel->recalculateOutlineCache();
+    const QPainterPath fullOutline = psel->outlineCache();
+
+    QCOMPARE(incrementalOutline, fullOutline);
+    QCOMPARE(fullOutline.boundingRect(), QRectF(psel->selectedExactRect()));
+}
+
+void KisPixelSelectionTest::testIncrementalOutlineMatchesLegacy_data()
+{
+    QTest::addColumn<int>("shape");
+    QTest::addColumn<bool>("compareCount");
+
+    // diagonally touching pixels may be traced as one polygon by one
+    // generator and as two by the other, the covered area is the same
+    QTest::newRow("rect") << 0 << true;
+    QTest::newRow("hole") << 1 << true;
+    QTest::newRow("tile-borders") << 2 << true;
+    QTest::newRow("overlapping-rects") << 3 << true;
+    QTest::newRow("semi-transparent") << 4 << true;
+    QTest::newRow("diagonal") << 5 << false;
+}
+
+void KisPixelSelectionTest::testIncrementalOutlineMatchesLegacy()
+{
+    QFETCH(int, shape);
+    QFETCH(bool, compareCount);
+
+    KisPixelSelectionSP psel = new KisPixelSelection();
+
+    switch (shape) {
+    case 0:
+        psel->select(QRect(10, 20, 30, 40));
+        break;
+    case 1:
+        psel->select(QRect(10, 10, 200, 150));
+        psel->clear(QRect(50, 50, 40, 30));
+        psel->clear(QRect(120, 60, 1, 1));
+        break;
+    case 2:
+        psel->select(QRect(60, 60, 10, 10));
+        psel->select(QRect(127, 0, 2, 200));
+        psel->select(QRect(0, 191, 300, 2));
+        break;
+    case 3:
+        for (int i = 0; i < 20; i++) {
+            psel->select(QRect(i * 17, (i * 29) % 200, 40, 30));
+        }
+        break;
+    case 4:
+        psel->select(QRect(10, 10, 100, 100), 128);
+        psel->select(QRect(50, 50, 100, 100), 1);
+        break;
+    case 5:
+        psel->select(QRect(10, 10, 1, 1));
+        psel->select(QRect(11, 11, 1, 1));
+        psel->select(QRect(63, 63, 1, 1));
+        psel->select(QRect(64, 64, 1, 1));
+        psel->select(QRect(65, 63, 1, 1));
+        break;
+    }
+
+    const QRect rc = psel->selectedExactRect();
+
+    const QVector<QPolygon> legacyOutline = psel->outline();
+
+    KisIncrementalOutlineGenerator generator(psel->colorSpace(), MIN_SELECTED);
+    const QVector<QPolygon> incrementalOutline = generator.outline(psel.data(), rc);
+
+    auto renderOutline = [rc] (const QVector<QPolygon> &polygons) {
+        QPainterPath path;
+        path.setFillRule(Qt::OddEvenFill);
+        Q_FOREACH (const QPolygon &polygon, polygons) {
+            path.addPolygon(polygon);
+            path.closeSubpath();
+        }
+
+        QImage image(rc.size(), QImage::Format_ARGB32);
+        image.fill(Qt::transparent);
+
+        QPainter gc(&image);
+        gc.translate(-rc.topLeft());
+        gc.fillPath(path, Qt::black);
+
+        return image;
+    };
+
+    if (compareCount) {
+        QCOMPARE(incrementalOutline.size(), legacyOutline.size());
+    }
+
+    const QImage incrementalImage = renderOutline(incrementalOutline);
+    QCOMPARE(incrementalImage, renderOutline(legacyOutline));
+
+    // the outline covers exactly the selected pixels
+    for (int y = rc.top(); y <= rc.bottom(); y++) {
+        for (int x = rc.left(); x <= rc.right(); x++) {
+            const bool selected = *psel->pixel(QPoint(x, y)).data() != MIN_SELECTED;
+            const bool covered = qAlpha(incrementalImage.pixel(x - rc.x(), y - rc.y())) != 0;
+            QCOMPARE(covered, selected);
+        }
+    }
+}
+
 #include "kis_paint_device_debug_utils.h"
 #include <sdk/tests/testing_timed_default_bounds.h>
 
@@ -34,6 +34,10 @@ private Q_SLOTS:
 
     void testOutlineCacheTransactions();
 
+    void testIncrementalOutlineCache();
+    void testIncrementalOutlineMatchesLegacy_data();
+    void testIncrementalOutlineMatchesLegacy();
+
     void testOutlineArtifacts();
 };
 
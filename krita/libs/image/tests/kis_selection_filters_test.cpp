@@ -0,0 +1,145 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_selection_filters_test.h"
+
+#include <random>
+
+#include <simpletest.h>
+
+#include "kis_debug.h"
+#include "kis_pixel_selection.h"
+#include "kis_selection_filters.h"
+
+namespace {
+
+/**
+ * Random ellipses and rectangles with the exact \p selectedValue inside.
+ * Some of them cross the border of \p rect and one covers a whole edge.
+ */
+KisPixelSelectionSP createSelection(const QRect &rect, quint8 selectedValue)
+{
+    const QRect area = rect.adjusted(-20, -20, 20, 20);
+    QVector<quint8> pixels(area.width() * area.height(), MIN_SELECTED);
+
+    std::minstd_rand rng(42);
+
+    auto randomRect = [&] () {
+        const int x = area.x() + int(rng() % area.width());
+        const int y = area.y() + int(rng() % area.height());
+        return QRect(x, y, 5 + int(rng() % 60), 5 + int(rng() % 60)) & area;
+    };
+
+    auto fill = [&] (const QRect &shape, bool ellipse) {
+        const QPointF center = QRectF(shape).center();
+        const qreal a = 0.5 * shape.width();
+        const qreal b = 0.5 * shape.height();
+
+        for (int y = shape.top(); y <= shape.bottom(); y++) {
+            for (int x = shape.left(); x <= shape.right(); x++) {
+                const qreal dx = (x + 0.5 - center.x()) / a;
+                const qreal dy = (y + 0.5 - center.y()) / b;
+
+                if (!ellipse || dx * dx + dy * dy <= 1.0) {
+                    pixels[(y - area.y()) * area.width() + x - area.x()] = selectedValue;
+                }
+            }
+        }
+    };
+
+    for (int i = 0; i < 12; i++) {
+        fill(randomRect(), true);
+    }
+
+    for (int i = 0; i < 6; i++) {
+        fill(randomRect(), false);
+    }
+
+    fill(QRect(area.x(), rect.y() + 30, 40, area.height() - 30), false);
+
+    KisPixelSelectionSP selection = new KisPixelSelection();
+    selection->writeBytes(pixels.constData(), area);
+    return selection;
+}
+
+}
+
+void KisSelectionFiltersTest::testBinaryMorphology_data()
+{
+    QTest::addColumn<bool>("grow");
+    QTest::addColumn<int>("xRadius");
+    QTest::addColumn<int>("yRadius");
+    QTest::addColumn<bool>("edgeLock");
+
+    const QVector<QPair<int, int>> radii = {{1, 1}, {2, 1}, {1, 3}, {4, 4}, {7, 3}, {3, 9}, {16, 11}};
+
+    for (const QPair<int, int> &radius : radii) {
+        QTest::addRow("grow %dx%d", radius.first, radius.second)
+            << true << radius.first << radius.second << false;
+
+        for (bool edgeLock : {false, true}) {
+            QTest::addRow("shrink %dx%d%s", radius.first, radius.second, edgeLock ? " edge lock" : "")
+                << false << radius.first << radius.second << edgeLock;
+        }
+    }
+}
+
+/**
+ * A binary selection is grown and shrunk with a distance transform instead
+ * of the generic min/max filter. Selecting with 254 instead of 255 makes
+ * the selection non-binary, so the generic code runs on the same shapes,
+ * and the results should match exactly.
+ */
+void KisSelectionFiltersTest::testBinaryMorphology()
+{
+    QFETCH(bool, grow);
+    QFETCH(int, xRadius);
+    QFETCH(int, yRadius);
+    QFETCH(bool, edgeLock);
+
+    const QRect rect(10, 20, 200, 150);
+
+    QScopedPointer<KisSelectionFilter> filter;
+    if (grow) {
+        filter.reset(new KisGrowSelectionFilter(xRadius, yRadius));
+    } else {
+        filter.reset(new KisShrinkSelectionFilter(xRadius, yRadius, edgeLock));
+    }
+
+    KisPixelSelectionSP binary = createSelection(rect, MAX_SELECTED);
+    KisPixelSelectionSP generic = createSelection(rect, MAX_SELECTED - 1);
+
+    filter->process(binary, rect);
+    filter->process(generic, rect);
+
+    QVector<quint8> binaryPixels(rect.width() * rect.height());
+    QVector<quint8> genericPixels(rect.width() * rect.height());
+
+    binary->readBytes(binaryPixels.data(), rect);
+    generic->readBytes(genericPixels.data(), rect);
+
+    int mismatches = 0;
+    for (int i = 0; i < binaryPixels.size(); i++) {
+        const quint8 expected = genericPixels[i] == MAX_SELECTED - 1 ? MAX_SELECTED : genericPixels[i];
+        if (binaryPixels[i] != expected) {
+            if (!mismatches) {
+                qDebug() << "first mismatch at" << rect.x() + i % rect.width() << rect.y() + i / rect.width()
+                         << ppVar(binaryPixels[i]) << ppVar(genericPixels[i]);
+            }
+            mismatches++;
+        }
+    }
+
+    QCOMPARE(mismatches, 0);
+
+    // the test is meaningless if the filter didn't change anything
+    KisPixelSelectionSP original = createSelection(rect, MAX_SELECTED);
+    QVector<quint8> originalPixels(rect.width() * rect.height());
+    original->readBytes(originalPixels.data(), rect);
+    QVERIFY(originalPixels != binaryPixels);
+}
+
+SIMPLE_TEST_MAIN(KisSelectionFiltersTest)
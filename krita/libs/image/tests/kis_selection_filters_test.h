@@ -0,0 +1,21 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KIS_SELECTION_FILTERS_TEST_H
+#define KIS_SELECTION_FILTERS_TEST_H
+
+#include <simpletest.h>
+
+class KisSelectionFiltersTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testBinaryMorphology_data();
+    void testBinaryMorphology();
+};
+
+#endif
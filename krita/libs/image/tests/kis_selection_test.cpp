@@ -313,11 +313,12 @@ void KisSelectionTest::testOutlineGeneration()
     closedSubPath.closeSubpath();
 
     /**
-     * Our outline generation code has a small problem: it can
-     * generate a polygon, which isn't closed (it'll repeat the first
-     * point instead). There is a special workaround for it in
-     * KisPixelSelection::recalculateOutlineCache(), which explicitly
-     * closes the path, so here we just check it.
+     * KisIncrementalOutlineGenerator, which is used by
+     * KisPixelSelection::recalculateOutlineCache(), returns polygons
+     * that don't repeat their starting point. The legacy
+     * KisOutlineGenerator, still used by KisPixelSelection::outline(),
+     * repeats it instead. recalculateOutlineCache() closes every
+     * subpath explicitly, so here we just check it.
      */
 
     bool isClosed = closedSubPath == calculatedOutline;
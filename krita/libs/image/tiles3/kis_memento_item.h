@@ -141,6 +141,34 @@ public:
         m_committedFlag = true;
     }
 
+    /**
+     * If the pixels of \p rhs are exactly the same as ours, drop our
+     * own tile data and share the one of \p rhs instead. Both items
+     * must already be committed, so both tile datas are frozen by COW.
+     *
+     * Returns true if the tile data has been shared.
+     */
+    bool shareTileDataIfEqual(KisMementoItem *rhs) {
+        if (!m_committedFlag || !rhs->m_committedFlag) return false;
+        if (!m_tileData || !rhs->m_tileData) return false;
+        if (m_tileData == rhs->m_tileData) return false;
+        if (!m_tileData->contentEquals(rhs->m_tileData)) return false;
+
+        KisTileData *tileData = rhs->m_tileData;
+
+        /**
+         * Setting counters to proper values:
+         * m_refCount++, m_usersCount++;
+         */
+        tileData->acquire();
+        tileData->setMementoed(true);
+
+        releaseTileData();
+        m_tileData = tileData;
+
+        return true;
+    }
+
     inline KisTileSP tile(KisMementoManager *mm) {
         Q_ASSERT(m_tileData);
         return KisTileSP(new KisTile(m_col, m_row, m_tileData, mm));
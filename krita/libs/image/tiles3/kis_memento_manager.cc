@@ -192,6 +192,19 @@ void KisMementoManager::commit()
         mi->commit();
         revisionList.append(mi);
 
+        /**
+         * The tile could have been touched by the transaction without
+         * actually changing its pixels (e.g. a stroke that painted
+         * with zero opacity or a fill with the same color). In such a
+         * case the parent revision may reuse our tile data, so that
+         * the history doesn't keep two identical copies of the tile.
+         */
+        if (mi->type() == KisMementoItem::CHANGED &&
+            parentMI->type() == KisMementoItem::CHANGED) {
+
+            parentMI->shareTileDataIfEqual(mi.data());
+        }
+
         m_headsHashTable.deleteTile(mi->col(), mi->row());
 
         iter.moveCurrentToHashTable(&m_headsHashTable);
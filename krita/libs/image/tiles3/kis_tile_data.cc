@@ -126,6 +126,31 @@ void KisTileData::releaseMemory()
     Q_ASSERT(m_clonesStack.isEmpty());
 }
 
+bool KisTileData::contentEquals(KisTileData *rhs)
+{
+    if (rhs == this) return true;
+    if (rhs->m_pixelSize != m_pixelSize) return false;
+
+    /**
+     * We should never force the data to be loaded from the swap
+     * just for comparison, so only try to lock both tile datas
+     * and give up if any of them is not present in memory.
+     */
+    bool result = false;
+
+    if (m_swapLock.tryLockForRead()) {
+        if (rhs->m_swapLock.tryLockForRead()) {
+            if (m_data && rhs->m_data) {
+                result = !memcmp(m_data, rhs->m_data, m_pixelSize * WIDTH * HEIGHT);
+            }
+            rhs->m_swapLock.unlock();
+        }
+        m_swapLock.unlock();
+    }
+
+    return result;
+}
+
 void KisTileData::allocateMemory()
 {
     Q_ASSERT(!m_data);
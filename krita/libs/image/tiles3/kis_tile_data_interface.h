@@ -180,6 +180,14 @@ public:
      */
     inline bool historical() const;
 
+    /**
+     * Returns true if the pixels of the two tile datas are exactly
+     * the same. The comparison is never forced to load the data from
+     * the swap: if any of the tile datas is swapped out, the function
+     * returns false.
+     */
+    bool contentEquals(KisTileData *rhs);
+
     /**
      * Used for swapping purposes only.
      * Frees the memory occupied by the tile data.
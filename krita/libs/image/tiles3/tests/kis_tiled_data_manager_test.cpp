@@ -527,6 +527,59 @@ void KisTiledDataManagerTest::testUndoSetDefaultPixel()
     QVERIFY(memoryIsFilled(oddPixel2, tile10->data(), TILESIZE));
 }
 
+void KisTiledDataManagerTest::testSharedHistoricalTileData()
+{
+    quint8 defaultPixel = 0;
+    KisTiledDataManager dm(1, &defaultPixel);
+
+    quint8 oddPixel1 = 128;
+    quint8 oddPixel2 = 129;
+
+    // partial clears go through COW of the existing tile
+    QRect fillRect(0,0,32,32);
+    QRect tileRect(0,0,64,64);
+
+    quint8 *buffer = new quint8[tileRect.width()*tileRect.height()];
+
+    KisMementoSP memento1 = dm.getMemento();
+    dm.clear(fillRect, &oddPixel1);
+    dm.commit();
+
+    // the same pixels are written again
+    KisMementoSP memento2 = dm.getMemento();
+    dm.clear(fillRect, &oddPixel1);
+    dm.commit();
+
+    KisTileData *currentTileData = dm.getTile(0, 0, false)->tileData();
+
+    KisMementoSP memento3 = dm.getMemento();
+    dm.clear(fillRect, &oddPixel2);
+    dm.commit();
+
+    dm.rollback(memento3);
+    dm.readBytes(buffer, tileRect.x(), tileRect.y(), tileRect.width(), tileRect.height());
+    QVERIFY(checkHole(buffer, oddPixel1, fillRect, defaultPixel, tileRect));
+
+    dm.rollback(memento2);
+    dm.readBytes(buffer, tileRect.x(), tileRect.y(), tileRect.width(), tileRect.height());
+    QVERIFY(checkHole(buffer, oddPixel1, fillRect, defaultPixel, tileRect));
+
+    // the first revision should have reused the tile data of the second one
+    QCOMPARE(dm.getTile(0, 0, false)->tileData(), currentTileData);
+
+    dm.rollback(memento1);
+    dm.readBytes(buffer, tileRect.x(), tileRect.y(), tileRect.width(), tileRect.height());
+    QVERIFY(checkHole(buffer, defaultPixel, fillRect, defaultPixel, tileRect));
+
+    dm.rollforward(memento1);
+    dm.rollforward(memento2);
+    dm.rollforward(memento3);
+    dm.readBytes(buffer, tileRect.x(), tileRect.y(), tileRect.width(), tileRect.height());
+    QVERIFY(checkHole(buffer, oddPixel2, fillRect, defaultPixel, tileRect));
+
+    delete[] buffer;
+}
+
 //#include <valgrind/callgrind.h>
 
 void KisTiledDataManagerTest::benchmarkReadOnlyTileLazy()
@@ -44,6 +44,7 @@
 #include <kis_raster_keyframe_channel.h>
 #include <kis_keyframe.h>
 #include "kis_selection.h"
+#include "tiles3/kis_tile_data_interface.h"
 
 #include "InfoObject.h"
 #include "Krita.h"
@@ -66,6 +67,7 @@
 
 #include "LibKisUtils.h"
 #include <kis_layer_utils.h>
+#include <krita_utils.h>
 
 struct Node::Private {
     Private() {}
@@ -605,6 +607,82 @@ bool Node::setPixelData(QByteArray value, int x, int y, int w, int h)
     return true;
 }
 
+QList<QRect> Node::tileRects(int x, int y, int w, int h, int patchSize) const
+{
+    QList<QRect> rects;
+
+    if (!d->node) return rects;
+
+    KisPaintDeviceSP dev = d->node->paintDevice();
+    if (!dev) return rects;
+
+    // round the patches up to whole tiles
+    const int tileWidth = KisTileData::WIDTH;
+    const int tileHeight = KisTileData::HEIGHT;
+    const int patchWidth = qMax(tileWidth, (patchSize + tileWidth - 1) / tileWidth * tileWidth);
+    const int patchHeight = qMax(tileHeight, (patchSize + tileHeight - 1) / tileHeight * tileHeight);
+
+    // the tile grid is bound to the origin of the paint device
+    const QPoint offset(dev->x(), dev->y());
+    const QVector<QRect> patches =
+        KritaUtils::splitRectIntoPatches(QRect(x, y, w, h).translated(-offset),
+                                         QSize(patchWidth, patchHeight));
+
+    Q_FOREACH (const QRect &patch, patches) {
+        rects << patch.translated(offset);
+    }
+
+    return rects;
+}
+
+QList<QByteArray> Node::pixelDataForRects(const QList<QRect> &rects) const
+{
+    QList<QByteArray> result;
+
+    if (!d->node) return result;
+
+    KisPaintDeviceSP dev = d->node->paintDevice();
+    if (!dev) return result;
+
+    const int pixelSize = dev->pixelSize();
+
+    Q_FOREACH (const QRect &rect, rects) {
+        QByteArray ba;
+        ba.resize(rect.width() * rect.height() * pixelSize);
+        dev->readBytes(reinterpret_cast<quint8*>(ba.data()), rect);
+        result << ba;
+    }
+
+    return result;
+}
+
+bool Node::setPixelDataForRects(const QList<QByteArray> &values, const QList<QRect> &rects)
+{
+    if (!d->node) return false;
+    KisPaintDeviceSP dev = d->node->paintDevice();
+    if (!dev) return false;
+
+    if (values.size() != rects.size()) {
+        qWarning() << "Node::setPixelDataForRects: the number of byte arrays does not match the number of rects";
+        return false;
+    }
+
+    const int pixelSize = dev->colorSpace()->pixelSize();
+
+    for (int i = 0; i < rects.size(); i++) {
+        if (values[i].length() < rects[i].width() * rects[i].height() * pixelSize) {
+            qWarning() << "Node::setPixelDataForRects: not enough data to write to the paint device" << rects[i];
+            return false;
+        }
+    }
+
+    for (int i = 0; i < rects.size(); i++) {
+        dev->writeBytes(reinterpret_cast<const quint8*>(values[i].constData()), rects[i]);
+    }
+
+    return true;
+}
+
 QRect Node::bounds() const
 {
     if (!d->node) return QRect();
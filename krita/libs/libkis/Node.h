@@ -445,6 +445,65 @@ public Q_SLOTS:
      */
     bool setPixelData(QByteArray value, int x, int y, int w, int h);
 
+    /**
+     * @brief tileRects splits the given rectangle into patches that are aligned to the
+     * grid of tiles Krita stores the node's pixels in.
+     *
+     * Reading or writing an aligned patch with pixelData() or setPixelData() touches as
+     * few tiles as possible, which makes processing a large layer patch by patch
+     * faster than reading it row by row or in arbitrary chunks. The pixels are still
+     * copied, see pixelDataForRects(). In Python:
+     *
+     * @code
+     * for rect in node.tileRects(0, 0, doc.width(), doc.height()):
+     *     data = node.pixelData(rect.x(), rect.y(), rect.width(), rect.height())
+     *     ...
+     * @endcode
+     *
+     * @param x the x position of the rectangle
+     * @param y the y position of the rectangle
+     * @param w the width of the rectangle
+     * @param h the height of the rectangle
+     * @param patchSize the maximal size of a patch. It is rounded up to a multiple
+     * of the tile size.
+     * @return the list of patches covering the rectangle, ordered row-first. The list
+     * is empty if the node has no pixel data.
+     */
+    QList<QRect> tileRects(int x, int y, int w, int h, int patchSize = 256) const;
+
+    /**
+     * @brief pixelDataForRects reads several rectangles of the Node's paintable pixels in
+     * one call. Each byte array has the same layout as the one returned by pixelData().
+     *
+     * Together with tileRects() this allows processing a whole layer in batches without
+     * calling into Krita once per patch.
+     *
+     * <b>Note:</b> this is not a zero-copy API. Like pixelData(), every rectangle is copied
+     * out of the paint device's tiles into a newly allocated byte array, so reading a layer
+     * this way copies exactly as many bytes as reading it with pixelData(). The only saving
+     * is the per-call overhead when many small rectangles are read. The tile memory itself
+     * is never exposed. In Python, numpy.frombuffer() can wrap each returned byte array
+     * without copying it a second time.
+     *
+     * @param rects the rectangles to read
+     * @return a list with a byte array for every rectangle, or an empty list if the node
+     * has no paintable pixels.
+     */
+    QList<QByteArray> pixelDataForRects(const QList<QRect> &rects) const;
+
+    /**
+     * @brief setPixelDataForRects writes several rectangles of pixels into the Node in one
+     * call. Each byte array must have the same layout as the one accepted by setPixelData().
+     *
+     * Like setPixelData(), the bytes are copied into the paint device.
+     *
+     * @param values the byte arrays with the pixel data, one for every rectangle
+     * @param rects the rectangles to write to
+     * @return true if all the rectangles were written. Nothing is written if the number of
+     * byte arrays and rectangles differs, or if any of the byte arrays is too short.
+     */
+    bool setPixelDataForRects(const QList<QByteArray> &values, const QList<QRect> &rects);
+
     /**
      * @brief bounds return the exact bounds of the node's paint device
      * @return the bounds, or an empty QRect if the node has no paint device or is empty.
@@ -110,6 +110,99 @@ void TestNode::testProjectionPixelData()
     }
 }
 
+void TestNode::testPixelDataForRects()
+{
+    KisImageSP image = new KisImage(0, 300, 200, KoColorSpaceRegistry::instance()->rgb8(), "test");
+    KisNodeSP layer = new KisPaintLayer(image, "test1", 255);
+    KisFillPainter gc(layer->paintDevice());
+    gc.fillRect(0, 0, 300, 200, KoColor(Qt::red, layer->colorSpace()));
+    NodeSP node = NodeSP(Node::createNode(image, layer));
+
+    const QList<QRect> rects = node->tileRects(10, 20, 280, 170, 100);
+
+    // the patch size is rounded up to 128, the grid starts at the origin
+    QCOMPARE(rects.size(), 6);
+    QCOMPARE(rects.first(), QRect(10, 20, 118, 108));
+    QCOMPARE(rects.last(), QRect(256, 128, 34, 62));
+
+    int area = 0;
+    Q_FOREACH (const QRect &rect, rects) {
+        QVERIFY(QRect(10, 20, 280, 170).contains(rect));
+        area += rect.width() * rect.height();
+    }
+    QCOMPARE(area, 280 * 170);
+
+    QList<QByteArray> data = node->pixelDataForRects(rects);
+    QCOMPARE(data.size(), rects.size());
+
+    for (int i = 0; i < rects.size(); i++) {
+        const QRect &rc = rects[i];
+        QCOMPARE(data[i], node->pixelData(rc.x(), rc.y(), rc.width(), rc.height()));
+
+        // turn red into blue
+        for (int j = 0; j < data[i].size(); j += 4) {
+            std::swap(data[i].data()[j], data[i].data()[j + 2]);
+        }
+    }
+
+    QVERIFY(!node->setPixelDataForRects(data.mid(1), rects));
+    QVERIFY(node->setPixelDataForRects(data, rects));
+
+    QColor pixel;
+    layer->paintDevice()->pixel(5, 5, &pixel);
+    QCOMPARE(pixel, QColor(Qt::red));
+    layer->paintDevice()->pixel(150, 100, &pixel);
+    QCOMPARE(pixel, QColor(Qt::blue));
+    layer->paintDevice()->pixel(289, 189, &pixel);
+    QCOMPARE(pixel, QColor(Qt::blue));
+}
+
+void TestNode::benchmarkPixelData_data()
+{
+    QTest::addColumn<int>("method");
+
+    QTest::newRow("pixelData-whole") << 0;
+    QTest::newRow("pixelData-patches") << 1;
+    QTest::newRow("pixelDataForRects") << 2;
+}
+
+void TestNode::benchmarkPixelData()
+{
+    QFETCH(int, method);
+
+    const QRect imageRect(0, 0, 2048, 2048);
+
+    KisImageSP image = new KisImage(0, imageRect.width(), imageRect.height(), KoColorSpaceRegistry::instance()->rgb8(), "test");
+    KisNodeSP layer = new KisPaintLayer(image, "test1", 255);
+    KisFillPainter gc(layer->paintDevice());
+    gc.fillRect(imageRect, KoColor(Qt::red, layer->colorSpace()));
+    NodeSP node = NodeSP(Node::createNode(image, layer));
+
+    const QList<QRect> rects = node->tileRects(imageRect.x(), imageRect.y(), imageRect.width(), imageRect.height());
+
+    // all the three methods copy the same number of bytes, pixelDataForRects()
+    // only saves the calls into Krita
+    int totalSize = 0;
+
+    QBENCHMARK {
+        totalSize = 0;
+
+        if (method == 0) {
+            totalSize += node->pixelData(imageRect.x(), imageRect.y(), imageRect.width(), imageRect.height()).size();
+        } else if (method == 1) {
+            Q_FOREACH (const QRect &rc, rects) {
+                totalSize += node->pixelData(rc.x(), rc.y(), rc.width(), rc.height()).size();
+            }
+        } else {
+            Q_FOREACH (const QByteArray &data, node->pixelDataForRects(rects)) {
+                totalSize += data.size();
+            }
+        }
+    }
+
+    QCOMPARE(totalSize, imageRect.width() * imageRect.height() * 4);
+}
+
 void TestNode::testThumbnail()
 {
     KisImageSP image = new KisImage(0, 100, 100, KoColorSpaceRegistry::instance()->rgb8(), "test");
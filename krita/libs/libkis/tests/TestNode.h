@@ -16,6 +16,9 @@ private Q_SLOTS:
     void testSetColorProfile();
     void testPixelData();
     void testProjectionPixelData();
+    void testPixelDataForRects();
+    void benchmarkPixelData_data();
+    void benchmarkPixelData();
     void testThumbnail();
     void testMergeDown();
     void testFindChildNodes();
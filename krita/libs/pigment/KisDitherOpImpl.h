@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <array>
 #include <type_traits>
 
 #include "DebugPigment.h"
@@ -142,12 +143,24 @@ private:
 
         float s = scale();
 
+        /**
+         * Both dither matrices are periodic, so the factors are computed
+         * once per row and then the pixels are processed with a simple
+         * table lookup, which the compiler can vectorize.
+         */
+        const int period = columns < factorPeriod ? columns : factorPeriod;
+        std::array<float, factorPeriod> rowFactors;
+
         for (int a = 0; a < rows; ++a) {
             const srcChannelsType *srcPtr = srcCSTraits::nativeArray(nativeSrc);
             dstChannelsType *dstPtr = dstCSTraits::nativeArray(nativeDst);
 
+            for (int b = 0; b < period; ++b) {
+                rowFactors[b] = factor(x + b, y + a);
+            }
+
             for (int b = 0; b < columns; ++b) {
-                float f = factor(x + b, y + a);
+                const float f = rowFactors[b & (factorPeriod - 1)];
 
                 for (uint channelIndex = 0; channelIndex < srcCSTraits::channels_nb; ++channelIndex) {
                     float c = KoColorSpaceMaths<srcChannelsType, float>::scaleToA(srcPtr[channelIndex]);
@@ -164,6 +177,12 @@ private:
         }
     }
 
+    /**
+     * The number of columns after which the dither pattern repeats. It
+     * is a multiple of the periods of all the supported matrices.
+     */
+    static constexpr int factorPeriod = 64;
+
     template<typename U = typename dstCSTraits::channels_type, typename std::enable_if<!std::numeric_limits<U>::is_integer, void>::type * = nullptr> constexpr float scale() const
     {
         return 0.f; // no dithering for floating point
@@ -60,6 +60,74 @@ QString changeToEmptyIfNull(QString s)
     return s.isNull() ? QString("") : s;
 }
 
+namespace {
+/**
+ * Fetch the ids of all the resources of \p resourceType registered for the
+ * storage with a single query, instead of asking the database for every
+ * file separately. The result maps the filename (with subfolders) to the
+ * resource id, following the same lookup rules as
+ * KisResourceCacheDb::resourceIdForResource(): the head `resources` table
+ * takes precedence over `versioned_resources`.
+ */
+QHash<QString, int> fetchResourceIdsForStorage(int storageId, const QString &resourceType)
+{
+    QHash<QString, int> result;
+
+    QSqlQuery q;
+    q.setForwardOnly(true);
+
+    if (!q.prepare("SELECT versioned_resources.filename\n"
+                   ",      versioned_resources.resource_id\n"
+                   "FROM   versioned_resources\n"
+                   ",      resources\n"
+                   ",      resource_types\n"
+                   "WHERE  versioned_resources.resource_id = resources.id\n"
+                   "AND    resources.resource_type_id = resource_types.id\n"
+                   "AND    resource_types.name = :resource_type\n"
+                   "AND    versioned_resources.storage_id = :storage_id\n")) {
+        qWarning() << "Could not prepare versioned resource ids query" << q.lastError();
+        return result;
+    }
+
+    q.bindValue(":resource_type", resourceType);
+    q.bindValue(":storage_id", storageId);
+
+    if (!q.exec()) {
+        qWarning() << "Could not exec versioned resource ids query" << q.boundValues() << q.lastError();
+        return result;
+    }
+
+    while (q.next()) {
+        result.insert(q.value(0).toString(), q.value(1).toInt());
+    }
+
+    if (!q.prepare("SELECT resources.filename\n"
+                   ",      resources.id\n"
+                   "FROM   resources\n"
+                   ",      resource_types\n"
+                   "WHERE  resources.resource_type_id = resource_types.id\n"
+                   "AND    resource_types.name = :resource_type\n"
+                   "AND    resources.storage_id = :storage_id\n")) {
+        qWarning() << "Could not prepare resource ids query" << q.lastError();
+        return result;
+    }
+
+    q.bindValue(":resource_type", resourceType);
+    q.bindValue(":storage_id", storageId);
+
+    if (!q.exec()) {
+        qWarning() << "Could not exec resource ids query" << q.boundValues() << q.lastError();
+        return result;
+    }
+
+    while (q.next()) {
+        result.insert(q.value(0).toString(), q.value(1).toInt());
+    }
+
+    return result;
+}
+}
+
 bool updateSchemaVersion()
 {
     QFile f(":/fill_version_information.sql");
@@ -933,8 +1001,6 @@ bool KisResourceCacheDb::getAllVersionsLocations(int resourceId, QStringList &ou
 
 bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime timestamp, KoResourceSP resource, const QString &resourceType)
 {
-    bool r = false;
-
     if (!s_valid) {
         qWarning() << "KisResourceCacheDb::addResource: The database is not valid";
         return false;
@@ -945,7 +1011,6 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
         // We don't care about invalid resources and will just ignore them.
         return true;
     }
-    bool temporary = (storage->type() == KisResourceStorage::StorageType::Memory);
 
     // Check whether it already exists
     int resourceId = resourceIdForResource(resource->filename(), resourceType, KisResourceLocator::instance()->makeStorageLocationRelative(storage->location()));
@@ -953,6 +1018,14 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
         return true;
     }
 
+    return addResourceImpl(storage, timestamp, resource, resourceType);
+}
+
+bool KisResourceCacheDb::addResourceImpl(KisResourceStorageSP storage, QDateTime timestamp, KoResourceSP resource, const QString &resourceType)
+{
+    bool r = false;
+    bool temporary = (storage->type() == KisResourceStorage::StorageType::Memory);
+
     QSqlQuery q;
     r = q.prepare("INSERT INTO resources \n"
                   "(storage_id, resource_type_id, name, filename, tooltip, thumbnail, status, temporary, md5sum) \n"
@@ -1023,7 +1096,10 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
         qWarning() << "Could not execute addResource statement" << q.lastError() << q.boundValues();
         return r;
     }
-    resourceId = resourceIdForResource(resource->filename(), resourceType, KisResourceLocator::instance()->makeStorageLocationRelative(storage->location()));
+
+    // the row has just been inserted, no need to look it up again
+    const QVariant insertedId = q.lastInsertId();
+    const int resourceId = insertedId.isValid() ? insertedId.toInt() : -1;
 
     if (resourceId < 0) {
 
@@ -1053,6 +1129,30 @@ bool KisResourceCacheDb::addResource(KisResourceStorageSP storage, QDateTime tim
 
 bool KisResourceCacheDb::addResources(KisResourceStorageSP storage, QString resourceType)
 {
+    if (!s_valid) {
+        qWarning() << "KisResourceCacheDb::addResources: The database is not valid";
+        return false;
+    }
+
+    // Check which of the resources already exist with a single query, instead
+    // of letting addResource() look every file up separately
+    QHash<QString, int> knownResourceIds;
+    {
+        QSqlQuery q;
+        if (!q.prepare("SELECT id FROM storages WHERE location = :location")) {
+            qWarning() << "Could not prepare storage id query" << q.lastError();
+            return false;
+        }
+        q.bindValue(":location", changeToEmptyIfNull(KisResourceLocator::instance()->makeStorageLocationRelative(storage->location())));
+        if (!q.exec()) {
+            qWarning() << "Could not execute storage id query" << q.lastError();
+            return false;
+        }
+        if (q.first()) {
+            knownResourceIds = fetchResourceIdsForStorage(q.value(0).toInt(), resourceType);
+        }
+    }
+
     QSqlDatabase::database().transaction();
     QSharedPointer<KisResourceStorage::ResourceIterator> iter = storage->resources(resourceType);
     while (iter->hasNext()) {
@@ -1072,8 +1172,13 @@ bool KisResourceCacheDb::addResources(KisResourceStorageSP storage, QString reso
                 resource->setMD5Sum(storage->resourceMd5(verIt->url()));
 
                 if (resourceId < 0) {
-                    if (addResource(storage, iter->lastModified(), resource, iter->type())) {
+                    if (knownResourceIds.contains(resource->filename())) {
+                        continue;
+                    }
+
+                    if (addResourceImpl(storage, iter->lastModified(), resource, iter->type())) {
                         resourceId = resource->resourceId();
+                        knownResourceIds.insert(resource->filename(), resourceId);
                     } else {
                         qWarning() << "Could not add resource" << resource->filename() << "to the database";
                     }
@@ -1654,8 +1759,6 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
     QElapsedTimer t;
     t.start();
 
-    QSqlDatabase::database().transaction();
-
     if (!s_valid) {
         qWarning() << "KisResourceCacheDb::addResource: The database is not valid";
         return false;
@@ -1690,6 +1793,10 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
 
     storage->setStorageId(q.value("id").toInt());
 
+    // all the inserts and removals below are done in a single transaction,
+    // otherwise SQLite would sync every statement to the disk separately
+    QSqlDatabase::database().transaction();
+
     /// We compare resource versions one-by-one because the storage may have multiple
     /// versions of them
 
@@ -1706,6 +1813,9 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
 
         int nextInexistentResourceId = std::numeric_limits<int>::min();
 
+        const QHash<QString, int> knownResourceIds =
+            fetchResourceIdsForStorage(storage->storageId(), resourceType);
+
         QSharedPointer<KisResourceStorage::ResourceIterator> iter = storage->resources(resourceType);
         while (iter->hasNext()) {
             iter->next();
@@ -1726,9 +1836,7 @@ bool KisResourceCacheDb::synchronizeStorage(KisResourceStorageSP storage)
                 QString path = QDir::fromNativeSeparators(verIt->url()); // make sure it uses Unix separators
                 int folderEndIdx = path.indexOf("/");
                 QString properFilenameWithSubfolders = path.right(path.length() - folderEndIdx - 1);
-                int id = resourceIdForResource(properFilenameWithSubfolders,
-                                               verIt->type(),
-                                               KisResourceLocator::instance()->makeStorageLocationRelative(storage->location()));
+                const int id = knownResourceIds.value(properFilenameWithSubfolders, -1);
 
                 ResourceVersion item;
                 item.url = verIt->url();
@@ -103,6 +103,8 @@ private:
 
 
     static bool addResource(KisResourceStorageSP storage, QDateTime timestamp, KoResourceSP resource, const QString &resourceType);
+    /// Same as addResource(), but doesn't check whether the resource is already in the database
+    static bool addResourceImpl(KisResourceStorageSP storage, QDateTime timestamp, KoResourceSP resource, const QString &resourceType);
     static bool addResources(KisResourceStorageSP storage, QString resourceType);
 
     /// Make this resource active or inactive; this does not remove the resource from disk or from the database
@@ -8,6 +8,7 @@
 
 #include <QPainter>
 #include <QVarLengthArray>
+#include <QtMath>
 #include <QApplication>
 #include <QMainWindow>
 #include <QWindow>
@@ -36,6 +37,7 @@
 #include "KisView.h"
 #include "kis_selection_mask.h"
 #include <KisPart.h>
+#include "krita_utils.h"
 
 static const unsigned int ANT_LENGTH = 4;
 static const unsigned int ANT_SPACE = 4;
@@ -156,6 +158,7 @@ void KisSelectionDecoration::selectionChanged()
 
             if (m_mode == Ants) {
                 m_outlinePath = selection->outlineCache();
+                m_simplifiedOutlinePath = QPainterPath();
                 m_antsTimer->start();
             } else {
                 m_thumbnailImage = selection->thumbnailImage();
@@ -171,6 +174,7 @@ void KisSelectionDecoration::selectionChanged()
     } else {
         m_signalCompressor.stop();
         m_outlinePath = QPainterPath();
+        m_simplifiedOutlinePath = QPainterPath();
         m_thumbnailImage = QImage();
         m_thumbnailImageTransform = QTransform();
         view()->canvasBase()->updateCanvas();
@@ -250,17 +254,43 @@ void KisSelectionDecoration::drawDecoration(QPainter& gc, const QRectF& updateRe
     } else /* if (m_mode == Ants) */ {
         gc.setRenderHints(QPainter::Antialiasing | QPainter::HighQualityAntialiasing, m_antialiasSelectionOutline);
 
+        const qreal scale = qSqrt(qAbs(transform.determinant()));
+        const QPainterPath &outlinePath = outlinePathForScale(scale);
+
         // render selection outline in white
         gc.setPen(m_outlinePen);
-        gc.drawPath(m_outlinePath);
+        gc.drawPath(outlinePath);
 
         // render marching ants in black (above the white outline)
         gc.setPen(m_antsPen);
-        gc.drawPath(m_outlinePath);
+        gc.drawPath(outlinePath);
     }
     gc.restore();
 }
 
+const QPainterPath& KisSelectionDecoration::outlinePathForScale(qreal scale)
+{
+    /**
+     * When the canvas is zoomed out, a lot of outline vertices fall into
+     * the same screen pixel, so we can draw a simplified version of the
+     * outline instead. It is recalculated only when the zoom changes.
+     */
+    if (scale >= 1.0 || scale <= 0.0) {
+        return m_outlinePath;
+    }
+
+    const qreal threshold = 1.0 / scale;
+
+    if (m_simplifiedOutlinePath.isEmpty() ||
+        !qFuzzyCompare(threshold, m_simplifiedOutlineThreshold)) {
+
+        m_simplifiedOutlinePath = KritaUtils::trySimplifyPath(m_outlinePath, threshold);
+        m_simplifiedOutlineThreshold = threshold;
+    }
+
+    return m_simplifiedOutlinePath;
+}
+
 void KisSelectionDecoration::setVisible(bool v)
 {
     KisCanvasDecoration::setVisible(v);
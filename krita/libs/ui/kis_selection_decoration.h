@@ -51,11 +51,14 @@ public Q_SLOTS:
     void antsAttackEvent();
 private:
     bool selectionIsActive();
+    const QPainterPath& outlinePathForScale(qreal scale);
 
 private:
 
     KisSignalCompressor m_signalCompressor;
     QPainterPath m_outlinePath;
+    QPainterPath m_simplifiedOutlinePath;
+    qreal m_simplifiedOutlineThreshold {0.0};
     QImage m_thumbnailImage;
     QTransform m_thumbnailImageTransform;
     QTimer* m_antsTimer;
@@ -39,9 +39,13 @@ struct HistogramComputationStrokeStrategy::Private {
 };
 
 
-HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageWSP image)
+HistogramComputationStrokeStrategy::HistogramComputationStrokeStrategy(KisImageWSP image,
+                                                                       const QVector<KisPatchHistogramCache::PatchJob> &patches,
+                                                                       int sampleStep)
     : KisSimpleStrokeStrategy(QLatin1String("ComputeHistogram")),
-      m_image(image)
+      m_image(image),
+      m_patches(patches),
+      m_sampleStep(sampleStep)
 {
     enableJob(KisSimpleStrokeStrategy::JOB_INIT, true, KisStrokeJobData::BARRIER, KisStrokeJobData::EXCLUSIVE);
     enableJob(KisSimpleStrokeStrategy::JOB_DOSTROKE);
@@ -61,12 +65,9 @@ HistogramComputationStrokeStrategy::~HistogramComputationStrokeStrategy()
 void HistogramComputationStrokeStrategy::initStrokeCallback()
 {
     QVector<KisStrokeJobData*> jobsData;
-    int i = 0;
-    QVector<QRect> tileRects = KritaUtils::splitRectIntoPatches(m_image->bounds(), KritaUtils::optimalPatchSize());
-    m_results.resize(tileRects.size());
-    Q_FOREACH (const QRect &tileRectangle, tileRects) {
-        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(tileRectangle, i);
-        i++;
+    m_results.resize(m_patches.size());
+    for (int i = 0; i < m_patches.size(); i++) {
+        jobsData << new HistogramComputationStrokeStrategy::Private::ProcessData(m_patches[i].rect, i);
     }
     addMutatedJobs(jobsData);
 }
@@ -75,42 +76,9 @@ void HistogramComputationStrokeStrategy::doStrokeCallback(KisStrokeJobData *data
 {
     Private::ProcessData *d_pd = dynamic_cast<Private::ProcessData*>(data);
     KIS_SAFE_ASSERT_RECOVER_RETURN(d_pd);
-    QRect calculate = d_pd->rectToCalculate;
 
-    KisPaintDeviceSP m_dev = m_image->projection();
-    QRect imageBounds = m_image->bounds();
-
-    const KoColorSpace *cs = m_dev->colorSpace();
-    quint32 channelCount = m_dev->channelCount();
-    quint32 pixelSize = m_dev->pixelSize();
-
-    quint32 imageSize = imageBounds.width() * imageBounds.height();
-    quint32 nSkip = 1 + (imageSize >> 20); //for speed use about 1M pixels for computing histograms
-
-    if (calculate.isEmpty())
-        return;
-
-    initiateVector(m_results[d_pd->jobId], cs);
-
-    quint32 toSkip = nSkip;
-
-    KisSequentialConstIterator it(m_dev, calculate);
-
-    int numConseqPixels = it.nConseqPixels();
-    while (it.nextPixels(numConseqPixels)) {
-
-        numConseqPixels = it.nConseqPixels();
-        const quint8* pixel = it.rawDataConst();
-        for (int k = 0; k < numConseqPixels; ++k) {
-            if (--toSkip == 0) {
-                for (int chan = 0; chan < (int)channelCount; ++chan) {
-                    m_results[d_pd->jobId][chan][cs->scaleToU8(pixel, chan)]++;
-                }
-                toSkip = nSkip;
-            }
-            pixel += pixelSize;
-        }
-    }
+    m_results[d_pd->jobId] =
+        KisPatchHistogramCache::calculatePatch(m_image->projection(), d_pd->rectToCalculate, m_sampleStep);
 }
 
 void HistogramComputationStrokeStrategy::finishStrokeCallback()
@@ -121,45 +89,16 @@ void HistogramComputationStrokeStrategy::finishStrokeCallback()
 
     HistogramData hisData;
     hisData.colorSpace = m_image->projection()->colorSpace();
+    hisData.patches = m_patches;
+    hisData.patchBins = std::move(m_results);
 
-    if (m_results.size() == 1) {
-        hisData.bins = m_results[0];
-        emit computationResultReady(hisData);
-    } else {
-
-        quint32 channelCount = m_image->projection()->channelCount();
-
-        initiateVector(hisData.bins, hisData.colorSpace);
-
-        for (int chan = 0; chan < (int)channelCount; chan++) {
-            int bsize = hisData.bins[chan].size();
-
-            for (int bi = 0; bi < bsize; bi++) {
-                hisData.bins[chan][bi] = 0;
-                for (int i = 0; i < (int)m_results.size(); i++) {
-                    hisData.bins[chan][bi] += m_results[i][chan][bi];
-                }
-            }
-        }
-
-        emit computationResultReady(hisData);
-    }
-
+    emit computationResultReady(hisData);
 }
 
 void HistogramComputationStrokeStrategy::cancelStrokeCallback()
 {
 }
 
-void HistogramComputationStrokeStrategy::initiateVector(HistVector &vec, const KoColorSpace *colorSpace)
-{
-    int channelCount = colorSpace->channelCount();
-    vec.resize((int)channelCount);
-    for (auto &bin : vec) {
-        bin.resize(std::numeric_limits<quint8>::max() + 1);
-    }
-}
-
 
 
 HistogramDockerWidget::HistogramDockerWidget(QWidget *parent, const char *name, Qt::WindowFlags f)
@@ -184,12 +123,19 @@ void HistogramDockerWidget::updateHistogram(KisCanvas2* canvas)
         // remember to save the color space to paint the histogram data!
         m_colorSpace = paintDevice->colorSpace();
 
-        KisPaintDeviceSP m_devClone = new KisPaintDevice(paintDevice->colorSpace());
+        m_patchCache.resetIfIncompatible(paintDevice, bounds);
 
-        m_devClone->makeCloneFrom(paintDevice, bounds);
+        const QVector<KisPatchHistogramCache::PatchJob> dirtyPatches = m_patchCache.dirtyPatches();
+
+        if (dirtyPatches.isEmpty() && !m_histogramData.empty()) {
+            // nothing has changed since the last calculation
+            return;
+        }
 
         HistogramComputationStrokeStrategy* stroke;
-        stroke = new HistogramComputationStrokeStrategy(canvas->image());
+        stroke = new HistogramComputationStrokeStrategy(canvas->image(),
+                                                        dirtyPatches,
+                                                        m_patchCache.sampleStep());
 
         connect(stroke, SIGNAL(computationResultReady(HistogramData)), this, SLOT(receiveNewHistogram(HistogramData)));
 
@@ -211,11 +157,29 @@ void HistogramDockerWidget::receiveNewHistogram(HistVector* data)
 
 void HistogramDockerWidget::receiveNewHistogram(HistogramData data)
 {
-    m_histogramData = data.bins;
+    // the results calculated for an outdated projection are dropped
+    if (data.colorSpace != m_patchCache.colorSpace()) return;
+
+    for (int i = 0; i < data.patches.size(); i++) {
+        m_patchCache.setPatchResult(data.patches[i], std::move(data.patchBins[i]));
+    }
+
+    m_histogramData = m_patchCache.mergedBins();
     m_colorSpace = data.colorSpace;
+
     update();
 }
 
+void HistogramDockerWidget::invalidateRect(const QRect &rect)
+{
+    m_patchCache.invalidateRect(rect);
+}
+
+void HistogramDockerWidget::invalidateAll()
+{
+    m_patchCache.invalidateAll();
+}
+
 void HistogramDockerWidget::paintEvent(QPaintEvent *event)
 {
     if (m_colorSpace && !m_histogramData.empty()) {
@@ -15,20 +15,24 @@
 #include "kis_types.h"
 #include <vector>
 #include <kis_simple_stroke_strategy.h>
+#include <KisPatchHistogramCache.h>
 
 class KisCanvas2;
 class KoColorSpace;
 
 
-using HistVector = std::vector<std::vector<quint32> >; //Don't use QVector here - it's too slow for this purpose
+using HistVector = KisPatchHistogramCache::Bins; //Don't use QVector here - it's too slow for this purpose
 
 struct HistogramData
 {
     HistogramData() {}
     ~HistogramData() {}
 
-    HistVector bins;
     const KoColorSpace* colorSpace {0};
+
+    /// the recalculated patches and their partial histograms
+    QVector<KisPatchHistogramCache::PatchJob> patches;
+    std::vector<HistVector> patchBins;
 };
 Q_DECLARE_METATYPE(HistogramData)
 
@@ -37,7 +41,13 @@ class HistogramComputationStrokeStrategy : public QObject, public KisSimpleStrok
 {
     Q_OBJECT
 public:
-    HistogramComputationStrokeStrategy(KisImageWSP image);
+    /**
+     * Recalculates the partial histograms of \p patches, they are merged
+     * with the cached ones by the receiver of computationResultReady()
+     */
+    HistogramComputationStrokeStrategy(KisImageWSP image,
+                                       const QVector<KisPatchHistogramCache::PatchJob> &patches,
+                                       int sampleStep);
     ~HistogramComputationStrokeStrategy() override;
 
 
@@ -47,8 +57,6 @@ private:
     void finishStrokeCallback() override;
     void cancelStrokeCallback() override;
 
-    void initiateVector(HistVector &vec, const KoColorSpace* colorSpace);
-
 Q_SIGNALS:
     //Emitted when thumbnail is updated and overviewImage is fully generated.
     void computationResultReady(HistogramData data);
@@ -58,6 +66,8 @@ private:
     struct Private;
     const QScopedPointer<Private> m_d;
     KisImageSP m_image;
+    QVector<KisPatchHistogramCache::PatchJob> m_patches;
+    int m_sampleStep;
     std::vector<HistVector> m_results;
 };
 
@@ -84,11 +94,23 @@ public Q_SLOTS:
     void receiveNewHistogram(HistVector*);
     void receiveNewHistogram(HistogramData data);
 
+    /**
+     * Marks the patches intersecting \p rect as outdated, so that they
+     * are recalculated on the next call to updateHistogram()
+     */
+    void invalidateRect(const QRect &rect);
+    void invalidateAll();
 
 private:
     HistVector m_histogramData;
     const KoColorSpace* m_colorSpace {0};
     bool m_smoothHistogram {false};
+
+    /**
+     * After a small stroke only the patches of the histogram that
+     * intersect the updated rects are rescanned
+     */
+    KisPatchHistogramCache m_patchCache;
 };
 
 #endif // HISTOGRAMDOCKERWIDGET_H
@@ -8,6 +8,8 @@
 
 #include <qmath.h>
 
+#include <limits>
+
 #include <KoColorSpaceMaths.h>
 #include <KoColorSpaceRegistry.h>
 #include <filter/kis_filter_configuration.h>
@@ -39,15 +41,28 @@ int IndexColorPalette::numColors() const
 
 LabColor IndexColorPalette::getNearestIndex(LabColor clr) const
 {
-    QVector<float> diffs;
-    diffs.resize(numColors());
-    for(int i = 0; i < numColors(); ++i)
-        diffs[i] = similarity(colors[i], clr);
+    // the most similar color is the one with the smallest weighted distance,
+    // so there is no need to take the square root for every palette entry
+    static const float max = KoColorSpaceMathsTraits<quint16>::max;
+    const float factorL = similarityFactors.L / max;
+    const float factora = similarityFactors.a / max;
+    const float factorb = similarityFactors.b / max;
 
     int primaryColor = 0;
+    float minDistance = std::numeric_limits<float>::max();
     for(int i = 0; i < numColors(); ++i)
-        if(diffs[i] > diffs[primaryColor])
+    {
+        const LabColor &c = colors[i];
+        const float valL = qAbs(c.L - clr.L) * factorL;
+        const float valA = qAbs(c.a - clr.a) * factora;
+        const float valB = qAbs(c.b - clr.b) * factorb;
+        const float distance = valL * valL + valA * valA + valB * valB;
+        if(distance < minDistance)
+        {
+            minDistance = distance;
             primaryColor = i;
+        }
+    }
 
     return colors[primaryColor];
 }
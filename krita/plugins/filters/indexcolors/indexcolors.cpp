@@ -106,24 +106,44 @@ KisIndexColorTransformation::KisIndexColorTransformation(IndexColorPalette palet
 
 void KisIndexColorTransformation::transform(const quint8* src, quint8* dst, qint32 nPixels) const
 {
-    union
-    {
-        quint16 laba[4];
-        LabColor lab;
-    } clr;
-    while (nPixels--)
+    // the palette has a few colors only, so the search result is remembered
+    // for every color met, but the cache must not grow on noisy images
+    static const int maxCachedColors = 1 << 16;
+
+    m_labBuffer.resize(nPixels * 4);
+    quint16 *laba = m_labBuffer.data();
+
+    m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(laba), nPixels);
+
+    for (qint32 i = 0; i < nPixels; ++i, laba += 4)
     {
-        m_colorSpace->toLabA16(src, reinterpret_cast<quint8 *>(clr.laba), 1);
-        clr.lab = m_palette.getNearestIndex(clr.lab);
+        const quint64 key = quint64(laba[0]) << 32 | quint64(laba[1]) << 16 | quint64(laba[2]);
+
+        auto it = m_nearestColors.find(key);
+        if(it == m_nearestColors.end())
+        {
+            if(m_nearestColors.size() >= maxCachedColors)
+                m_nearestColors.clear();
+
+            LabColor clr;
+            clr.L = laba[0];
+            clr.a = laba[1];
+            clr.b = laba[2];
+            it = m_nearestColors.insert(key, m_palette.getNearestIndex(clr));
+        }
+
+        laba[0] = it->L;
+        laba[1] = it->a;
+        laba[2] = it->b;
+
         if(m_alphaStep)
         {
-            quint16 amod = clr.laba[3] % m_alphaStep;
-            clr.laba[3] = clr.laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
+            quint16 amod = laba[3] % m_alphaStep;
+            laba[3] = laba[3] + (amod > m_alphaHalfStep ? m_alphaStep - amod : -amod);
         }
-        m_colorSpace->fromLabA16(reinterpret_cast<quint8 *>(clr.laba), dst, 1);
-        src += m_psize;
-        dst += m_psize;
     }
+
+    m_colorSpace->fromLabA16(reinterpret_cast<const quint8 *>(m_labBuffer.constData()), dst, nPixels);
 }
 
 #include "indexcolors.moc"
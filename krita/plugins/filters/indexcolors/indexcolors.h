@@ -7,8 +7,10 @@
 #ifndef INDEXCOLORS_H
 #define INDEXCOLORS_H
 
+#include <QHash>
 #include <QObject>
 #include <QVariant>
+#include <QVector>
 #include "filter/kis_color_transformation_filter.h"
 #include "kis_config_widget.h"
 #include <KoColor.h>
@@ -48,6 +50,10 @@ private:
     IndexColorPalette m_palette;
     quint16 m_alphaStep;
     quint16 m_alphaHalfStep;
+
+    // every thread gets its own transformation, so the caches need no locking
+    mutable QVector<quint16> m_labBuffer;
+    mutable QHash<quint64, LabColor> m_nearestColors;
 };
 
 #endif
@@ -8,6 +8,9 @@
 
 #include "palettize.h"
 
+#include <QMutex>
+#include <QtConcurrent>
+
 #include <kis_types.h>
 #include <kpluginfactory.h>
 #include <kis_config_widget.h>
@@ -15,7 +18,8 @@
 #include <kis_filter_configuration.h>
 #include <kis_filter_category_ids.h>
 #include <KoUpdater.h>
-#include <KisSequentialIteratorProgress.h>
+#include <kis_sequential_iterator.h>
+#include <krita_utils.h>
 #include <KisResourceItemChooser.h>
 #include <KoColorSet.h>
 #include <KoPattern.h>
@@ -278,70 +282,137 @@ void KisFilterPalettize::processImpl(KisPaintDeviceSP device, const QRect& apply
         KisDitherUtil alphaDitherUtil;
         if (alphaMode == AlphaMode::Dither) alphaDitherUtil.setConfiguration(*config, "alphaDither/");
 
-        KisSequentialIteratorProgress pixel(device, applyRect, progressUpdater);
-        while (pixel.nextPixel()) {
-            KoColor workColor(pixel.oldRawData(), colorspace);
-            workColor.convertTo(workColorspace);
-
-            // Find dither threshold
-            double threshold = 0.5;
-            if (ditherEnabled) {
-                threshold = ditherUtil.threshold(QPoint(pixel.x(), pixel.y()));
-
-                // Traditional per-channel ordered dithering
-                if (colorMode == ColorMode::PerChannelOffset) {
-                    QVector<float> normalized(int(workColorspace->channelCount()));
-                    workColorspace->normalisedChannelsValue(workColor.data(), normalized);
-                    for (int channel = 0; channel < int(workColorspace->channelCount()); ++channel) {
-                        normalized[channel] += (threshold - 0.5) * offsetScale;
+        struct NearestColors {
+            int count = 0;
+            const ColorCandidate *candidates[2];
+            double distances[2];
+        };
+
+        const quint32 pixelSize = colorspace->pixelSize();
+        const quint32 workPixelSize = workColorspace->pixelSize();
+        const int workChannelCount = int(workColorspace->channelCount());
+
+        /**
+         * The area is processed in tile-aligned patches in parallel. The
+         * search tree is only read, so it is shared by all the patches.
+         * Every patch converts the pixels into the search colorspace in
+         * runs and remembers the nearest palette colors of the colors it
+         * has already seen, since most images contain many pixels of the
+         * same color.
+         */
+        QVector<QRect> patches = KritaUtils::splitRectIntoPatches(applyRect, KritaUtils::optimalPatchSize());
+
+        QMutex progressMutex;
+        int patchesDone = 0;
+
+        if (progressUpdater) {
+            progressUpdater->setRange(0, patches.size());
+            progressUpdater->setValue(0);
+        }
+
+        QtConcurrent::blockingMap(patches, [&] (const QRect &patch) {
+            QHash<quint64, NearestColors> nearestColorsCache;
+            QVector<quint8> workPixels;
+            QVector<float> normalized(workChannelCount);
+
+            KisSequentialIterator pixel(device, patch);
+
+            int nConseqPixels = pixel.nConseqPixels();
+            while (pixel.nextPixels(nConseqPixels)) {
+                nConseqPixels = pixel.nConseqPixels();
+
+                const quint8 *srcPtr = pixel.oldRawData();
+                quint8 *dstPtr = pixel.rawData();
+
+                workPixels.resize(nConseqPixels * workPixelSize);
+                colorspace->convertPixelsTo(srcPtr, workPixels.data(), workColorspace, nConseqPixels,
+                                            KoColorConversionTransformation::internalRenderingIntent(),
+                                            KoColorConversionTransformation::internalConversionFlags());
+
+                quint8 *workColor = workPixels.data();
+
+                for (int i = 0; i < nConseqPixels; i++) {
+                    const QPoint pos(pixel.x() + i, pixel.y());
+
+                    // Find dither threshold
+                    double threshold = 0.5;
+                    if (ditherEnabled) {
+                        threshold = ditherUtil.threshold(pos);
+
+                        // Traditional per-channel ordered dithering
+                        if (colorMode == ColorMode::PerChannelOffset) {
+                            workColorspace->normalisedChannelsValue(workColor, normalized);
+                            for (int channel = 0; channel < workChannelCount; ++channel) {
+                                normalized[channel] += (threshold - 0.5) * offsetScale;
+                            }
+                            workColorspace->fromNormalisedChannelsValue(workColor, normalized);
+                        }
                     }
-                    workColorspace->fromNormalisedChannelsValue(workColor.data(), normalized);
-                }
-            }
 
-            // Get candidate colors and their distances
-            SearchColor searchColor;
-            memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor.data(), sizeof(SearchColor));
-            std::vector<ColorCandidate> candidateColors;
-            candidateColors.reserve(size_t(colorCount));
-            double distanceSum = 0.0;
-            for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && candidateColors.size() < colorCount; ++it) {
-                ColorCandidate candidate = it->second;
-                candidate.distance = boost::geometry::distance(searchColor, it->first);
-                candidateColors.push_back(candidate);
-                distanceSum += candidate.distance;
-            }
+                    // Get candidate colors and their distances
+                    SearchColor searchColor;
+                    memcpy(reinterpret_cast<quint8 *>(&searchColor), workColor, sizeof(SearchColor));
+
+                    const quint64 searchKey =
+                        quint64(searchColor.get<0>()) << 32 |
+                        quint64(searchColor.get<1>()) << 16 |
+                        quint64(searchColor.get<2>());
+
+                    auto cachedColors = nearestColorsCache.find(searchKey);
+                    if (cachedColors == nearestColorsCache.end()) {
+                        NearestColors nearest;
+                        for (auto it = rtree.qbegin(boost::geometry::index::nearest(searchColor, colorCount)); it != rtree.qend() && nearest.count < colorCount; ++it) {
+                            nearest.candidates[nearest.count] = &it->second;
+                            nearest.distances[nearest.count] = boost::geometry::distance(searchColor, it->first);
+                            nearest.count++;
+                        }
+                        cachedColors = nearestColorsCache.insert(searchKey, nearest);
+                    }
 
-            // Select color candidate
-            quint16 selected;
-            if (ditherEnabled && colorMode == ColorMode::NearestColors) {
-                // Sort candidates by palette order for stable dither color ordering
-                const bool swap = candidateColors[0].index > candidateColors[1].index;
-                selected = swap ^ (candidateColors[swap].distance / distanceSum > threshold);
-            }
-            else {
-                selected = 0;
-            }
-            ColorCandidate &candidate = candidateColors[selected];
-
-            // Set alpha
-            const double oldAlpha = colorspace->opacityF(pixel.oldRawData());
-            double newAlpha = oldAlpha;
-            if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
-                if (alphaMode == AlphaMode::Clip) {
-                    newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
-                }
-                else if (alphaMode == AlphaMode::Index) {
-                    newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
-                }
-                else if (alphaMode == AlphaMode::Dither) {
-                    newAlpha = oldAlpha < alphaDitherUtil.threshold(QPoint(pixel.x(), pixel.y())) ? 0.0 : 1.0;
+                    const NearestColors &nearest = cachedColors.value();
+
+                    // Select color candidate
+                    quint16 selected;
+                    if (ditherEnabled && colorMode == ColorMode::NearestColors && nearest.count == 2) {
+                        // Sort candidates by palette order for stable dither color ordering
+                        const double distanceSum = nearest.distances[0] + nearest.distances[1];
+                        const bool swap = nearest.candidates[0]->index > nearest.candidates[1]->index;
+                        selected = swap ^ (nearest.distances[swap] / distanceSum > threshold);
+                    }
+                    else {
+                        selected = 0;
+                    }
+                    const ColorCandidate &candidate = *nearest.candidates[selected];
+
+                    // Set alpha
+                    const double oldAlpha = colorspace->opacityF(srcPtr);
+                    double newAlpha = oldAlpha;
+                    if (alphaEnabled && !(!ditherEnabled && alphaMode == AlphaMode::Dither)) {
+                        if (alphaMode == AlphaMode::Clip) {
+                            newAlpha = oldAlpha < alphaClip? 0.0 : 1.0;
+                        }
+                        else if (alphaMode == AlphaMode::Index) {
+                            newAlpha = (candidate.index == alphaIndex ? 0.0 : 1.0);
+                        }
+                        else if (alphaMode == AlphaMode::Dither) {
+                            newAlpha = oldAlpha < alphaDitherUtil.threshold(pos) ? 0.0 : 1.0;
+                        }
+                    }
+
+                    // Copy color to pixel
+                    memcpy(dstPtr, candidate.color.data(), pixelSize);
+                    colorspace->setOpacity(dstPtr, newAlpha, 1);
+
+                    srcPtr += pixelSize;
+                    dstPtr += pixelSize;
+                    workColor += workPixelSize;
                 }
             }
-            colorspace->setOpacity(candidate.color.data(), newAlpha, 1);
 
-            // Copy color to pixel
-            memcpy(pixel.rawData(), candidate.color.data(), colorspace->pixelSize());
-        }
+            if (progressUpdater) {
+                QMutexLocker l(&progressMutex);
+                progressUpdater->setValue(++patchesDone);
+            }
+        });
     }
 }
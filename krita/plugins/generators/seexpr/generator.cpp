@@ -127,21 +127,40 @@ void KisSeExprGenerator::generate(KisProcessingInformation dstInfo, const QSize
             const KoColorSpace *src = KoColorSpaceRegistry::instance()->colorSpace(RGBAColorModelID.id(), Float32BitsColorDepthID.id(), KoColorSpaceRegistry::instance()->p709SRGBProfile());
             auto conv = KoColorSpaceRegistry::instance()->createColorConverter(src, dst, KoColorConversionTransformation::internalRenderingIntent(), KoColorConversionTransformation::internalConversionFlags());
 
+            /**
+             * Evaluate the whole run of consequent pixels into a buffer
+             * and convert it in one go. Creating a KoColor and calling
+             * the color converter for every single pixel used to take
+             * more time than the evaluation of simple scripts itself.
+             */
+            QVector<float> buffer;
+
             KisSequentialIteratorProgress it(device, bounds, progressUpdater);
 
-            while (it.nextPixel()) {
-                u = pixel_stride_x * (it.x() + .5);
+            int numConseqPixels = it.nConseqPixels();
+            while (it.nextPixels(numConseqPixels)) {
+                numConseqPixels = it.nConseqPixels();
+
+                if (buffer.size() < numConseqPixels * 4) {
+                    buffer.resize(numConseqPixels * 4);
+                }
+
+                float *dstPtr = buffer.data();
                 v = pixel_stride_y * (it.y() + .5);
 
-                const double *value = expression.evalFP();
+                for (int i = 0; i < numConseqPixels; i++) {
+                    u = pixel_stride_x * (it.x() + i + .5);
+
+                    const double *value = expression.evalFP();
 
-                KoColor c(src);
-                reinterpret_cast<float *>(c.data())[0] = value[0];
-                reinterpret_cast<float *>(c.data())[1] = value[1];
-                reinterpret_cast<float *>(c.data())[2] = value[2];
-                c.setOpacity(OPACITY_OPAQUE_F);
+                    dstPtr[0] = value[0];
+                    dstPtr[1] = value[1];
+                    dstPtr[2] = value[2];
+                    dstPtr[3] = OPACITY_OPAQUE_F;
+                    dstPtr += 4;
+                }
 
-                conv->transform(c.data(), it.rawData(), 1);
+                conv->transform(reinterpret_cast<const quint8 *>(buffer.constData()), it.rawData(), numConseqPixels);
             }
             delete conv;
         }
@@ -19,6 +19,38 @@
 
 namespace KisColorSmudgeSampleUtils {
 
+/**
+ * The sampled pixels are scattered over the sample rect, so we gather them
+ * into a small contiguous buffer and pass them to the mixer in batches. It
+ * lets us avoid calling the virtual mixer methods per every pixel.
+ *
+ * The mixer just sums up the passed values, so the result of the batched
+ * accumulation is exactly the same as the per-pixel one.
+ */
+struct BatchedSampleBuffer
+{
+    static const int BatchSize = 64;
+
+    BatchedSampleBuffer(int pixelSize)
+        : m_pixelSize(pixelSize),
+          m_pixels(BatchSize * pixelSize)
+    {
+    }
+
+    inline bool isFull() const {
+        return m_numPixels >= BatchSize;
+    }
+
+    inline void addPixel(const quint8 *ptr) {
+        memcpy(m_pixels.data() + m_numPixels * m_pixelSize, ptr, m_pixelSize);
+        m_numPixels++;
+    }
+
+    const int m_pixelSize;
+    QVector<quint8> m_pixels;
+    int m_numPixels = 0;
+};
+
 struct WeightedSampleWrapper
 {
     WeightedSampleWrapper(KoMixColorsOp::Mixer *mixer,
@@ -31,7 +63,8 @@ struct WeightedSampleWrapper
               m_samplePixelSize(sampleDab->colorSpace()->pixelSize()),
               m_sampleRect(sampleRect),
               m_samplePtr(sampleDab->data()),
-              m_sampleStride(sampleDab->bounds().width() * m_samplePixelSize)
+              m_sampleStride(sampleDab->bounds().width() * m_samplePixelSize),
+              m_batch(m_samplePixelSize)
     {
 
     }
@@ -42,7 +75,21 @@ struct WeightedSampleWrapper
         const qint16 opacity = *(m_maskPtr + maskPt.x() + maskPt.y() * m_maskStride);
         const quint8 *ptr = m_samplePtr + relativeSamplePoint.x() * m_samplePixelSize + relativeSamplePoint.y() * m_sampleStride;
 
-        m_mixer->accumulate(ptr, &opacity, opacity, 1);
+        m_weights[m_batch.m_numPixels] = opacity;
+        m_weightsSum += opacity;
+        m_batch.addPixel(ptr);
+
+        if (m_batch.isFull()) {
+            flush();
+        }
+    }
+
+    inline void flush() {
+        if (!m_batch.m_numPixels) return;
+
+        m_mixer->accumulate(m_batch.m_pixels.constData(), m_weights, m_weightsSum, m_batch.m_numPixels);
+        m_batch.m_numPixels = 0;
+        m_weightsSum = 0;
     }
 
     static void verifySampleRadiusValue(qreal *sampleRadiusValue) {
@@ -68,6 +115,9 @@ struct WeightedSampleWrapper
     const QRect m_sampleRect;
     quint8 *m_samplePtr;
     const int m_sampleStride;
+    BatchedSampleBuffer m_batch;
+    qint16 m_weights[BatchedSampleBuffer::BatchSize];
+    int m_weightsSum = 0;
 };
 
 struct AveragedSampleWrapper
@@ -79,7 +129,8 @@ struct AveragedSampleWrapper
               m_samplePixelSize(sampleDab->colorSpace()->pixelSize()),
               m_sampleRect(sampleRect),
               m_samplePtr(sampleDab->data()),
-              m_sampleStride(sampleDab->bounds().width() * m_samplePixelSize)
+              m_sampleStride(sampleDab->bounds().width() * m_samplePixelSize),
+              m_batch(m_samplePixelSize)
     {
         Q_UNUSED(maskDab);
         Q_UNUSED(maskRect);
@@ -87,7 +138,18 @@ struct AveragedSampleWrapper
 
     inline void samplePixel(const QPoint &relativeSamplePoint) {
         const quint8 *ptr = m_samplePtr + relativeSamplePoint.x() * m_samplePixelSize + relativeSamplePoint.y() * m_sampleStride;
-        m_mixer->accumulateAverage(ptr, 1);
+        m_batch.addPixel(ptr);
+
+        if (m_batch.isFull()) {
+            flush();
+        }
+    }
+
+    inline void flush() {
+        if (!m_batch.m_numPixels) return;
+
+        m_mixer->accumulateAverage(m_batch.m_pixels.constData(), m_batch.m_numPixels);
+        m_batch.m_numPixels = 0;
     }
 
     static void verifySampleRadiusValue(qreal *sampleRadiusValue) {
@@ -103,6 +165,7 @@ struct AveragedSampleWrapper
     const QRect m_sampleRect;
     quint8 *m_samplePtr;
     const int m_sampleStride;
+    BatchedSampleBuffer m_batch;
 };
 
 /**
@@ -181,6 +244,7 @@ void sampleColor(const QRect &srcRect,
             weightingModeWrapper.samplePixel(pt);
         }
 
+        weightingModeWrapper.flush();
         mixer->computeMixedColor(resultColor->data());
         lastPickedColor = *resultColor;
 
@@ -196,6 +260,7 @@ void sampleColor(const QRect &srcRect,
                 weightingModeWrapper.samplePixel(pt);
             }
 
+            weightingModeWrapper.flush();
             mixer->computeMixedColor(resultColor->data());
 
             const quint8 difference =
@@ -270,13 +270,16 @@ void KisColorSmudgeStrategyBase::blendInBackgroundWithSmearing(KisFixedPaintDevi
     } else {
         src->readBytes(dst->data(), dstRect);
 
-        KisFixedPaintDevice tempDevice(src->colorSpace(), m_memoryAllocator);
-        tempDevice.setRect(srcRect);
-        tempDevice.lazyGrowBufferWithoutInitialization();
+        if (!m_smearingTempDevice || m_smearingTempDevice->colorSpace() != src->colorSpace()) {
+            m_smearingTempDevice = new KisFixedPaintDevice(src->colorSpace(), m_memoryAllocator);
+        }
+
+        m_smearingTempDevice->setRect(srcRect);
+        m_smearingTempDevice->lazyGrowBufferWithoutInitialization();
 
-        src->readBytes(tempDevice.data(), srcRect);
+        src->readBytes(m_smearingTempDevice->data(), srcRect);
         m_smearOp->composite(dst->data(), dstRect.width() * dst->pixelSize(),
-                             tempDevice.data(), dstRect.width() * tempDevice.pixelSize(), // stride should be random non-zero
+                             m_smearingTempDevice->data(), dstRect.width() * m_smearingTempDevice->pixelSize(), // stride should be random non-zero
                              0, 0,
                              1, dstRect.width() * dstRect.height(),
                              smudgeRateOpacity);
@@ -120,6 +120,7 @@ protected:
     const KoCompositeOp * m_smearOp {nullptr};
 private:
     KisFixedPaintDeviceSP m_blendDevice;
+    KisFixedPaintDeviceSP m_smearingTempDevice;
     bool m_useDullingMode {true};
 };
 
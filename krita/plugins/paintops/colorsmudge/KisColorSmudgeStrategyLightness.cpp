@@ -66,6 +66,10 @@ void KisColorSmudgeStrategyLightness::initializePainting()
 
     m_heightmapPainter.begin(m_heightmapDevice);
 
+    // the temporary devices are reused by all the dabs of the stroke
+    m_tempColorDevice = new KisFixedPaintDevice(m_colorOnlyDevice->colorSpace(), m_memoryAllocator);
+    m_tempHeightmapDevice = new KisFixedPaintDevice(m_heightmapDevice->colorSpace(), m_memoryAllocator);
+
     // we should read data from the color layer, not from the final projection layer
     m_sourceWrapperDevice = toQShared(new KisColorSmudgeSourcePaintDevice(*m_layerOverlayDevice, 1));
 
@@ -171,27 +175,21 @@ KisColorSmudgeStrategyLightness::paintDab(const QRect &srcRect, const QRect &dst
     m_heightmapPainter.renderMirrorMaskSafe(dstRect, m_origDab, m_shouldPreserveOriginalDab);
 
 
-    KisFixedPaintDeviceSP tempColorDevice =
-        new KisFixedPaintDevice(m_colorOnlyDevice->colorSpace(), m_memoryAllocator);
-
-    KisFixedPaintDeviceSP tempHeightmapDevice =
-        new KisFixedPaintDevice(m_heightmapDevice->colorSpace(), m_memoryAllocator);
-
     Q_FOREACH(const QRect& rc, mirroredRects) {
-        tempColorDevice->setRect(rc);
-        tempColorDevice->lazyGrowBufferWithoutInitialization();
+        m_tempColorDevice->setRect(rc);
+        m_tempColorDevice->lazyGrowBufferWithoutInitialization();
 
-        tempHeightmapDevice->setRect(rc);
-        tempHeightmapDevice->lazyGrowBufferWithoutInitialization();
+        m_tempHeightmapDevice->setRect(rc);
+        m_tempHeightmapDevice->lazyGrowBufferWithoutInitialization();
 
-        m_colorOnlyDevice->readBytes(tempColorDevice->data(), rc);
-        m_heightmapDevice->readBytes(tempHeightmapDevice->data(), rc);
-        tempColorDevice->colorSpace()->
-            modulateLightnessByGrayBrush(tempColorDevice->data(),
-                reinterpret_cast<const QRgb*>(tempHeightmapDevice->data()),
+        m_colorOnlyDevice->readBytes(m_tempColorDevice->data(), rc);
+        m_heightmapDevice->readBytes(m_tempHeightmapDevice->data(), rc);
+        m_tempColorDevice->colorSpace()->
+            modulateLightnessByGrayBrush(m_tempColorDevice->data(),
+                reinterpret_cast<const QRgb*>(m_tempHeightmapDevice->data()),
                 1.0,
                 numPixels);
-        m_projectionDevice->writeBytes(tempColorDevice->data(), tempColorDevice->bounds());
+        m_projectionDevice->writeBytes(m_tempColorDevice->data(), m_tempColorDevice->bounds());
     }
  
     m_layerOverlayDevice->writeRects(mirroredRects);
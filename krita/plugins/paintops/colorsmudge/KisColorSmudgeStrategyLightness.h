@@ -39,6 +39,8 @@ private:
     KisPaintDeviceSP m_heightmapDevice;
     KisPaintDeviceSP m_colorOnlyDevice;
     KisPaintDeviceSP m_projectionDevice;
+    KisFixedPaintDeviceSP m_tempColorDevice;
+    KisFixedPaintDeviceSP m_tempHeightmapDevice;
     KisOverlayPaintDeviceWrapper *m_layerOverlayDevice {nullptr};
     KisColorSmudgeSourceSP m_sourceWrapperDevice;
     KisPainter m_finalPainter;
@@ -33,7 +33,7 @@ KisMyPaintSurface::KisMyPaintSurface(KisPainter *painter, KisPaintDeviceSP paint
     , m_imageDevice(paintNode)
     , m_image(image)
     , m_precisePainterWrapper(painter->device())
-    , m_dab(m_precisePainterWrapper.createPreciseCompositionSourceDevice())
+    , m_dab(new KisFixedPaintDevice(m_precisePainterWrapper.overlayColorSpace()))
     , m_tempPainter(new KisPainter(m_precisePainterWrapper.overlay()))
     , m_backgroundPainter(new KisPainter(m_precisePainterWrapper.createPreciseCompositionSourceDevice()))
 {
@@ -152,8 +152,16 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
 
     KisAlgebra2D::OuterCircle outer(center, radius);
     m_precisePainterWrapper.readRects(m_tempPainter->calculateAllMirroredRects(dabRectAligned));
-    m_tempPainter->copyAreaOptimized(dabRectAligned.topLeft(), m_tempPainter->device(), m_dab, dabRectAligned);
-    KisSequentialIterator it(m_dab, dabRectAligned);
+
+    /**
+     * Fetch the whole dab area in one go into a linear buffer, so that the
+     * pixel loop below doesn't have to go through the tile iterators.
+     */
+    m_dab->setRect(dabRectAligned);
+    m_dab->lazyGrowBufferWithoutInitialization();
+    m_precisePainterWrapper.overlay()->readBytes(m_dab->data(), dabRectAligned);
+
+    const int pixelSize = m_dab->pixelSize();
 
     quint8 maskUnitValue = KoColorSpaceMathsTraits<quint8>::unitValue; // because it's alpha8
 
@@ -166,110 +174,110 @@ int KisMyPaintSurface::drawDabImpl(MyPaintSurface *self, float x, float y, float
     m_maskDevice->setRect(dabRectAligned);
     m_maskDevice->lazyGrowBufferWithoutInitialization();
 
-
-    // Dmitry says that going with the pointer should be in the same order
-    // as using the sequential iterator
+    // the mask and the dab have the same bounds, so we can walk
+    // both of them linearly
     quint8* maskPointer = m_maskDevice->data();
+    quint8* dabPointer = m_dab->data();
 
+    const int xEnd = dabRectAligned.x() + dabRectAligned.width();
+    const int yEnd = dabRectAligned.y() + dabRectAligned.height();
 
-    while(it.nextPixel()) {
+    for (int iy = dabRectAligned.y(); iy < yEnd; iy++) {
+        for (int ix = dabRectAligned.x(); ix < xEnd; ix++, maskPointer++, dabPointer += pixelSize) {
 
-        // first initialize to 0;
-        *maskPointer = 0;
+            // first initialize to 0;
+            *maskPointer = 0;
 
-        QPoint pt(it.x(), it.y());
+            QPoint pt(ix, iy);
 
-        if(outer.fadeSq(pt) > 1.0f) {
-            maskPointer++;
-            continue;
-        }
+            if(outer.fadeSq(pt) > 1.0f) {
+                continue;
+            }
 
-        float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
+            float rr, base_alpha, alpha, dst_alpha, r, g, b, a;
 
-        if (radius < 3.0) {
-            rr = calculate_rr_antialiased (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
-        }
-        else {
-            rr = calculate_rr (it.x(), it.y(), x, y, aspect_ratio, sn, cs, one_over_radius2);
-        }
+            if (radius < 3.0) {
+                rr = calculate_rr_antialiased (ix, iy, x, y, aspect_ratio, sn, cs, one_over_radius2, r_aa_start);
+            }
+            else {
+                rr = calculate_rr (ix, iy, x, y, aspect_ratio, sn, cs, one_over_radius2);
+            }
 
-        base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
+            base_alpha = calculate_alpha_for_rr (rr, hardness, segment1_slope, segment2_slope);
 
-        m_tempPainter->selection();
-        alpha = base_alpha * normal_mode;
+            alpha = base_alpha * normal_mode;
 
-        // set alpha to mask
-        if (alpha > minValue) {
-            *maskPointer = (quint8)(maskUnitValue);
-        }
+            // set alpha to mask
+            if (alpha > minValue) {
+                *maskPointer = (quint8)(maskUnitValue);
+            }
 
-        channelType* nativeArray = reinterpret_cast<channelType*>(it.rawData());
+            channelType* nativeArray = reinterpret_cast<channelType*>(dabPointer);
 
-        b = nativeArray[0]/unitValue;
-        g = nativeArray[1]/unitValue;
-        r = nativeArray[2]/unitValue;
-        dst_alpha = nativeArray[3]/unitValue;
+            b = nativeArray[0]/unitValue;
+            g = nativeArray[1]/unitValue;
+            r = nativeArray[2]/unitValue;
+            dst_alpha = nativeArray[3]/unitValue;
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
-        }
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
 
-        a = alpha * (color_a - dst_alpha) + dst_alpha;
+            a = alpha * (color_a - dst_alpha) + dst_alpha;
 
-        if (eraser) {
-            alpha = 1 - (opaque*base_alpha);
-            a = dst_alpha * alpha ;
-        } else {
-            if (a > 0.0f) {
-                float src_term = (alpha * color_a) / a;
-                float dst_term = 1.0f - src_term;
-                r = color_r * src_term + r * dst_term;
-                g = color_g * src_term + g * dst_term;
-                b = color_b * src_term + b * dst_term;
-            }
+            if (eraser) {
+                alpha = 1 - (opaque*base_alpha);
+                a = dst_alpha * alpha ;
+            } else {
+                if (a > 0.0f) {
+                    float src_term = (alpha * color_a) / a;
+                    float dst_term = 1.0f - src_term;
+                    r = color_r * src_term + r * dst_term;
+                    g = color_g * src_term + g * dst_term;
+                    b = color_b * src_term + b * dst_term;
+                }
 
-            if (colorize > 0.0f && base_alpha > 0.0f) {
+                if (colorize > 0.0f && base_alpha > 0.0f) {
 
-                alpha = base_alpha * colorize;
-                a = alpha + dst_alpha - alpha * dst_alpha;
+                    alpha = base_alpha * colorize;
+                    a = alpha + dst_alpha - alpha * dst_alpha;
 
-                if (a > 0.0f) {
+                    if (a > 0.0f) {
 
-                    float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
-                    float out_r = r, out_g = g, out_b = b;
+                        float pixel_h, pixel_s, pixel_l, out_h, out_s, out_l;
+                        float out_r = r, out_g = g, out_b = b;
 
-                    float src_term = alpha / a;
-                    float dst_term = 1.0f - src_term;
+                        float src_term = alpha / a;
+                        float dst_term = 1.0f - src_term;
 
-                    RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
-                    RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
+                        RGBToHSL(color_r, color_g, color_b, &pixel_h, &pixel_s, &pixel_l);
+                        RGBToHSL(out_r, out_g, out_b, &out_h, &out_s, &out_l);
 
-                    out_h = pixel_h;
-                    out_s = pixel_s;
+                        out_h = pixel_h;
+                        out_s = pixel_s;
 
-                    HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
+                        HSLToRGB(out_h, out_s, out_l, &out_r, &out_g, &out_b);
 
-                    r = (float)out_r * src_term + r * dst_term;
-                    g = (float)out_g * src_term + g * dst_term;
-                    b = (float)out_b * src_term + b * dst_term;
+                        r = (float)out_r * src_term + r * dst_term;
+                        g = (float)out_g * src_term + g * dst_term;
+                        b = (float)out_b * src_term + b * dst_term;
+                    }
                 }
             }
-        }
 
-        if (unitValue == 1.0f) {
-            swap(b, r);
+            if (unitValue == 1.0f) {
+                swap(b, r);
+            }
+            nativeArray[0] = qBound(minValue, b * unitValue, maxValue);
+            nativeArray[1] = qBound(minValue, g * unitValue, maxValue);
+            nativeArray[2] = qBound(minValue, r * unitValue, maxValue);
+            nativeArray[3] = qBound(minValue, a * unitValue, maxValue);
         }
-        nativeArray[0] = qBound(minValue, b * unitValue, maxValue);
-        nativeArray[1] = qBound(minValue, g * unitValue, maxValue);
-        nativeArray[2] = qBound(minValue, r * unitValue, maxValue);
-        nativeArray[3] = qBound(minValue, a * unitValue, maxValue);
-
-        maskPointer++;
     }
 
 
-    m_tempPainter->bitBltWithFixedSelection(dabRectAligned.x(), dabRectAligned.y(), m_dab, m_maskDevice, dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.x(), dabRectAligned.y(), dabRectAligned.width(), dabRectAligned.height());
-    m_tempPainter->renderMirrorMask(dabRectAligned, m_dab, dabRectAligned.x(), dabRectAligned.y(), m_maskDevice);
+    m_tempPainter->bltFixedWithFixedSelection(dabRectAligned.x(), dabRectAligned.y(), m_dab, m_maskDevice, dabRectAligned.width(), dabRectAligned.height());
+    m_tempPainter->renderMirrorMask(dabRectAligned, m_dab, m_maskDevice);
     const QVector<QRect> dirtyRects = m_tempPainter->takeDirtyRegion();
     m_precisePainterWrapper.writeRects(dirtyRects);
     painter()->addDirtyRects(dirtyRects);
@@ -301,20 +309,12 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
 
     m_precisePainterWrapper.readRect(dabRectAligned);
     KisPaintDeviceSP activeDev = m_precisePainterWrapper.overlay();
-    if(m_image) {
-        //m_image->blockUpdates();
-        m_backgroundPainter->device()->clear();
-        m_backgroundPainter->bitBlt(dabRectAligned.topLeft(), activeDev, dabRectAligned);
-        activeDev = m_backgroundPainter->device();
-        //m_image->unblockUpdates();
-    } else if (m_imageDevice) {
+    if (!m_image && m_imageDevice) {
+        // the image device may have a different color space, so convert it
         m_backgroundPainter->bitBlt(dabRectAligned.topLeft(), m_imageDevice, dabRectAligned);
         activeDev = m_backgroundPainter->device();
-    } else {
-        m_precisePainterWrapper.readRect(dabRectAligned);
     }
 
-    KisSequentialIterator it(activeDev, dabRectAligned);
     QVector<float> surface_color_vec = {0,0,0,0};
     float unitValue = KoColorSpaceMathsTraits<channelType>::unitValue;
     float maxValue = KoColorSpaceMathsTraits<channelType>::max;
@@ -323,28 +323,35 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
     m_blendDevice->setRect(dabRectAligned);
     m_blendDevice->lazyGrowBufferWithoutInitialization();
 
-
-    qint16* weights = new qint16[size];
+    if (m_colorWeights.size() < int(size)) {
+        m_colorWeights.resize(size);
+    }
+    qint16* weights = m_colorWeights.data();
     quint32 num_colors = 0;
 
     activeDev->readBytes(m_blendDevice->data(), dabRectAligned);
 
-    while(it.nextPixel()) {
+    const int xEnd = dabRectAligned.x() + dabRectAligned.width();
+    const int yEnd = dabRectAligned.y() + dabRectAligned.height();
 
-        QPointF pt(it.x(), it.y());
+    for (int iy = dabRectAligned.y(); iy < yEnd; iy++) {
+        for (int ix = dabRectAligned.x(); ix < xEnd; ix++) {
 
-        float rr = 0.0;
-        if(outer.fadeSq(pt) <= 1.0) {
-            /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
-            float yy = (it.y() + 0.5f - y);
-            float xx = (it.x() + 0.5f - x);
+            QPointF pt(ix, iy);
 
-            rr = qMax((yy * yy + xx * xx) * one_over_radius2, 0.0f);
-        }
+            float rr = 0.0;
+            if(outer.fadeSq(pt) <= 1.0) {
+                /* pixel_weight == a standard dab with hardness = 0.5, aspect_ratio = 1.0, and angle = 0.0 */
+                float yy = (iy + 0.5f - y);
+                float xx = (ix + 0.5f - x);
 
-        weights[num_colors] = qRound((1.0f - rr) * 255);
-        sum_weight += weights[num_colors];
-        num_colors += 1;
+                rr = qMax((yy * yy + xx * xx) * one_over_radius2, 0.0f);
+            }
+
+            weights[num_colors] = qRound((1.0f - rr) * 255);
+            sum_weight += weights[num_colors];
+            num_colors += 1;
+        }
     }
 
     KoColor color(Qt::transparent, activeDev->colorSpace());
@@ -370,8 +377,6 @@ void KisMyPaintSurface::getColorImpl(MyPaintSurface *self, float x, float y, flo
             *color_a = CLAMP(a, 0.0f, 1.0f);
         }
     }
-
-    delete [] weights;
 }
 
 KisPainter* KisMyPaintSurface::painter() {
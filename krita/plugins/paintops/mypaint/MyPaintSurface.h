@@ -82,11 +82,12 @@ private:
     MyPaintSurfaceInternal *m_surface;
     KisImageSP m_image;
     KisOverlayPaintDeviceWrapper m_precisePainterWrapper;
-    KisPaintDeviceSP m_dab;
+    KisFixedPaintDeviceSP m_dab;
     QScopedPointer<KisPainter> m_tempPainter;
     QScopedPointer<KisPainter> m_backgroundPainter;
     KisFixedPaintDeviceSP m_blendDevice;
     KisFixedPaintDeviceSP m_maskDevice;
+    QVector<qint16> m_colorWeights;
 
 };
 
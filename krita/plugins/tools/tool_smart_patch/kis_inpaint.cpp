@@ -31,6 +31,9 @@
 
 #include <QtMath>
 #include <QList>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
 #include <kis_transform_worker.h>
 #include <kis_filter_strategy.h>
 #include "KoColor.h"
@@ -511,35 +514,92 @@ struct Vote_elem {
 };
 typedef boost::multi_array<Vote_elem, 2> Vote_type;
 
+/**
+ * A horizontal band of rows of the nearest neighbor field. The bands are
+ * processed in parallel, each of them with its own random generator.
+ */
+struct NNFBand {
+    int top;
+    int bottom;
+    quint32 seed;
+};
+
+/**
+ * Split the range [0, size) into chunks that can be processed in parallel
+ */
+QVector<QPair<int, int>> splitIntoChunks(int size, int minChunkSize)
+{
+    QVector<QPair<int, int>> chunks;
+
+    const int numChunks = qBound(1, size / minChunkSize, 4 * QThread::idealThreadCount());
+    const int chunkSize = (size + numChunks - 1) / numChunks;
+
+    for (int start = 0; start < size; start += chunkSize) {
+        chunks << qMakePair(start, qMin(start + chunkSize, size));
+    }
+
+    return chunks;
+}
+
 
 
 class NearestNeighborField : public KisShared
 {
 
 private:
-    template< typename T> T randomInt(T range)
+    template <typename Rng> int randomInt(Rng &rng, int range)
     {
-        return rand() % range;
+        return rng() % range;
+    }
+
+    /**
+     * Split the rows of the field into bands that are processed in parallel.
+     * There are two bands per thread, so that every other band could be
+     * processed while its neighbours are idle (see minimize()).
+     */
+    QVector<NNFBand> splitIntoBands()
+    {
+        QVector<NNFBand> bands;
+
+        const int height = imSize.height();
+        if (height <= 0) return bands;
+
+        const int minBandHeight = 16;
+        const int numThreads = QThreadPool::globalInstance()->maxThreadCount();
+        const int numBands = qBound(1, height / minBandHeight, 2 * numThreads);
+        const int bandHeight = (height + numBands - 1) / numBands;
+
+        for (int top = 0; top < height; top += bandHeight) {
+            bands << NNFBand{top, qMin(top + bandHeight, height) - 1, quint32(m_rng())};
+        }
+
+        return bands;
     }
 
     //compute initial value of the distance term
     void initialize(void)
     {
-        for (int y = 0; y < imSize.height(); y++) {
-            for (int x = 0; x < imSize.width(); x++) {
-                field[x][y].distance = distance(x, y, field[x][y].x, field[x][y].y);
-
-                //if the distance is "infinity", try to find a better link
-                int iter = 0;
-                const int maxretry = 20;
-                while (field[x][y].distance == MAX_DIST && iter < maxretry) {
-                    field[x][y].x = randomInt(imSize.width() + 1);
-                    field[x][y].y = randomInt(imSize.height() + 1);
+        QVector<NNFBand> bands = splitIntoBands();
+
+        QtConcurrent::blockingMap(bands, [this] (const NNFBand &band) {
+            std::minstd_rand rng(band.seed);
+
+            for (int y = band.top; y <= band.bottom; y++) {
+                for (int x = 0; x < imSize.width(); x++) {
                     field[x][y].distance = distance(x, y, field[x][y].x, field[x][y].y);
-                    iter++;
+
+                    //if the distance is "infinity", try to find a better link
+                    int iter = 0;
+                    const int maxretry = 20;
+                    while (field[x][y].distance == MAX_DIST && iter < maxretry) {
+                        field[x][y].x = randomInt(rng, imSize.width() + 1);
+                        field[x][y].y = randomInt(rng, imSize.height() + 1);
+                        field[x][y].distance = distance(x, y, field[x][y].x, field[x][y].y);
+                        iter++;
+                    }
                 }
             }
-        }
+        });
     }
 
     void init_similarity_curve(void)
@@ -561,6 +621,7 @@ private:
 
 private:
     int patchSize; //patch size
+    std::minstd_rand m_rng;
 public:
     MaskedImageSP input;
     MaskedImageSP output;
@@ -584,8 +645,8 @@ public:
     {
         for (int y = 0; y < imSize.height(); y++) {
             for (int x = 0; x < imSize.width(); x++) {
-                field[x][y].x = randomInt(imSize.width() + 1);
-                field[x][y].y = randomInt(imSize.height() + 1);
+                field[x][y].x = randomInt(m_rng, imSize.width() + 1);
+                field[x][y].y = randomInt(m_rng, imSize.height() + 1);
                 field[x][y].distance = MAX_DIST;
             }
         }
@@ -612,29 +673,48 @@ public:
     }
 
     //multi-pass NN-field minimization (see "PatchMatch" paper referenced above - page 4)
+    //
+    //The field is split into horizontal bands that are minimized in parallel. Every pass
+    //has two phases: the even bands are minimized first, then the odd ones. The neighbours
+    //of a band are idle while it is being minimized, so the links are propagated across
+    //the borders of the bands in every pass, like in a single-threaded scan.
     void minimize(int pass)
     {
-        int min_x = 0;
-        int min_y = 0;
-        int max_x = imSize.width() - 1;
-        int max_y = imSize.height() - 1;
+        const int min_x = 0;
+        const int max_x = imSize.width() - 1;
+
+        const QVector<NNFBand> bands = splitIntoBands();
+        if (bands.isEmpty()) return;
 
         for (int i = 0; i < pass; i++) {
-            //scanline order
-            for (int y = min_y; y < max_y; y++)
-                for (int x = min_x; x <= max_x; x++)
-                    if (field[x][y].distance > 0)
-                        minimizeLink(x, y, 1);
-
-            //reverse scanline order
-            for (int y = max_y; y >= min_y; y--)
-                for (int x = max_x; x >= min_x; x--)
-                    if (field[x][y].distance > 0)
-                        minimizeLink(x, y, -1);
+            for (int phase = 0; phase < 2; phase++) {
+                QVector<NNFBand> phaseBands;
+                for (int j = phase; j < bands.size(); j += 2) {
+                    phaseBands << bands[j];
+                    phaseBands.last().seed = quint32(m_rng());
+                }
+
+                QtConcurrent::blockingMap(phaseBands, [&] (const NNFBand &band) {
+                    std::minstd_rand rng(band.seed);
+
+                    //scanline order
+                    for (int y = band.top; y <= band.bottom; y++)
+                        for (int x = min_x; x <= max_x; x++)
+                            if (field[x][y].distance > 0)
+                                minimizeLink(x, y, 1, rng);
+
+                    //reverse scanline order
+                    for (int y = band.bottom; y >= band.top; y--)
+                        for (int x = max_x; x >= min_x; x--)
+                            if (field[x][y].distance > 0)
+                                minimizeLink(x, y, -1, rng);
+                });
+            }
         }
     }
 
-    void minimizeLink(int x, int y, int dir)
+    template <typename Rng>
+    void minimizeLink(int x, int y, int dir, Rng &rng)
     {
         int xp, yp, dp;
 
@@ -667,8 +747,8 @@ public:
         int xpi = field[x][y].x;
         int ypi = field[x][y].y;
         while (wi > 0) {
-            xp = xpi + randomInt(2 * wi) - wi;
-            yp = ypi + randomInt(2 * wi) - wi;
+            xp = xpi + randomInt(rng, 2 * wi) - wi;
+            yp = ypi + randomInt(rng, 2 * wi) - wi;
             xp = std::max(0, std::min(output->size().width() - 1, xp));
             yp = std::max(0, std::min(output->size().height() - 1, yp));
 
@@ -689,6 +769,11 @@ public:
         qint64 wsum = 0;
         const qint64 ssdmax = nColors * 255 * 255;
 
+        const int inputWidth = input->size().width();
+        const int inputHeight = input->size().height();
+        const int outputWidth = output->size().width();
+        const int outputHeight = output->size().height();
+
         //for each pixel in the source patch
         for (int dy = -patchSize; dy <= patchSize; dy++) {
             for (int dx = -patchSize; dx <= patchSize; dx++) {
@@ -696,12 +781,12 @@ public:
                 int xks = x + dx;
                 int yks = y + dy;
 
-                if (xks < 0 || xks >= input->size().width()) {
+                if (xks < 0 || xks >= inputWidth) {
                     distance += ssdmax;
                     continue;
                 }
 
-                if (yks < 0 || yks >= input->size().height()) {
+                if (yks < 0 || yks >= inputHeight) {
                     distance += ssdmax;
                     continue;
                 }
@@ -715,11 +800,11 @@ public:
                 //corresponding pixel in target patch
                 int xkt = xp + dx;
                 int ykt = yp + dy;
-                if (xkt < 0 || xkt >= output->size().width()) {
+                if (xkt < 0 || xkt >= outputWidth) {
                     distance += ssdmax;
                     continue;
                 }
-                if (ykt < 0 || ykt >= output->size().height()) {
+                if (ykt < 0 || ykt >= outputHeight) {
                     distance += ssdmax;
                     continue;
                 }
@@ -842,15 +927,22 @@ MaskedImageSP NearestNeighborField::ExpectationMaximization(NearestNeighborField
             newtarget = nullptr;
         }
 
-        for (int x = 0; x < target->size().width(); ++x) {
-            for (int y = 0; y < target->size().height(); ++y) {
-                if (!source->containsMasked(x, y, radius)) {
-                    nnf_TargetToSource->field[x][y].x = x;
-                    nnf_TargetToSource->field[x][y].y = y;
-                    nnf_TargetToSource->field[x][y].distance = 0;
+        const int targetWidth = target->size().width();
+        const int targetHeight = target->size().height();
+
+        QVector<QPair<int, int>> chunks = splitIntoChunks(targetWidth, 16);
+
+        QtConcurrent::blockingMap(chunks, [&] (const QPair<int, int> &columns) {
+            for (int x = columns.first; x < columns.second; ++x) {
+                for (int y = 0; y < targetHeight; ++y) {
+                    if (!source->containsMasked(x, y, radius)) {
+                        nnf_TargetToSource->field[x][y].x = x;
+                        nnf_TargetToSource->field[x][y].y = y;
+                        nnf_TargetToSource->field[x][y].distance = 0;
+                    }
                 }
             }
-        }
+        });
 
         //minimize the NNF
         nnf_TargetToSource->minimize(iterNNF);
@@ -896,74 +988,79 @@ void NearestNeighborField::ExpectationStep(NearestNeighborFieldSP nnf, MaskedIma
     int H_source = source->size().height();
     int W_source = source->size().width();
 
-    std::vector< quint8* > pixels;
-    std::vector< float > weights;
-    pixels.reserve(R * R);
-    weights.reserve(R * R);
-    for (int x = 0 ; x < W_target ; ++x) {
-        for (int y = 0 ; y < H_target; ++y) {
-            float wsum = 0;
-            pixels.clear();
-            weights.clear();
-
-
-            if (!source->containsMasked(x, y, R + 4) /*&& upscale*/) {
-                //speedup computation by copying parts that are not masked.
-                pixels.push_back(source->getImagePixel(x, y));
-                weights.push_back(1.f);
-                target->mixColors(pixels, weights, 1.f, target->getImagePixel(x, y));
-            } else {
-                for (int dx = -R ; dx <= R; ++dx) {
-                    for (int dy = -R ; dy <= R ; ++dy) {
-                        // xpt,ypt = center pixel of the target patch
-                        int xpt = x + dx;
-                        int ypt = y + dy;
-
-                        int xst, yst;
-                        float w;
-
-                        if (!upscale) {
-                            if (xpt < 0 || xpt >= W_nnf || ypt < 0 || ypt >= H_nnf)
+    // every target pixel is written only once, so the columns can be processed in parallel
+    QVector<QPair<int, int>> chunks = splitIntoChunks(W_target, 16);
+
+    QtConcurrent::blockingMap(chunks, [&] (const QPair<int, int> &columns) {
+        std::vector< quint8* > pixels;
+        std::vector< float > weights;
+        pixels.reserve(R * R);
+        weights.reserve(R * R);
+        for (int x = columns.first ; x < columns.second ; ++x) {
+            for (int y = 0 ; y < H_target; ++y) {
+                float wsum = 0;
+                pixels.clear();
+                weights.clear();
+
+
+                if (!source->containsMasked(x, y, R + 4) /*&& upscale*/) {
+                    //speedup computation by copying parts that are not masked.
+                    pixels.push_back(source->getImagePixel(x, y));
+                    weights.push_back(1.f);
+                    target->mixColors(pixels, weights, 1.f, target->getImagePixel(x, y));
+                } else {
+                    for (int dx = -R ; dx <= R; ++dx) {
+                        for (int dy = -R ; dy <= R ; ++dy) {
+                            // xpt,ypt = center pixel of the target patch
+                            int xpt = x + dx;
+                            int ypt = y + dy;
+
+                            int xst, yst;
+                            float w;
+
+                            if (!upscale) {
+                                if (xpt < 0 || xpt >= W_nnf || ypt < 0 || ypt >= H_nnf)
+                                    continue;
+
+                                xst = nnf->field[xpt][ypt].x;
+                                yst = nnf->field[xpt][ypt].y;
+                                int dp = nnf->field[xpt][ypt].distance;
+                                // similarity measure between the two patches
+                                w = nnf->similarity[dp];
+
+                            } else {
+                                if (xpt < 0 || (xpt / 2) >= W_nnf || ypt < 0 || (ypt / 2) >= H_nnf)
+                                    continue;
+                                xst = 2 * nnf->field[xpt / 2][ypt / 2].x + (xpt % 2);
+                                yst = 2 * nnf->field[xpt / 2][ypt / 2].y + (ypt % 2);
+                                int dp = nnf->field[xpt / 2][ypt / 2].distance;
+                                // similarity measure between the two patches
+                                w = nnf->similarity[dp];
+                            }
+
+                            int xs = xst - dx;
+                            int ys = yst - dy;
+
+                            if (xs < 0 || xs >= W_source || ys < 0 || ys >= H_source)
                                 continue;
 
-                            xst = nnf->field[xpt][ypt].x;
-                            yst = nnf->field[xpt][ypt].y;
-                            int dp = nnf->field[xpt][ypt].distance;
-                            // similarity measure between the two patches
-                            w = nnf->similarity[dp];
-
-                        } else {
-                            if (xpt < 0 || (xpt / 2) >= W_nnf || ypt < 0 || (ypt / 2) >= H_nnf)
+                            if (source->isMasked(xs, ys))
                                 continue;
-                            xst = 2 * nnf->field[xpt / 2][ypt / 2].x + (xpt % 2);
-                            yst = 2 * nnf->field[xpt / 2][ypt / 2].y + (ypt % 2);
-                            int dp = nnf->field[xpt / 2][ypt / 2].distance;
-                            // similarity measure between the two patches
-                            w = nnf->similarity[dp];
-                        }
-
-                        int xs = xst - dx;
-                        int ys = yst - dy;
-
-                        if (xs < 0 || xs >= W_source || ys < 0 || ys >= H_source)
-                            continue;
 
-                        if (source->isMasked(xs, ys))
-                            continue;
-
-                        pixels.push_back(source->getImagePixel(xs, ys));
-                        weights.push_back(w);
-                        wsum += w;
+                            pixels.push_back(source->getImagePixel(xs, ys));
+                            weights.push_back(w);
+                            wsum += w;
+                        }
                     }
-                }
 
-                if (wsum < 1)
-                    continue;
+                    if (wsum < 1)
+                        continue;
 
-                target->mixColors(pixels, weights, wsum, target->getImagePixel(x, y));
+                    target->mixColors(pixels, weights, wsum, target->getImagePixel(x, y));
+                }
             }
         }
-    }
+    });
 }
 
 QRect getMaskBoundingBox(KisPaintDeviceSP maskDev)
@@ -0,0 +1,154 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kis_inpaint_test.h"
+
+#include <simpletest.h>
+
+#include <QThreadPool>
+
+#include <KoColor.h>
+#include <KoColorSpaceRegistry.h>
+
+#include "kis_paint_device.h"
+#include "kis_painter.h"
+#include "kis_selection.h"
+
+QRect patchImage(KisPaintDeviceSP imageDev, KisPaintDeviceSP maskDev, int radius, int accuracy, KisSelectionSP selection);
+
+namespace {
+
+const QRect imageRect(0, 0, 256, 256);
+const QRect holeRect(100, 90, 48, 40);
+
+/**
+ * A periodic texture the hole can be restored from
+ */
+KisPaintDeviceSP createImage()
+{
+    QImage image(imageRect.size(), QImage::Format_ARGB32);
+
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            const int r = (x + y) % 12 < 6 ? 220 : 40;
+            const int g = x % 20 < 10 ? 180 : 60;
+            const int b = 128 + (y % 16) * 6;
+            image.setPixel(x, y, qRgb(r, g, b));
+        }
+    }
+
+    KisPaintDeviceSP dev = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    dev->convertFromQImage(image, 0);
+    return dev;
+}
+
+/**
+ * The mask is built the same way KisToolSmartPatch does it
+ */
+KisPaintDeviceSP createMask()
+{
+    KisPaintDeviceSP mask = new KisPaintDevice(KoColorSpaceRegistry::instance()->rgb8());
+    mask->fill(holeRect, KoColor(Qt::magenta, mask->colorSpace()));
+    return KisPainter::convertToAlphaAsAlpha(mask);
+}
+
+/**
+ * Limits the global thread pool for the lifetime of the object
+ */
+struct ThreadCountLimiter
+{
+    explicit ThreadCountLimiter(int numThreads)
+        : m_oldMaxThreadCount(QThreadPool::globalInstance()->maxThreadCount())
+    {
+        QThreadPool::globalInstance()->setMaxThreadCount(numThreads);
+    }
+
+    ~ThreadCountLimiter()
+    {
+        QThreadPool::globalInstance()->setMaxThreadCount(m_oldMaxThreadCount);
+    }
+
+private:
+    const int m_oldMaxThreadCount;
+};
+
+/**
+ * Runs the inpainting with the given number of threads. The nearest
+ * neighbor field is split into two bands per thread, so a single thread
+ * gives the serial result.
+ */
+KisPaintDeviceSP patchWithThreads(int numThreads)
+{
+    ThreadCountLimiter limiter(numThreads);
+
+    KisPaintDeviceSP image = createImage();
+    KisPaintDeviceSP mask = createMask();
+
+    // remove the hole, so that nothing could be copied from the original
+    image->fill(holeRect, KoColor(Qt::black, image->colorSpace()));
+    patchImage(image, mask, 4, 50, nullptr);
+
+    return image;
+}
+
+/**
+ * Mean absolute difference of the color channels inside the hole
+ */
+qreal holeError(KisPaintDeviceSP dev, KisPaintDeviceSP reference)
+{
+    const QImage image = dev->convertToQImage(0, holeRect);
+    const QImage referenceImage = reference->convertToQImage(0, holeRect);
+
+    qint64 error = 0;
+
+    for (int y = 0; y < image.height(); y++) {
+        for (int x = 0; x < image.width(); x++) {
+            const QRgb pixel = image.pixel(x, y);
+            const QRgb referencePixel = referenceImage.pixel(x, y);
+
+            error += qAbs(qRed(pixel) - qRed(referencePixel)) +
+                qAbs(qGreen(pixel) - qGreen(referencePixel)) +
+                qAbs(qBlue(pixel) - qBlue(referencePixel));
+        }
+    }
+
+    return qreal(error) / (3 * image.width() * image.height());
+}
+
+}
+
+void KisInpaintTest::testParallelQuality()
+{
+    KisPaintDeviceSP reference = createImage();
+
+    const qreal serialError = holeError(patchWithThreads(1), reference);
+    const qreal parallelError = holeError(patchWithThreads(8), reference);
+
+    // the hole is black now, the error of an unpatched image is over 100
+    QVERIFY(serialError < 40);
+
+    // the bands of the parallel field should not leave any seams
+    QVERIFY(parallelError <= serialError * 1.25 + 2.0);
+}
+
+void KisInpaintTest::benchmarkPatch_data()
+{
+    QTest::addColumn<int>("numThreads");
+
+    QTest::addRow("serial") << 1;
+    QTest::addRow("parallel") << QThread::idealThreadCount();
+}
+
+void KisInpaintTest::benchmarkPatch()
+{
+    QFETCH(int, numThreads);
+
+    QBENCHMARK {
+        patchWithThreads(numThreads);
+    }
+}
+
+SIMPLE_TEST_MAIN(KisInpaintTest)
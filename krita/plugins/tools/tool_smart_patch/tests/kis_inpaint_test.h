@@ -0,0 +1,22 @@
+/*
+ *  SPDX-FileCopyrightText: 2026 Krita developers
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __KIS_INPAINT_TEST_H
+#define __KIS_INPAINT_TEST_H
+
+#include <QtTest/QtTest>
+
+class KisInpaintTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testParallelQuality();
+
+    void benchmarkPatch_data();
+    void benchmarkPatch();
+};
+
+#endif /* __KIS_INPAINT_TEST_H */